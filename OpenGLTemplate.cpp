@@ -1,4 +1,4 @@
-#define STB_IMAGE_IMPLEMENTATION
+#include <chrono>
 #include <cstdlib>
 #include <glad/glad.h>
 #include <GLFW/glfw3.h>
@@ -8,17 +8,36 @@
 #include <iostream>
 #include <string>
 #include <vector>
-#include "shaderinit.h"
+// the stb_image implementation lives in this file; assetloader.h includes
+// the header again for its declarations only
+#define STB_IMAGE_IMPLEMENTATION
 #include "stb_image.h"
+#undef STB_IMAGE_IMPLEMENTATION
+#include "assetloader.h"
+#include "bcencoder.h"
+#include "benchmarks.h"
+#include "cookedtexture.h"
+#include "shaderinit.h"
+#include "indirectdraw.h"
+#include "instancedrenderer.h"
+#include "fixedtimestep.h"
+#include "framedata.h"
+#include "frustumculling.h"
+#include "glstate.h"
+#include "headless.h"
+#include "profiler.h"
+#include "renderqueue.h"
+#include "texturearray.h"
 
 void framebuffer_size_callback(GLFWwindow* window, int width, int height);
 void processInput(GLFWwindow* window);
 void init(void);
 void render();
-void texture1Rendering(const char* path);
-void texture2Rendering(const char* path);
-unsigned int loadCubemap(std::vector<std::string> faces);
-void tranformations(Shader& ourShader);
+void simulate(float dt);
+unsigned int createCubemap();
+void uploadCubemapFace(unsigned int cubemap, unsigned int face, const DecodedImage& image);
+void tranformations();
+void updateCubeInstances();
 void mouse_callback(GLFWwindow* window, double xposIn, double yposIn);
 void key_callback(GLFWwindow* window, int key, int scancode, int action, int mods);
 
@@ -30,9 +49,22 @@ GLuint VBO;
 GLuint VAO;
 GLuint EBO;
 unsigned int skyboxVAO, skyboxVBO;
-
-unsigned int texture1, texture2, appliedTexture{};
-int width, height, nrChannels;
+SubMesh planeMesh;
+SubMesh cubeMesh;
+InstancedRenderer cubeRenderer;
+IndirectDrawBuilder opaqueDraws;
+SphereBounds cubeBounds;
+std::vector<std::uint32_t> visibleCubes;
+float cubeRadius = 0.0f;
+FrameDataBuffer frameDataBuffer;
+RenderQueue renderQueue;
+const unsigned int numCubes = 4;
+
+// every cube image in one array texture; cubes pick theirs by region,
+// in the order of materialImages in main
+TextureArrayBuilder materialTextures;
+std::vector<std::uint32_t> materialRegions;
+unsigned int appliedTexture{};
 
 // camera 
 glm::vec3 cameraPos = glm::vec3(0.0f, 0.0f, 3.0f);
@@ -40,10 +72,31 @@ glm::vec3 cameraFront = glm::vec3(0.0f, 0.0f, -1.0f);
 glm::vec3 cameraUp = glm::vec3(0.0f, 1.0f, 0.0f);
 glm::mat4 cameraView = glm::mat4(1.0f);
 glm::mat4 projection = glm::mat4(1.0f);
+const float nearPlane = 0.1f;
+const float farPlane = 100.0f;
 
 // timing
 float deltaTime = 0.0f;
 float lastFrame = 0.0f;
+// seconds since startup; glfwGetTime is not available to headless EGL runs
+const std::chrono::steady_clock::time_point startTime = std::chrono::steady_clock::now();
+double secondsSinceStart()
+{
+	return std::chrono::duration<double>(std::chrono::steady_clock::now() - startTime).count();
+}
+
+// simulation runs at a fixed tick rate; rendering interpolates between the
+// last two ticks and writes the result to cameraPos and rotationAngle
+struct SimulationState
+{
+	glm::vec3 cameraPos;
+	float rotationAngle;
+};
+SimulationState previousState;
+SimulationState currentState;
+// tick rate and time scale come from the command line, see main
+FixedTimestep simulationClock;
+glm::vec3 cameraVelocity = glm::vec3(0.0f);
 
 float lastX = screen_width / 2.0f;
 float lastY = screen_height / 2.0f;
@@ -57,6 +110,13 @@ glm::vec3 blendColor(1.0f, 0.0f, 0.0f);
 
 int selectedSquare = -1;
 
+// material indices of the opaque pass, must match shader.vs
+enum SceneMaterial
+{
+	MATERIAL_PLANE = 0,
+	MATERIAL_CUBE = 1,
+};
+
 bool rotateRandomCube = false;
 int rotatingCubeIndex = -1;
 float rotationAngle = 0.0f;
@@ -64,42 +124,85 @@ float rotationAngle = 0.0f;
 float scale = 1.0f;
 bool moveToCenter = false;
 bool resetTransformations = false;
-glm::vec3 originalPositions[4];
+glm::vec3 originalPositions[numCubes];
+glm::vec3 cubeMirror[numCubes];
 glm::vec3 centerPosition = glm::vec3(0.0f, 0.0f, 0.0f);
-glm::mat4 model = glm::mat4(1.0f);
 
 
-int main()
+int main(int argc, char** argv)
 {
-	// glfw: initialize and configure
-	glfwInit();
-	glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 4);
-	glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, 4);
-	glfwWindowHint(GLFW_OPENGL_PROFILE, GLFW_OPENGL_CORE_PROFILE);
+	HeadlessOptions headless = parseHeadlessOptions(argc, argv);
+	if (!headless.compressionReport.empty())
+	{
+		JobPool reportJobs(headless.decodeWorkers);
+		return compressionReport(headless.compressionReport, reportJobs, std::cout) ? 0 : -1;
+	}
+	if (headless.cullBenchmark > 0)
+		return cullBenchmark(headless.cullBenchmark, std::cout) ? 0 : -1;
+	if (headless.queueBenchmark > 0)
+		return queueBenchmark(headless.queueBenchmark, std::cout) ? 0 : -1;
+	if (!headless.decodeBenchmark.empty())
+		return decodeBenchmark(headless.decodeBenchmark, std::cout) ? 0 : -1;
+	if (headless.cook)
+	{
+		JobPool cookJobs(headless.decodeWorkers);
+		return cookDirectory("assets", parseCompression(headless.compression), parseMipFilter(headless.mipFilter), cookJobs, std::cout) == 0 ? 0 : -1;
+	}
+
+	srand(static_cast<unsigned int>(time(0)));
+	simulationClock.setTickRate(headless.tickRate);
+	simulationClock.timeScale = headless.timeScale;
+
+	// headless EGL runs never touch GLFW: glfwInit needs a display server
+	HeadlessContext headlessContext;
+	GLFWwindow* window = NULL;
+	bool useGLFW = !headless.enabled || headless.context == "glfw";
+	if (useGLFW)
+	{
+		// glfw: initialize and configure
+		if (!glfwInit())
+		{
+			std::cout << "Failed to initialize GLFW" << std::endl;
+			if (headless.enabled)
+				std::cout << "Headless runs without a display need --context egl" << std::endl;
+			return -1;
+		}
+		glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 4);
+		glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, 4);
+		glfwWindowHint(GLFW_OPENGL_PROFILE, GLFW_OPENGL_CORE_PROFILE);
+		if (headless.enabled)
+			glfwWindowHint(GLFW_VISIBLE, GLFW_FALSE);
 
 #ifdef _APPLE_
-	glfwWindowHint(GLFW_OPENGL_FORWARD_COMPAT, GL_TRUE);
+		glfwWindowHint(GLFW_OPENGL_FORWARD_COMPAT, GL_TRUE);
 #endif
 
-	srand(static_cast<unsigned int>(time(0)));
-	// glfw window creation
-	// --------------------
-	GLFWwindow* window;
-	window = glfwCreateWindow(screen_width, screen_height, "OpenGLCameraAuto", NULL, NULL);
-	if (window == NULL)
+		// glfw window creation
+		// --------------------
+		window = glfwCreateWindow(screen_width, screen_height, "OpenGLCameraAuto", NULL, NULL);
+		if (window == NULL)
+		{
+			std::cout << "Failed to create GLFW window" << std::endl;
+			glfwTerminate();
+			return -1;
+		}
+		glfwMakeContextCurrent(window);
+		if (!headless.enabled)
+		{
+			glfwSetFramebufferSizeCallback(window, framebuffer_size_callback);
+			glfwSetCursorPosCallback(window, mouse_callback);
+			glfwSetKeyCallback(window, key_callback);
+			glfwSetInputMode(window, GLFW_CURSOR, GLFW_CURSOR_DISABLED);
+		}
+	}
+	else if (headless.context != "egl" || !headlessContext.init(4, 4))
 	{
-		std::cout << "Failed to create GLFW window" << std::endl;
-		glfwTerminate();
+		if (headless.context != "egl")
+			std::cout << "Unknown headless context: " << headless.context << " (expected egl or glfw)" << std::endl;
 		return -1;
 	}
-	glfwMakeContextCurrent(window);
-	glfwSetFramebufferSizeCallback(window, framebuffer_size_callback);
-	glfwSetCursorPosCallback(window, mouse_callback);
-	glfwSetKeyCallback(window, key_callback);
-	glfwSetInputMode(window, GLFW_CURSOR, GLFW_CURSOR_DISABLED);
-
 
-	if (!gladLoadGLLoader((GLADloadproc)glfwGetProcAddress))
+	if (!gladLoadGLLoader(useGLFW ? (GLADloadproc)glfwGetProcAddress : (GLADloadproc)HeadlessContext::procAddress))
 	{
 		std::cout << "Failed to initialize GLAD" << std::endl;
 		return -1;
@@ -110,9 +213,35 @@ int main()
 	Shader skyboxShader("skyboxshader.vs", "skyboxshader.fs");
 	//glPolygonMode(GL_FRONT_AND_BACK, GL_LINE);
 
-	init();
-	texture1Rendering("assets/box.png");
-	texture2Rendering("assets/smilie.png");
+	// load every image on worker threads and upload each one as soon as
+	// it is ready; scene setup below overlaps with the loads, and the
+	// render loop starts without waiting for any of them. The cube images
+	// go into one array texture (see TextureArrayBuilder), read from their
+	// cooked files where there are some (see --cook). Its layers are drawn
+	// from previews until the workers have prepared them and they are
+	// streamed in through the PBO ring; skybox faces are uploaded from the
+	// render loop as they finish decoding.
+	JobPool decodeJobs(headless.decodeWorkers);
+	AssetLoader assetLoader(decodeJobs);
+	TextureStreamer textureStreamer;
+	textureStreamer.init();
+	// sizes vary so the array packs several images to a layer; peace1.png
+	// is larger than a layer and is scaled down. Peace.jpg is progressive,
+	// so it has a preview even when it is not cooked.
+	std::vector<std::string> materialImages
+	{
+		"assets/box.png",
+		"assets/smilie.png",
+		"assets/Peace.jpg",
+		"assets/smile.jpg",
+		"assets/peace1.png"
+	};
+	{
+		PROFILE_SCOPE("material previews");
+		for (const std::string& path : materialImages)
+			materialRegions.push_back(static_cast<std::uint32_t>(materialTextures.add(path)));
+		materialTextures.build(parseCompression(headless.compression), decodeJobs, &textureStreamer);
+	}
 	std::vector<std::string> faces
 	{
 		"assets/skybox/right.jpg",
@@ -122,124 +251,347 @@ int main()
 		"assets/skybox/front.jpg",
 		"assets/skybox/back.jpg"
 	};
-	unsigned int cubemapTexture = loadCubemap(faces);
+	CookedTexture cookedSkybox;
+	bool skyboxCooked = cookedSkybox.open(cookedPath("assets/skybox")) && cookedSkybox.target() == GL_TEXTURE_CUBE_MAP;
+	unsigned int firstFace = 0;
+	if (!skyboxCooked)
+	{
+		firstFace = assetLoader.request(faces[0], false);
+		for (unsigned int i = 1; i < faces.size(); i++)
+			assetLoader.request(faces[i], false);
+	}
+
+	init();
+	unsigned int cubemapTexture = createCubemap();
+	{
+		PROFILE_SCOPE("texture uploads");
+		if (skyboxCooked)
+		{
+			uploadCookedTexture(cubemapTexture, cookedSkybox);
+			cookedSkybox.close();
+		}
+		// headless runs take everything up front so their frames repeat
+		DecodedImage image;
+		while (headless.enabled && assetLoader.next(image))
+		{
+			uploadCubemapFace(cubemapTexture, image.id - firstFace, image);
+			image.release();
+		}
+		if (headless.enabled)
+			materialTextures.finish(textureStreamer);
+	}
+
+	tranformations();
+	frameDataBuffer.init();
 
-	tranformations(ourShader);
+	opaqueDraws.init();
+
+	ourShader.use();
+	ourShader.setInt("materialTextures", 0);
 
 	glEnable(GL_DEPTH_TEST);
 
 	skyboxShader.use();
 	skyboxShader.setInt("skybox", 0);
 
+	// uniforms set every frame, resolved once
+	Uniform<glm::vec3> planeColorUniform = ourShader.uniform<glm::vec3>("planeColor");
+	Uniform<float> blendFactorUniform = ourShader.uniform<float>("blendFactor");
+	if (headless.uniformBenchmark)
+	{
+		ourShader.use();
+		uniformBenchmark(ourShader, "planeColor", 100000, std::cout);
+	}
+
+	// materials; the plane and the cubes share one program and one batch
+	Material sceneMaterial;
+	sceneMaterial.shader = &ourShader;
+	sceneMaterial.textureTarget = GL_TEXTURE_2D_ARRAY;
+	sceneMaterial.textures[0] = materialTextures.texture;
+	sceneMaterial.apply = [&]()
+	{
+		ourShader.set(planeColorUniform, glm::vec3(1.0f, 0.3f, 0.6f));
+		ourShader.set(blendFactorUniform, blendFactor);
+	};
+	unsigned int sceneMaterialID = renderQueue.addMaterial(sceneMaterial);
+
+	Material skyboxMaterial;
+	skyboxMaterial.shader = &skyboxShader;
+	skyboxMaterial.textureTarget = GL_TEXTURE_CUBE_MAP;
+	skyboxMaterial.textures[0] = cubemapTexture;
+	skyboxMaterial.depthFunc = GL_LEQUAL;
+	unsigned int skyboxMaterialID = renderQueue.addMaterial(skyboxMaterial);
+
+	// setup bound textures and VAOs directly; start tracking from a clean slate
+	glState().invalidate();
+
+	// headless runs draw into an FBO for a fixed number of frames
+	OffscreenTarget offscreen;
+	FrameStats frameStats;
+	std::vector<unsigned char> capturePixels;
+	unsigned int headlessFrame = 0;
+	if (headless.enabled)
+	{
+		if (!offscreen.init(screen_width, screen_height))
+		{
+			headlessContext.release();
+			glfwTerminate();
+			return -1;
+		}
+		// cube 0 spins for the whole run so the cube pass does real work
+		rotatingCubeIndex = 0;
+		rotateRandomCube = true;
+	}
+
+#if defined(PROFILER_ENABLED)
+	profiler().gpu.init();
+	profiler().capture = !headless.traceFile.empty();
+#endif
+
+	currentState.cameraPos = cameraPos;
+	currentState.rotationAngle = rotationAngle;
+	previousState = currentState;
+	lastFrame = secondsSinceStart();
+	bool firstFrame = true;
+	bool running = true;
+
 	// render loop
-	while (!glfwWindowShouldClose(window))
+	while (running && !(window && glfwWindowShouldClose(window)))
 	{
-		float currentFrame = glfwGetTime();
+		glState().beginFrame();
+		float currentFrame = secondsSinceStart();
 		deltaTime = currentFrame - lastFrame;
 		lastFrame = currentFrame;
-		processInput(window);
-		render();
-		ourShader.use();
-		ourShader.setInt("isPlane", 1);
-		ourShader.setVec3("blendColor", glm::vec3(1.0f, 0.3f, 0.6f));
-		// Draw Plane
-		glBindVertexArray(VAO);
-		glDrawElements(GL_TRIANGLES, 6, GL_UNSIGNED_INT, (void*)(sizeof(unsigned int) * 36 * 4));
-		ourShader.setInt("isPlane", 0);
-
-		// draw cubes
-		for (int i = 0; i < 4; i++)
+		if (headless.enabled)
 		{
-			if (resetTransformations)
-			{
-				scale = 1.0f;
-				moveToCenter = false;
-				rotateRandomCube = false;
-				rotationAngle = 0.0f;
-				model = glm::translate(model, originalPositions[i]);
-				resetTransformations = false;
-			}
-			else
+			// simulated time, one tick per frame before --time-scale, so every
+			// run renders the same frames
+			deltaTime = static_cast<float>(simulationClock.step);
+		}
+		if (!headless.enabled)
+		{
+			PROFILE_SCOPE("processInput");
+			processInput(window);
+		}
+		if (!materialTextures.ready())
+		{
+			PROFILE_SCOPE("material uploads");
+			textureStreamer.update([](GLuint texture, GLint layer, size_t) { materialTextures.uploaded(texture, layer); });
+		}
+		if (assetLoader.pending())
+		{
+			PROFILE_SCOPE("skybox uploads");
+			DecodedImage face;
+			while (assetLoader.poll(face))
 			{
-				if (moveToCenter && i == rotatingCubeIndex)
-				{
-					model = glm::translate(model, glm::vec3(0.0f, 0.0f, 0.0f));
-				}
-				if (i == rotatingCubeIndex)
-				{
-					model = glm::scale(model, glm::vec3(scale, scale, scale));
-					model = glm::rotate(model, glm::radians(rotationAngle), glm::vec3(0.0f, 1.0f, 0.0f));
-				}
+				uploadCubemapFace(cubemapTexture, face.id - firstFace, face);
+				face.release();
 			}
+		}
 
-			int applyBlend = (i == selectedSquare) ? 1 : 0;
-			ourShader.setInt("applyBlend", applyBlend);
-			glActiveTexture(GL_TEXTURE0);
-			glBindTexture(GL_TEXTURE_2D, texture1);
-			ourShader.setInt("texture1", 0);
-			glActiveTexture(GL_TEXTURE1);
-			glBindTexture(GL_TEXTURE_2D, texture2);
-			ourShader.setInt("texture2", 1);
-			ourShader.setFloat("blendFactor", blendFactor);
-			ourShader.setVec3("blendColor", blendColor);
-
-			ourShader.setMat4("model", model);
-			glDrawElements(GL_TRIANGLES, 36, GL_UNSIGNED_INT, (void*)(i * 36 * sizeof(unsigned int)));
+		// fixed simulation ticks, then blend the last two for this frame
+		unsigned int ticks = simulationClock.advance(deltaTime);
+		for (unsigned int tick = 0; tick < ticks; tick++)
+			simulate(static_cast<float>(simulationClock.step));
+		float alpha = simulationClock.alpha();
+		cameraPos = glm::mix(previousState.cameraPos, currentState.cameraPos, alpha);
+		rotationAngle = glm::mix(previousState.rotationAngle, currentState.rotationAngle, alpha);
+		if (headless.enabled)
+			scriptedCamera(static_cast<float>(headlessFrame) / headless.frames, cameraPos, cameraFront);
+
+		// per-frame constants shared by every program through the FrameData block
+		cameraView = glm::lookAt(cameraPos, cameraPos + cameraFront, cameraUp);
+		FrameData frameData;
+		frameData.view = cameraView;
+		frameData.projection = projection;
+		frameData.viewProjection = projection * cameraView;
+		frameData.skyboxView = glm::mat4(glm::mat3(cameraView));
+		frameData.cameraPos = cameraPos;
+		frameData.time = currentFrame;
+		frameDataBuffer.update(frameData);
+
+		{
+			PROFILE_GPU_SCOPE("render");
+			render();
+		}
+		renderQueue.begin(cameraView, nearPlane, farPlane);
+
+		// opaque pass: the plane and the instanced cubes become indirect
+		// commands over the shared VAO, drawn with one multi-draw call.
+		// Per-cube state lives in the instance buffer; only cubes inside
+		// the view frustum are uploaded.
+		{
+			PROFILE_SCOPE("update cubes");
+			updateCubeInstances();
+			cullSpheres(extractFrustum(frameData.viewProjection), cubeBounds, visibleCubes);
+		}
+		{
+			PROFILE_GPU_SCOPE("upload");
+			unsigned int visibleCubeCount = cubeRenderer.uploadVisible(visibleCubes);
+			opaqueDraws.clear();
+			opaqueDraws.add(planeMesh, glm::mat4(1.0f), MATERIAL_PLANE);
+			opaqueDraws.add(cubeMesh, glm::mat4(1.0f), MATERIAL_CUBE, visibleCubeCount);
+			opaqueDraws.upload();
 		}
 
+		DrawPacket opaque;
+		opaque.mesh.VAO = VAO;
+		opaque.mesh.indirect = true;
+		opaque.mesh.count = opaqueDraws.size();
+		opaque.material = sceneMaterialID;
+		renderQueue.submit(opaque);
+
 		//glEnable(GL_CULL_FACE);
 		//glCullFace(GL_FRONT);
 		//glFrontFace(GL_CCW);
 
-		cameraView = glm::lookAt(cameraPos, cameraPos + cameraFront, cameraUp);
-		ourShader.setMat4("view", cameraView);
-		ourShader.setMat4("projection", projection);
-
-		skyboxShader.use();
-		cameraView = glm::mat4(glm::mat3(cameraView));
-		skyboxShader.setMat4("view", cameraView);
-		skyboxShader.setMat4("projection", projection);
-
 		// skybox cube
-		glDepthFunc(GL_LEQUAL);
-		glBindVertexArray(skyboxVAO);
-		glActiveTexture(GL_TEXTURE0);
-		glBindTexture(GL_TEXTURE_CUBE_MAP, cubemapTexture);
-		glDrawArrays(GL_TRIANGLES, 0, 36);
-		glBindVertexArray(0);
-		glDepthFunc(GL_LESS);
-
-		glfwSwapBuffers(window);
-		glfwPollEvents();
-	}
+		DrawPacket skybox;
+		skybox.mesh.VAO = skyboxVAO;
+		skybox.mesh.count = 36;
+		skybox.mesh.indexed = false;
+		skybox.material = skyboxMaterialID;
+		skybox.pass = PASS_SKYBOX;
+		renderQueue.submit(skybox);
+
+		renderQueue.sort();
+		{
+			// the plane and the cubes share one multi-draw call
+			PROFILE_GPU_SCOPE("plane + cube draws");
+			renderQueue.execute(PASS_OPAQUE);
+		}
+		{
+			PROFILE_GPU_SCOPE("skybox draw");
+			renderQueue.execute(PASS_SKYBOX);
+		}
+		renderQueue.execute(PASS_TRANSPARENT);
+		glState().bindVertexArray(0);
+		glState().setDepthFunc(GL_LESS);
 
-	glfwDestroyWindow(window);
+		frameDataBuffer.endFrame();
+		if (headless.enabled)
+		{
+			// wait for the GPU so the sample covers the whole frame
+			glFinish();
+			frameStats.add((secondsSinceStart() - currentFrame) * 1000.0);
+			if (headless.captures(headlessFrame))
+			{
+				char name[32];
+				std::snprintf(name, sizeof(name), "/frame_%05u.png", headlessFrame);
+				offscreen.readPixels(capturePixels);
+				writePNG(headless.captureDir + name, offscreen.width, offscreen.height, capturePixels);
+			}
+			if (++headlessFrame >= headless.frames)
+				running = false;
+		}
+		else
+		{
+			PROFILE_SCOPE("glfwSwapBuffers");
+			glfwSwapBuffers(window);
+		}
+		if (firstFrame)
+		{
+			std::cout << "time to first frame: " << secondsSinceStart() * 1000.0 << " ms ("
+				<< decodeJobs.size() << " decode workers)" << std::endl;
+			firstFrame = false;
+		}
+		if (window)
+			glfwPollEvents();
+		PROFILE_FRAME();
+	}
+	// the decode workers must be done with the loader and the streamer
+	// before they go
+	DecodedImage unusedFace;
+	while (assetLoader.next(unusedFace))
+		unusedFace.release();
+	materialTextures.finish(textureStreamer);
+
+	if (headless.enabled)
+	{
+		frameStats.print(std::cout);
+		offscreen.release();
+	}
+#if defined(PROFILER_ENABLED)
+	profiler().printSummary(std::cout);
+	if (!headless.traceFile.empty())
+		profiler().writeChromeTrace(headless.traceFile);
+	profiler().gpu.release();
+#endif
 	glDeleteVertexArrays(1, &VAO);
 	glDeleteBuffers(1, &VBO);
-	glfwTerminate();
+	cubeRenderer.release();
+	opaqueDraws.release();
+	frameDataBuffer.release();
+	materialTextures.release();
+	textureStreamer.release();
+	if (window)
+	{
+		glfwDestroyWindow(window);
+		glfwTerminate();
+	}
+	headlessContext.release();
 	return 0;
 }
 
-void tranformations(Shader& ourShader)
+void tranformations()
 {
-	projection = glm::perspective(glm::radians(45.0f), (float)screen_width / (float)screen_height, 0.1f, 100.0f);
-	ourShader.use();
-	ourShader.setMat4("projection", projection);
+	projection = glm::perspective(glm::radians(45.0f), (float)screen_width / (float)screen_height, nearPlane, farPlane);
+}
+
+// rebuilds the per-instance model matrix and blend state of every cube
+void updateCubeInstances()
+{
+	if (resetTransformations)
+	{
+		scale = 1.0f;
+		moveToCenter = false;
+		rotateRandomCube = false;
+		rotationAngle = 0.0f;
+		currentState.rotationAngle = previousState.rotationAngle = 0.0f;
+		resetTransformations = false;
+	}
+
+	for (unsigned int i = 0; i < numCubes; i++)
+	{
+		CubeInstance& cube = cubeRenderer.instance(i);
+		bool transformed = static_cast<int>(i) == rotatingCubeIndex;
+
+		glm::mat4 cubeModel = glm::mat4(1.0f);
+		cubeModel = glm::translate(cubeModel, (moveToCenter && transformed) ? centerPosition : originalPositions[i]);
+		if (transformed)
+		{
+			cubeModel = glm::scale(cubeModel, glm::vec3(scale, scale, scale));
+			cubeModel = glm::rotate(cubeModel, glm::radians(rotationAngle), glm::vec3(0.0f, 1.0f, 0.0f));
+		}
+		// the shared mesh is the top right cube; mirror it into the other corners
+		cube.model = glm::scale(cubeModel, cubeMirror[i]);
+
+		// bounding sphere for culling, grown by the largest axis scale
+		float maxScale = glm::max(glm::length(glm::vec3(cube.model[0])), glm::max(glm::length(glm::vec3(cube.model[1])), glm::length(glm::vec3(cube.model[2]))));
+		cubeBounds.set(i, glm::vec3(cube.model[3]), cubeRadius * maxScale);
+		cube.applyBlend = (static_cast<int>(i) == selectedSquare) ? 1 : 0;
+		cube.blendColor = blendColor;
+		std::uint32_t image = materialRegions[i % materialRegions.size()];
+		std::uint32_t nextImage = materialRegions[(i + 1) % materialRegions.size()];
+		cube.texture = appliedTexture ? nextImage : image;
+		cube.blendTexture = appliedTexture ? image : nextImage;
+	}
 }
 
 void render()
 {
 	glClearColor(0.1f, 0.2f, 0.2f, 1.0f);
-	glClear(GL_COLOR_BUFFER_BIT);
-	glActiveTexture(GL_TEXTURE0);
-	glBindTexture(GL_TEXTURE_2D, texture1);
-	glActiveTexture(GL_TEXTURE1);
-	glBindTexture(GL_TEXTURE_2D, texture2);
-	glBindVertexArray(VAO);
+	glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+}
 
+// one fixed simulation tick
+void simulate(float dt)
+{
+	previousState = currentState;
+	currentState.cameraPos += cameraVelocity * dt;
 	if (rotateRandomCube && rotatingCubeIndex != -1)
 	{
-		rotationAngle += 45.0f * deltaTime;
+		currentState.rotationAngle += 45.0f * dt;
 	}
 }
 
@@ -250,10 +602,10 @@ void init(void)
 	float offset = 0.5f;
 
 	float planeVertices[] = {
-	 -2.0f, -2.0f, -0.6f,   0.0f, 0.0f
-	  2.0f, -2.0f, -0.6f,   1.0f, 0.0f
-	  2.0f, 2.0f,  -0.6f,   1.0f, 1.0f
-	  - 2.0f, 2.0f, -0.6f,   0.0f, 1.0f
+	 -2.0f, -2.0f, -0.6f,   0.0f, 0.0f,
+	  2.0f, -2.0f, -0.6f,   1.0f, 0.0f,
+	  2.0f, 2.0f,  -0.6f,   1.0f, 1.0f,
+	 -2.0f, 2.0f, -0.6f,   0.0f, 1.0f
 	};
 
 	unsigned int planeIndices[] = {
@@ -389,9 +741,32 @@ void init(void)
 		-0.5f, -0.5f, 1.0f, 1.0f, 0.0f
 	};
 
-	// Calculate the size of the vertices and indices arrays
-	int verticesArraySize = sizeof(vertices) + sizeof(planeVertices);
-	int indicesArraySize = sizeof(indices) + sizeof(planeIndices);
+	// shared cube mesh for the instanced pass, centered on the origin
+	float halfSize = size / 2.0f;
+	float halfDepth = depth / 2.0f;
+	float cubeVertices[] = {
+		-halfSize,  halfSize,  halfDepth,    0.0f, 1.0f,	// Front Top Left
+		 halfSize,  halfSize,  halfDepth,    1.0f, 1.0f,	// Front Top Right
+		 halfSize, -halfSize,  halfDepth,    1.0f, 0.0f,	// Front Bottom Right
+		-halfSize, -halfSize,  halfDepth,    0.0f, 0.0f,	// Front Bottom Left
+		-halfSize,  halfSize, -halfDepth,    1.0f, 1.0f,	// Back Top Left
+		 halfSize,  halfSize, -halfDepth,    0.0f, 1.0f,	// Back Top Right
+		 halfSize, -halfSize, -halfDepth,    0.0f, 0.0f,	// Back Bottom Right
+		-halfSize, -halfSize, -halfDepth,    1.0f, 0.0f,	// Back Bottom Left
+	};
+
+	// Calculate the size of the vertices and indices arrays. The shared cube
+	// reuses the first cube's 36 indices through a base vertex.
+	int verticesArraySize = sizeof(vertices) + sizeof(planeVertices) + sizeof(cubeVertices);
+	int indicesArraySize = sizeof(indices) + sizeof(planeIndices) + sizeof(unsigned int) * 36;
+
+	// sub-meshes of the shared VAO/EBO, drawn through the indirect builder
+	planeMesh.count = 6;
+	planeMesh.firstIndex = 36 * 4;
+	planeMesh.baseVertex = 0;
+	cubeMesh.count = 36;
+	cubeMesh.firstIndex = planeMesh.firstIndex + planeMesh.count;
+	cubeMesh.baseVertex = 8 * 4 + 4;
 
 	glGenVertexArrays(1, &VAO);
 	glGenBuffers(1, &VBO);
@@ -403,11 +778,13 @@ void init(void)
 	glBufferData(GL_ARRAY_BUFFER, verticesArraySize, nullptr, GL_STATIC_DRAW);
 	glBufferSubData(GL_ARRAY_BUFFER, 0, sizeof(vertices), vertices);
 	glBufferSubData(GL_ARRAY_BUFFER, sizeof(vertices), sizeof(planeVertices), planeVertices);
+	glBufferSubData(GL_ARRAY_BUFFER, sizeof(vertices) + sizeof(planeVertices), sizeof(cubeVertices), cubeVertices);
 
 	glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, EBO);
 	glBufferData(GL_ELEMENT_ARRAY_BUFFER, indicesArraySize, nullptr, GL_STATIC_DRAW);
 	glBufferSubData(GL_ELEMENT_ARRAY_BUFFER, 0, sizeof(indices), indices);
 	glBufferSubData(GL_ELEMENT_ARRAY_BUFFER, sizeof(indices), sizeof(planeIndices), planeIndices);
+	glBufferSubData(GL_ELEMENT_ARRAY_BUFFER, sizeof(indices) + sizeof(planeIndices), sizeof(unsigned int) * 36, indices);
 
 	// Position attribute
 	glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 5 * sizeof(float), (void*)0);
@@ -425,27 +802,47 @@ void init(void)
 	glBufferData(GL_ARRAY_BUFFER, sizeof(skyboxVertices), &skyboxVertices, GL_STATIC_DRAW);
 	glEnableVertexAttribArray(0);
 	glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 3 * sizeof(float), (void*)0);
+
+	cubeRenderer.init(VAO, cubeMesh);
+	cubeRenderer.resize(numCubes);
+	cubeBounds.resize(numCubes);
+	cubeRadius = glm::length(glm::vec3(halfSize, halfSize, halfDepth));
+
+	// cube centers, in the same order as the cubes in vertices[]
+	glm::vec3 center = glm::vec3(offset + halfSize, offset - halfSize, -halfDepth);
+	glm::vec3 mirrors[numCubes] = {
+		glm::vec3(-1.0f,  1.0f, 1.0f),	// Top Left
+		glm::vec3( 1.0f,  1.0f, 1.0f),	// Top Right
+		glm::vec3(-1.0f, -1.0f, 1.0f),	// Bottom Left
+		glm::vec3( 1.0f, -1.0f, 1.0f),	// Bottom Right
+	};
+	for (unsigned int i = 0; i < numCubes; i++)
+	{
+		cubeMirror[i] = mirrors[i];
+		originalPositions[i] = center * mirrors[i];
+	}
 }
 
 // glfw: user input
 void processInput(GLFWwindow* window)
 {
-	glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
 	if (glfwGetKey(window, GLFW_KEY_ESCAPE) == GLFW_PRESS)
 		glfwSetWindowShouldClose(window, true);
 
-	float cameraSpeed = 3 * deltaTime;
+	// movement is applied in simulate(); here we only sample the keys
+	float cameraSpeed = 3.0f;
+	cameraVelocity = glm::vec3(0.0f);
 	if (glfwGetKey(window, GLFW_KEY_W) == GLFW_PRESS)
-		cameraPos += cameraSpeed * cameraFront;
+		cameraVelocity += cameraSpeed * cameraFront;
 
 	if (glfwGetKey(window, GLFW_KEY_S) == GLFW_PRESS)
-		cameraPos -= cameraSpeed * cameraFront;
+		cameraVelocity -= cameraSpeed * cameraFront;
 
 	if (glfwGetKey(window, GLFW_KEY_A) == GLFW_PRESS)
-		cameraPos -= glm::normalize(glm::cross(cameraFront, cameraUp)) * cameraSpeed;
+		cameraVelocity -= glm::normalize(glm::cross(cameraFront, cameraUp)) * cameraSpeed;
 
 	if (glfwGetKey(window, GLFW_KEY_D) == GLFW_PRESS)
-		cameraPos += glm::normalize(glm::cross(cameraFront, cameraUp)) * cameraSpeed;
+		cameraVelocity += glm::normalize(glm::cross(cameraFront, cameraUp)) * cameraSpeed;
 }
 
 // glfw: viewport to window adjustment
@@ -537,83 +934,37 @@ void key_callback(GLFWwindow* window, int key, int scancode, int action, int mod
 	{
 		resetTransformations = true;
 	}
-}
-
-void texture1Rendering(const char* path)
-{
-	// texture 1
-	// ---------
-	glGenTextures(1, &texture1);
-	glBindTexture(GL_TEXTURE_2D, texture1);
-	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);
-	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_REPEAT);
-	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
-	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
-	stbi_set_flip_vertically_on_load(true);
-	unsigned char* data = stbi_load(path, &width, &height, &nrChannels, 0);
-	if (data)
-	{
-		glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, width, height, 0, GL_RGBA, GL_UNSIGNED_BYTE, data);
-		glGenerateMipmap(GL_TEXTURE_2D);
-	}
-	else
+#if defined(PROFILER_ENABLED)
+	if (key == GLFW_KEY_F1 && action == GLFW_PRESS)
 	{
-		std::cout << "Failed to load texture" << std::endl;
+		profiler().printSummary(std::cout);
 	}
-	stbi_image_free(data);
-}
-
-void texture2Rendering(const char* path)
-{
-	// texture 2
-	// ---------
-	glGenTextures(1, &texture2);
-	glBindTexture(GL_TEXTURE_2D, texture2);
-	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);
-	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_REPEAT);
-	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
-	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
-	stbi_set_flip_vertically_on_load(true);
-	unsigned char* data = stbi_load(path, &width, &height, &nrChannels, 0);
-	if (data)
-	{
-		glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, width, height, 0, GL_RGBA, GL_UNSIGNED_BYTE, data);
-		glGenerateMipmap(GL_TEXTURE_2D);
-	}
-	else
-	{
-		std::cout << "Failed to load texture" << std::endl;
-	}
-	stbi_image_free(data);
+#endif
 }
 
-unsigned int loadCubemap(std::vector<std::string> faces)
+unsigned int createCubemap()
 {
 	unsigned int textureID;
 	glGenTextures(1, &textureID);
 	glBindTexture(GL_TEXTURE_CUBE_MAP, textureID);
-
-	int width, height, nrChannels;
-	stbi_set_flip_vertically_on_load(false);
-	for (unsigned int i = 0; i < faces.size(); i++)
-	{
-		unsigned char* data = stbi_load(faces[i].c_str(), &width, &height, &nrChannels, 0);
-		if (data)
-		{
-			glTexImage2D(GL_TEXTURE_CUBE_MAP_POSITIVE_X + i, 0, GL_RGB, width, height, 0, GL_RGB, GL_UNSIGNED_BYTE, data);
-			stbi_image_free(data);
-		}
-		else
-		{
-			std::cout << "Cubemap texture failed to load at path: " << faces[i] << std::endl;
-			stbi_image_free(data);
-		}
-	}
 	glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
 	glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
 	glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
 	glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
 	glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_WRAP_R, GL_CLAMP_TO_EDGE);
-
 	return textureID;
-}
\ No newline at end of file
+}
+
+// face order is +X, -X, +Y, -Y, +Z, -Z
+void uploadCubemapFace(unsigned int cubemap, unsigned int face, const DecodedImage& image)
+{
+	if (!image.pixels)
+	{
+		std::cout << "Cubemap texture failed to load at path: " << image.path << std::endl;
+		return;
+	}
+	GLenum format = pixelFormat(image.channels);
+	// also called from the render loop, where glState tracks the bindings
+	glState().bindTexture(0, GL_TEXTURE_CUBE_MAP, cubemap);
+	glTexImage2D(GL_TEXTURE_CUBE_MAP_POSITIVE_X + face, 0, format, image.width, image.height, 0, format, GL_UNSIGNED_BYTE, image.pixels);
+}
@@ -0,0 +1,333 @@
+#ifndef ASSET_LOADER_H
+#define ASSET_LOADER_H
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstdio>
+#include <cstring>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "stb_image.h"
+
+// fixed set of worker threads running jobs in submission order
+// ------------------------------------------------------------------------
+class JobPool
+{
+public:
+	// 0 workers picks one per hardware thread
+	explicit JobPool(unsigned int workerCount = 0)
+	{
+		if (workerCount == 0)
+			workerCount = std::max(1u, std::thread::hardware_concurrency());
+		for (unsigned int i = 0; i < workerCount; i++)
+			workers.emplace_back([this] { run(); });
+	}
+	~JobPool()
+	{
+		{
+			std::lock_guard<std::mutex> lock(mutex);
+			stopping = true;
+		}
+		wake.notify_all();
+		for (std::thread& worker : workers)
+			worker.join();
+	}
+	JobPool(const JobPool&) = delete;
+	JobPool& operator=(const JobPool&) = delete;
+
+	// ------------------------------------------------------------------------
+	void submit(std::function<void()> job)
+	{
+		{
+			std::lock_guard<std::mutex> lock(mutex);
+			jobs.push_back(std::move(job));
+		}
+		wake.notify_one();
+	}
+	// ------------------------------------------------------------------------
+	unsigned int size() const
+	{
+		return static_cast<unsigned int>(workers.size());
+	}
+
+private:
+	std::vector<std::thread> workers;
+	std::deque<std::function<void()>> jobs;
+	std::mutex mutex;
+	std::condition_variable wake;
+	bool stopping = false;
+
+	void run()
+	{
+		for (;;)
+		{
+			std::function<void()> job;
+			{
+				std::unique_lock<std::mutex> lock(mutex);
+				wake.wait(lock, [this] { return stopping || !jobs.empty(); });
+				if (jobs.empty())
+					return;
+				job = std::move(jobs.front());
+				jobs.pop_front();
+			}
+			job();
+		}
+	}
+};
+
+// runs body(i) for every i in [0, count), spread over the calling thread and
+// the pool's workers (the calling thread alone without a pool), and returns
+// once all of them are done. Indices are handed out in order, one at a
+// time. The pool must not be the one running the caller.
+// ------------------------------------------------------------------------
+template <typename Body>
+void parallelFor(JobPool* pool, int count, Body&& body)
+{
+	std::atomic<int> next{ 0 };
+	auto run = [&]
+	{
+		for (int i = next++; i < count; i = next++)
+			body(i);
+	};
+
+	unsigned int helpers = pool ? std::min(pool->size(), static_cast<unsigned int>(std::max(count - 1, 0))) : 0;
+	std::mutex mutex;
+	std::condition_variable done;
+	unsigned int finished = 0;
+	for (unsigned int i = 0; i < helpers; i++)
+	{
+		pool->submit([&]
+		{
+			run();
+			std::lock_guard<std::mutex> lock(mutex);
+			finished++;
+			done.notify_one();
+		});
+	}
+	run();
+	std::unique_lock<std::mutex> lock(mutex);
+	done.wait(lock, [&] { return finished == helpers; });
+}
+
+// pixels decoded by stb_image, owned until release()
+// ------------------------------------------------------------------------
+struct DecodedImage
+{
+	unsigned int id = 0;
+	std::string path;
+	int width = 0;
+	int height = 0;
+	int channels = 0;
+	unsigned char* pixels = nullptr;
+
+	void release()
+	{
+		stbi_image_free(pixels);
+		pixels = nullptr;
+	}
+};
+
+// stb_image callbacks reading a file one fixed-size chunk at a time, so a
+// decode that stops early only reads the start of the file
+// ------------------------------------------------------------------------
+class ChunkedFileReader
+{
+public:
+	explicit ChunkedFileReader(const std::string& path, size_t chunkSize = 16 * 1024)
+		: file(std::fopen(path.c_str(), "rb")), chunk(chunkSize)
+	{
+	}
+	~ChunkedFileReader()
+	{
+		if (file)
+			std::fclose(file);
+	}
+	ChunkedFileReader(const ChunkedFileReader&) = delete;
+	ChunkedFileReader& operator=(const ChunkedFileReader&) = delete;
+
+	// ------------------------------------------------------------------------
+	bool valid() const
+	{
+		return file != nullptr;
+	}
+	// pass with this reader as the user pointer
+	// ------------------------------------------------------------------------
+	static const stbi_io_callbacks* callbacks()
+	{
+		static const stbi_io_callbacks functions = { read, skip, eof };
+		return &functions;
+	}
+
+private:
+	std::FILE* file;
+	std::vector<unsigned char> chunk;
+	size_t begin = 0;
+	size_t end = 0;
+
+	static int read(void* user, char* data, int size)
+	{
+		ChunkedFileReader& reader = *static_cast<ChunkedFileReader*>(user);
+		int copied = 0;
+		while (copied < size)
+		{
+			if (reader.begin == reader.end)
+			{
+				reader.begin = 0;
+				reader.end = std::fread(reader.chunk.data(), 1, reader.chunk.size(), reader.file);
+				if (reader.end == 0)
+					break;
+			}
+			size_t count = std::min(reader.end - reader.begin, static_cast<size_t>(size - copied));
+			std::memcpy(data + copied, &reader.chunk[reader.begin], count);
+			reader.begin += count;
+			copied += static_cast<int>(count);
+		}
+		return copied;
+	}
+	static void skip(void* user, int count)
+	{
+		ChunkedFileReader& reader = *static_cast<ChunkedFileReader*>(user);
+		size_t buffered = std::min(reader.end - reader.begin, static_cast<size_t>(std::max(count, 0)));
+		reader.begin += buffered;
+		if (static_cast<size_t>(count) > buffered)
+			std::fseek(reader.file, static_cast<long>(count - buffered), SEEK_CUR);
+	}
+	static int eof(void* user)
+	{
+		ChunkedFileReader& reader = *static_cast<ChunkedFileReader*>(user);
+		return reader.begin == reader.end && std::feof(reader.file);
+	}
+};
+
+// decodes images on a JobPool. Workers read and decode the whole file; the
+// GL thread takes finished images with next() and uploads them while the
+// rest are still decoding.
+// ------------------------------------------------------------------------
+class AssetLoader
+{
+public:
+	explicit AssetLoader(JobPool& jobPool) : pool(jobPool)
+	{
+	}
+	// queues a decode and returns the id its DecodedImage will carry
+	// ------------------------------------------------------------------------
+	unsigned int request(const std::string& path, bool flipVertically, int desiredChannels = 0)
+	{
+		unsigned int id;
+		{
+			std::lock_guard<std::mutex> lock(mutex);
+			id = requested++;
+		}
+		pool.submit([this, id, path, flipVertically, desiredChannels]
+		{
+			DecodedImage image = decode(path, flipVertically, desiredChannels);
+			image.id = id;
+			{
+				std::lock_guard<std::mutex> lock(mutex);
+				finished.push_back(image);
+			}
+			ready.notify_one();
+		});
+		return id;
+	}
+	// reads and decodes a file on the calling thread; safe to call from
+	// several threads at once
+	// ------------------------------------------------------------------------
+	static DecodedImage decode(const std::string& path, bool flipVertically, int desiredChannels = 0)
+	{
+		DecodedImage image;
+		image.path = path;
+		std::vector<unsigned char> file;
+		if (readFile(path, file))
+		{
+			// the flip flag is per thread, so workers do not race on it
+			stbi_set_flip_vertically_on_load_thread(flipVertically);
+			image.pixels = stbi_load_from_memory(file.data(), static_cast<int>(file.size()),
+				&image.width, &image.height, &image.channels, desiredChannels);
+			if (desiredChannels)
+				image.channels = desiredChannels;
+		}
+		return image;
+	}
+	// decodes the preview a progressive JPEG carries in its first scans (see
+	// stbi_load_jpeg_preview_from_callbacks), reading only that part of the
+	// file; null pixels for any other image
+	// ------------------------------------------------------------------------
+	static DecodedImage decodePreview(const std::string& path, bool flipVertically, int desiredChannels = 0)
+	{
+		DecodedImage image;
+		image.path = path;
+		ChunkedFileReader reader(path);
+		if (reader.valid())
+		{
+			stbi_set_flip_vertically_on_load_thread(flipVertically);
+			image.pixels = stbi_load_jpeg_preview_from_callbacks(ChunkedFileReader::callbacks(), &reader,
+				&image.width, &image.height, &image.channels, desiredChannels);
+			if (desiredChannels)
+				image.channels = desiredChannels;
+		}
+		return image;
+	}
+	// blocks until a requested image is decoded; false once every image
+	// has been handed out. A failed decode comes back with null pixels.
+	// ------------------------------------------------------------------------
+	bool next(DecodedImage& image)
+	{
+		std::unique_lock<std::mutex> lock(mutex);
+		if (delivered == requested)
+			return false;
+		ready.wait(lock, [this] { return !finished.empty(); });
+		image = finished.front();
+		finished.pop_front();
+		delivered++;
+		return true;
+	}
+	// takes a finished image if there is one, without waiting
+	// ------------------------------------------------------------------------
+	bool poll(DecodedImage& image)
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+		if (finished.empty())
+			return false;
+		image = finished.front();
+		finished.pop_front();
+		delivered++;
+		return true;
+	}
+	// ------------------------------------------------------------------------
+	unsigned int pending()
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+		return requested - delivered;
+	}
+	// the whole file, false if it is missing or empty
+	// ------------------------------------------------------------------------
+	static bool readFile(const std::string& path, std::vector<unsigned char>& data)
+	{
+		std::FILE* file = std::fopen(path.c_str(), "rb");
+		if (!file)
+			return false;
+		std::fseek(file, 0, SEEK_END);
+		long size = std::ftell(file);
+		std::fseek(file, 0, SEEK_SET);
+		data.resize(size > 0 ? static_cast<size_t>(size) : 0);
+		bool ok = size > 0 && std::fread(data.data(), 1, data.size(), file) == data.size();
+		std::fclose(file);
+		return ok;
+	}
+
+private:
+	JobPool& pool;
+	std::mutex mutex;
+	std::condition_variable ready;
+	std::deque<DecodedImage> finished;
+	unsigned int requested = 0;
+	unsigned int delivered = 0;
+};
+#endif
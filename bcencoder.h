@@ -0,0 +1,974 @@
+#ifndef BC_ENCODER_H
+#define BC_ENCODER_H
+
+#include <glad/glad.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <ostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "assetloader.h"
+#include "mipgenerator.h"
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define BC_ENCODER_SSE2
+#include <emmintrin.h>
+#endif
+
+// S3TC is an extension, so glad only has these enums when it is generated
+// with GL_EXT_texture_compression_s3tc
+#ifndef GL_COMPRESSED_RGB_S3TC_DXT1_EXT
+#define GL_COMPRESSED_RGB_S3TC_DXT1_EXT 0x83F0
+#endif
+#ifndef GL_COMPRESSED_RGBA_S3TC_DXT5_EXT
+#define GL_COMPRESSED_RGBA_S3TC_DXT5_EXT 0x83F3
+#endif
+
+// block-compressed texture formats, all in 4x4 texel blocks
+//   BC1  RGB, 8 bytes per block
+//   BC3  RGBA, BC1 color plus a BC4 alpha block, 16 bytes
+//   BC4  one channel (red), 8 bytes
+//   BC5  two channels (red, green), two BC4 blocks, 16 bytes
+//   BC7  RGBA, 16 bytes; encoded with mode 6 only (one subset, 4-bit
+//        indices, RGBA endpoints), the highest quality single mode
+enum TextureCompression
+{
+	COMPRESSION_NONE = 0,
+	COMPRESSION_BC1,
+	COMPRESSION_BC3,
+	COMPRESSION_BC4,
+	COMPRESSION_BC5,
+	COMPRESSION_BC7,
+};
+
+// "bc1", "bc3", "bc4", "bc5" or "bc7"; anything else is COMPRESSION_NONE
+// ------------------------------------------------------------------------
+inline TextureCompression parseCompression(const std::string& name)
+{
+	static const char* names[] = { "none", "bc1", "bc3", "bc4", "bc5", "bc7" };
+	for (int i = 1; i < 6; i++)
+	{
+		if (name == names[i])
+			return static_cast<TextureCompression>(i);
+	}
+	return COMPRESSION_NONE;
+}
+
+// ------------------------------------------------------------------------
+inline GLenum compressedFormat(TextureCompression compression)
+{
+	switch (compression)
+	{
+	case COMPRESSION_BC1:
+		return GL_COMPRESSED_RGB_S3TC_DXT1_EXT;
+	case COMPRESSION_BC3:
+		return GL_COMPRESSED_RGBA_S3TC_DXT5_EXT;
+	case COMPRESSION_BC4:
+		return GL_COMPRESSED_RED_RGTC1;
+	case COMPRESSION_BC5:
+		return GL_COMPRESSED_RG_RGTC2;
+	case COMPRESSION_BC7:
+		return GL_COMPRESSED_RGBA_BPTC_UNORM;
+	default:
+		return 0;
+	}
+}
+
+// ------------------------------------------------------------------------
+inline size_t blockBytes(TextureCompression compression)
+{
+	return compression == COMPRESSION_BC1 || compression == COMPRESSION_BC4 ? 8 : 16;
+}
+
+// ------------------------------------------------------------------------
+inline size_t compressedSize(TextureCompression compression, int width, int height)
+{
+	return static_cast<size_t>((width + 3) / 4) * ((height + 3) / 4) * blockBytes(compression);
+}
+
+namespace bc_detail
+{
+	// 4x4 RGBA texels, row by row; also split into float planes for the
+	// index searches
+	struct Block
+	{
+		std::uint8_t rgba[64];
+		float planes[4][16];
+	};
+
+	// copies a block out of an RGBA8 image, repeating the last row and
+	// column for blocks that hang over the edge
+	inline void fetchBlock(const std::uint8_t* image, int width, int height, int blockX, int blockY, Block& block)
+	{
+		for (int y = 0; y < 4; y++)
+		{
+			int sourceY = std::min(blockY * 4 + y, height - 1);
+			for (int x = 0; x < 4; x++)
+			{
+				int sourceX = std::min(blockX * 4 + x, width - 1);
+				const std::uint8_t* texel = image + (static_cast<size_t>(sourceY) * width + sourceX) * 4;
+				for (int c = 0; c < 4; c++)
+				{
+					block.rgba[(y * 4 + x) * 4 + c] = texel[c];
+					block.planes[c][y * 4 + x] = texel[c];
+				}
+			}
+		}
+	}
+
+	// picks the nearest palette entry for every texel by squared distance
+	// over the first channels planes; the lowest index wins ties. Returns the
+	// summed error.
+	inline float selectIndices(const Block& block, int channels, const float palette[][4], int paletteSize, std::uint8_t indices[16])
+	{
+		float total = 0.0f;
+#if defined(BC_ENCODER_SSE2)
+		for (int i = 0; i < 16; i += 4)
+		{
+			__m128 best = _mm_set1_ps(3.0e38f);
+			__m128i bestIndex = _mm_setzero_si128();
+			for (int p = 0; p < paletteSize; p++)
+			{
+				__m128 distance = _mm_setzero_ps();
+				for (int c = 0; c < channels; c++)
+				{
+					__m128 delta = _mm_sub_ps(_mm_loadu_ps(&block.planes[c][i]), _mm_set1_ps(palette[p][c]));
+					distance = _mm_add_ps(distance, _mm_mul_ps(delta, delta));
+				}
+				__m128 closer = _mm_cmplt_ps(distance, best);
+				best = _mm_min_ps(best, distance);
+				bestIndex = _mm_or_si128(_mm_andnot_si128(_mm_castps_si128(closer), bestIndex),
+					_mm_and_si128(_mm_castps_si128(closer), _mm_set1_epi32(p)));
+			}
+			float errors[4];
+			std::int32_t chosen[4];
+			_mm_storeu_ps(errors, best);
+			_mm_storeu_si128(reinterpret_cast<__m128i*>(chosen), bestIndex);
+			for (int lane = 0; lane < 4; lane++)
+			{
+				indices[i + lane] = static_cast<std::uint8_t>(chosen[lane]);
+				total += errors[lane];
+			}
+		}
+#else
+		for (int i = 0; i < 16; i++)
+		{
+			float best = 3.0e38f;
+			int bestIndex = 0;
+			for (int p = 0; p < paletteSize; p++)
+			{
+				float distance = 0.0f;
+				for (int c = 0; c < channels; c++)
+				{
+					float delta = block.planes[c][i] - palette[p][c];
+					distance = distance + delta * delta;
+				}
+				if (distance < best)
+				{
+					best = distance;
+					bestIndex = p;
+				}
+			}
+			indices[i] = static_cast<std::uint8_t>(bestIndex);
+			total += best;
+		}
+#endif
+		return total;
+	}
+
+	// principal axis of the block's colors over the first channels
+	// channels, by power iteration on the covariance matrix
+	inline void principalAxis(const Block& block, int channels, float mean[4], float axis[4])
+	{
+		float minimum[4], maximum[4];
+		for (int c = 0; c < channels; c++)
+		{
+			mean[c] = 0.0f;
+			minimum[c] = 255.0f;
+			maximum[c] = 0.0f;
+			for (int i = 0; i < 16; i++)
+			{
+				mean[c] += block.planes[c][i];
+				minimum[c] = std::min(minimum[c], block.planes[c][i]);
+				maximum[c] = std::max(maximum[c], block.planes[c][i]);
+			}
+			mean[c] /= 16.0f;
+		}
+		float covariance[4][4] = {};
+		for (int i = 0; i < 16; i++)
+		{
+			for (int a = 0; a < channels; a++)
+			{
+				for (int b = a; b < channels; b++)
+					covariance[a][b] += (block.planes[a][i] - mean[a]) * (block.planes[b][i] - mean[b]);
+			}
+		}
+		for (int a = 0; a < channels; a++)
+		{
+			for (int b = 0; b < a; b++)
+				covariance[a][b] = covariance[b][a];
+		}
+
+		for (int c = 0; c < channels; c++)
+			axis[c] = maximum[c] - minimum[c];
+		for (int iteration = 0; iteration < 8; iteration++)
+		{
+			float next[4] = {};
+			float length = 0.0f;
+			for (int a = 0; a < channels; a++)
+			{
+				for (int b = 0; b < channels; b++)
+					next[a] += covariance[a][b] * axis[b];
+				length = std::max(length, std::fabs(next[a]));
+			}
+			if (length < 1e-6f)
+				break;
+			for (int c = 0; c < channels; c++)
+				axis[c] = next[c] / length;
+		}
+		float length = 0.0f;
+		for (int c = 0; c < channels; c++)
+			length += axis[c] * axis[c];
+		length = std::sqrt(length);
+		for (int c = 0; c < channels; c++)
+			axis[c] = length > 0.0f ? axis[c] / length : 0.0f;
+	}
+
+	// endpoints at the extreme projections of the block onto axis: the
+	// points on the axis through the mean, or with snap the texels themselves
+	inline void axisEndpoints(const Block& block, int channels, const float mean[4], const float axis[4], float low[4], float high[4], bool snap = false)
+	{
+		float minimum = 0.0f, maximum = 0.0f;
+		int lowTexel = 0, highTexel = 0;
+		for (int i = 0; i < 16; i++)
+		{
+			float t = 0.0f;
+			for (int c = 0; c < channels; c++)
+				t += (block.planes[c][i] - mean[c]) * axis[c];
+			if (t < minimum)
+			{
+				minimum = t;
+				lowTexel = i;
+			}
+			if (t > maximum)
+			{
+				maximum = t;
+				highTexel = i;
+			}
+		}
+		for (int c = 0; c < channels; c++)
+		{
+			if (snap)
+			{
+				low[c] = block.planes[c][lowTexel];
+				high[c] = block.planes[c][highTexel];
+			}
+			else
+			{
+				low[c] = std::min(255.0f, std::max(0.0f, mean[c] + minimum * axis[c]));
+				high[c] = std::min(255.0f, std::max(0.0f, mean[c] + maximum * axis[c]));
+			}
+		}
+	}
+
+	// least squares endpoints for fixed indices, weights[i] being the share
+	// of the high endpoint in palette entry i. False when the system is
+	// singular (every texel on one palette entry).
+	inline bool fitEndpoints(const Block& block, int channels, const std::uint8_t indices[16], const float* weights, float low[4], float high[4])
+	{
+		float aa = 0.0f, ab = 0.0f, bb = 0.0f;
+		float ax[4] = {}, bx[4] = {};
+		for (int i = 0; i < 16; i++)
+		{
+			float b = weights[indices[i]];
+			float a = 1.0f - b;
+			aa += a * a;
+			ab += a * b;
+			bb += b * b;
+			for (int c = 0; c < channels; c++)
+			{
+				ax[c] += a * block.planes[c][i];
+				bx[c] += b * block.planes[c][i];
+			}
+		}
+		float determinant = aa * bb - ab * ab;
+		if (std::fabs(determinant) < 1e-6f)
+			return false;
+		for (int c = 0; c < channels; c++)
+		{
+			low[c] = std::min(255.0f, std::max(0.0f, (ax[c] * bb - bx[c] * ab) / determinant));
+			high[c] = std::min(255.0f, std::max(0.0f, (bx[c] * aa - ax[c] * ab) / determinant));
+		}
+		return true;
+	}
+
+	// ------------------------------------------------------------------------
+	inline std::uint16_t packRGB565(const float color[4])
+	{
+		int r = static_cast<int>(color[0] * 31.0f / 255.0f + 0.5f);
+		int g = static_cast<int>(color[1] * 63.0f / 255.0f + 0.5f);
+		int b = static_cast<int>(color[2] * 31.0f / 255.0f + 0.5f);
+		return static_cast<std::uint16_t>((r << 11) | (g << 5) | b);
+	}
+	inline void unpackRGB565(std::uint16_t packed, int color[3])
+	{
+		int r = (packed >> 11) & 31, g = (packed >> 5) & 63, b = packed & 31;
+		color[0] = (r << 3) | (r >> 2);
+		color[1] = (g << 2) | (g >> 4);
+		color[2] = (b << 3) | (b >> 2);
+	}
+	// BC1 palette; four colors when color0 > color1, else three and black
+	inline int colorPalette(std::uint16_t color0, std::uint16_t color1, int palette[4][4])
+	{
+		unpackRGB565(color0, palette[0]);
+		unpackRGB565(color1, palette[1]);
+		palette[0][3] = palette[1][3] = palette[2][3] = 255;
+		for (int c = 0; c < 3; c++)
+		{
+			if (color0 > color1)
+			{
+				palette[2][c] = (2 * palette[0][c] + palette[1][c]) / 3;
+				palette[3][c] = (palette[0][c] + 2 * palette[1][c]) / 3;
+			}
+			else
+			{
+				palette[2][c] = (palette[0][c] + palette[1][c]) / 2;
+				palette[3][c] = 0;
+			}
+		}
+		palette[3][3] = color0 > color1 ? 255 : 0;
+		return color0 > color1 ? 4 : 3;
+	}
+
+	// encodes in four-color mode; the 565 pair is searched from the block's
+	// principal axis and refined by least squares
+	inline void encodeColorBlock(const Block& block, std::uint8_t* out)
+	{
+		// share of color0 in palette entries 0..3
+		static const float weights[4] = { 1.0f, 0.0f, 2.0f / 3.0f, 1.0f / 3.0f };
+
+		float mean[4], axis[4], low[4], high[4];
+		principalAxis(block, 3, mean, axis);
+		axisEndpoints(block, 3, mean, axis, low, high);
+
+		std::uint16_t bestColor0 = 0, bestColor1 = 0;
+		std::uint8_t bestIndices[16] = {};
+		float bestError = 3.0e38f;
+		for (int iteration = 0; iteration < 3; iteration++)
+		{
+			std::uint16_t color0 = packRGB565(high), color1 = packRGB565(low);
+			if (color0 < color1)
+				std::swap(color0, color1);
+			std::uint8_t indices[16];
+			float error;
+			if (color0 == color1)
+			{
+				// one color: every texel on entry 0
+				int palette[4][4];
+				colorPalette(color0, color1, palette);
+				error = 0.0f;
+				for (int i = 0; i < 16; i++)
+				{
+					indices[i] = 0;
+					for (int c = 0; c < 3; c++)
+					{
+						float delta = block.planes[c][i] - palette[0][c];
+						error += delta * delta;
+					}
+				}
+			}
+			else
+			{
+				int palette[4][4];
+				colorPalette(color0, color1, palette);
+				float floatPalette[4][4];
+				for (int p = 0; p < 4; p++)
+				{
+					for (int c = 0; c < 4; c++)
+						floatPalette[p][c] = static_cast<float>(palette[p][c]);
+				}
+				error = selectIndices(block, 3, floatPalette, 4, indices);
+			}
+			if (error < bestError)
+			{
+				bestError = error;
+				bestColor0 = color0;
+				bestColor1 = color1;
+				std::memcpy(bestIndices, indices, 16);
+			}
+			if (bestError == 0.0f || color0 == color1)
+				break;
+			// weights are color0's share, so color0 comes back as high
+			if (!fitEndpoints(block, 3, indices, weights, low, high))
+				break;
+		}
+
+		std::uint32_t packedIndices = 0;
+		for (int i = 0; i < 16; i++)
+			packedIndices |= static_cast<std::uint32_t>(bestIndices[i]) << (i * 2);
+		out[0] = static_cast<std::uint8_t>(bestColor0);
+		out[1] = static_cast<std::uint8_t>(bestColor0 >> 8);
+		out[2] = static_cast<std::uint8_t>(bestColor1);
+		out[3] = static_cast<std::uint8_t>(bestColor1 >> 8);
+		std::memcpy(out + 4, &packedIndices, 4);
+	}
+
+	// BC4 palette for endpoints a0, a1
+	inline void alphaPalette(int a0, int a1, int palette[8])
+	{
+		palette[0] = a0;
+		palette[1] = a1;
+		if (a0 > a1)
+		{
+			for (int i = 1; i < 7; i++)
+				palette[i + 1] = ((7 - i) * a0 + i * a1) / 7;
+		}
+		else
+		{
+			for (int i = 1; i < 5; i++)
+				palette[i + 1] = ((5 - i) * a0 + i * a1) / 5;
+			palette[6] = 0;
+			palette[7] = 255;
+		}
+	}
+
+	// one channel of the block as a BC4 block; tries the eight-value mode
+	// and, when the block touches 0 or 255, the six-value mode
+	inline void encodeAlphaBlock(const Block& block, int channel, std::uint8_t* out)
+	{
+		const float* values = block.planes[channel];
+		int minimum = 255, maximum = 0, innerMinimum = 255, innerMaximum = 0;
+		for (int i = 0; i < 16; i++)
+		{
+			int value = static_cast<int>(values[i]);
+			minimum = std::min(minimum, value);
+			maximum = std::max(maximum, value);
+			if (value != 0 && value != 255)
+			{
+				innerMinimum = std::min(innerMinimum, value);
+				innerMaximum = std::max(innerMaximum, value);
+			}
+		}
+
+		int candidates[2][2] = { { maximum, minimum }, { innerMinimum, innerMaximum } };
+		int candidateCount = (minimum == 0 || maximum == 255) && innerMinimum <= innerMaximum && maximum != minimum ? 2 : 1;
+		int bestError = 0x7FFFFFFF;
+		int bestA0 = maximum, bestA1 = minimum;
+		std::uint8_t bestIndices[16] = {};
+		for (int candidate = 0; candidate < candidateCount; candidate++)
+		{
+			int a0 = candidates[candidate][0], a1 = candidates[candidate][1];
+			int palette[8];
+			alphaPalette(a0, a1, palette);
+			int paletteSize = a0 == a1 ? 1 : 8;
+			std::uint8_t indices[16];
+			int error = 0;
+			for (int i = 0; i < 16; i++)
+			{
+				int value = static_cast<int>(values[i]);
+				int best = 0x7FFFFFFF, bestIndex = 0;
+				for (int p = 0; p < paletteSize; p++)
+				{
+					int distance = (value - palette[p]) * (value - palette[p]);
+					if (distance < best)
+					{
+						best = distance;
+						bestIndex = p;
+					}
+				}
+				indices[i] = static_cast<std::uint8_t>(bestIndex);
+				error += best;
+			}
+			if (error < bestError)
+			{
+				bestError = error;
+				bestA0 = a0;
+				bestA1 = a1;
+				std::memcpy(bestIndices, indices, 16);
+			}
+		}
+
+		out[0] = static_cast<std::uint8_t>(bestA0);
+		out[1] = static_cast<std::uint8_t>(bestA1);
+		std::uint64_t packedIndices = 0;
+		for (int i = 0; i < 16; i++)
+			packedIndices |= static_cast<std::uint64_t>(bestIndices[i]) << (i * 3);
+		for (int i = 0; i < 6; i++)
+			out[2 + i] = static_cast<std::uint8_t>(packedIndices >> (i * 8));
+	}
+
+	// BC7 interpolation weights for 4-bit indices, out of 64
+	static const int bc7Weights[16] = { 0, 4, 9, 13, 17, 21, 26, 30, 34, 38, 43, 47, 51, 55, 60, 64 };
+
+	// appends count bits of value to a 128-bit block, LSB first
+	struct BitWriter
+	{
+		std::uint8_t* out;
+		int position = 0;
+
+		void write(std::uint32_t value, int count)
+		{
+			for (int i = 0; i < count; i++, position++)
+			{
+				if ((value >> i) & 1)
+					out[position >> 3] |= static_cast<std::uint8_t>(1 << (position & 7));
+			}
+		}
+	};
+	struct BitReader
+	{
+		const std::uint8_t* in;
+		int position = 0;
+
+		std::uint32_t read(int count)
+		{
+			std::uint32_t value = 0;
+			for (int i = 0; i < count; i++, position++)
+				value |= static_cast<std::uint32_t>((in[position >> 3] >> (position & 7)) & 1) << i;
+			return value;
+		}
+	};
+
+	// 7-bit endpoint plus shared p-bit -> 8-bit value
+	inline int bc7Quantize(float value, int pBit)
+	{
+		int quantized = static_cast<int>((value - pBit) / 2.0f + 0.5f);
+		return std::min(127, std::max(0, quantized));
+	}
+
+	// mode 6: tries every p-bit pair for the current endpoints, then refits
+	// the endpoints by least squares against the best indices
+	inline void encodeBC7Block(const Block& block, std::uint8_t* out)
+	{
+		static float weights[16];
+		static const bool weightsReady = []
+		{
+			for (int i = 0; i < 16; i++)
+				weights[i] = bc7Weights[i] / 64.0f;
+			return true;
+		}();
+		(void)weightsReady;
+
+		float mean[4], axis[4];
+		principalAxis(block, 4, mean, axis);
+
+		int bestEndpoints[2][4] = {};
+		int bestPBits[2] = {};
+		std::uint8_t bestIndices[16] = {};
+		float bestError = 3.0e38f;
+		// start from the axis through the mean and from the extreme texels;
+		// the second does better when a few outliers pull the axis around
+		for (int start = 0; start < 2 && bestError > 0.0f; start++)
+		{
+			float low[4], high[4];
+			axisEndpoints(block, 4, mean, axis, low, high, start == 1);
+			for (int iteration = 0; iteration < 3; iteration++)
+			{
+				bool improved = false;
+				std::uint8_t iterationIndices[16] = {};
+				float iterationError = 3.0e38f;
+				for (int pBits = 0; pBits < 4; pBits++)
+				{
+					int p0 = pBits & 1, p1 = pBits >> 1;
+					int endpoints[2][4];
+					float palette[16][4];
+					for (int c = 0; c < 4; c++)
+					{
+						endpoints[0][c] = bc7Quantize(low[c], p0);
+						endpoints[1][c] = bc7Quantize(high[c], p1);
+						int e0 = (endpoints[0][c] << 1) | p0, e1 = (endpoints[1][c] << 1) | p1;
+						for (int i = 0; i < 16; i++)
+							palette[i][c] = static_cast<float>(((64 - bc7Weights[i]) * e0 + bc7Weights[i] * e1 + 32) >> 6);
+					}
+					std::uint8_t indices[16];
+					float error = selectIndices(block, 4, palette, 16, indices);
+					if (error < iterationError)
+					{
+						iterationError = error;
+						std::memcpy(iterationIndices, indices, 16);
+					}
+					if (error < bestError)
+					{
+						bestError = error;
+						std::memcpy(bestEndpoints, endpoints, sizeof(endpoints));
+						bestPBits[0] = p0;
+						bestPBits[1] = p1;
+						std::memcpy(bestIndices, indices, 16);
+						improved = true;
+					}
+				}
+				if (bestError == 0.0f || !improved)
+					break;
+				if (!fitEndpoints(block, 4, iterationIndices, weights, low, high))
+					break;
+			}
+		}
+
+		// the first index has an implicit top bit of 0
+		if (bestIndices[0] & 8)
+		{
+			for (int c = 0; c < 4; c++)
+				std::swap(bestEndpoints[0][c], bestEndpoints[1][c]);
+			std::swap(bestPBits[0], bestPBits[1]);
+			for (int i = 0; i < 16; i++)
+				bestIndices[i] = static_cast<std::uint8_t>(15 - bestIndices[i]);
+		}
+
+		std::memset(out, 0, 16);
+		BitWriter writer{ out };
+		writer.write(1 << 6, 7);
+		for (int c = 0; c < 4; c++)
+		{
+			writer.write(bestEndpoints[0][c], 7);
+			writer.write(bestEndpoints[1][c], 7);
+		}
+		writer.write(bestPBits[0], 1);
+		writer.write(bestPBits[1], 1);
+		writer.write(bestIndices[0], 3);
+		for (int i = 1; i < 16; i++)
+			writer.write(bestIndices[i], 4);
+	}
+
+	// ------------------------------------------------------------------------
+	inline void encodeBlock(const Block& block, TextureCompression compression, std::uint8_t* out)
+	{
+		switch (compression)
+		{
+		case COMPRESSION_BC1:
+			encodeColorBlock(block, out);
+			break;
+		case COMPRESSION_BC3:
+			encodeAlphaBlock(block, 3, out);
+			encodeColorBlock(block, out + 8);
+			break;
+		case COMPRESSION_BC4:
+			encodeAlphaBlock(block, 0, out);
+			break;
+		case COMPRESSION_BC5:
+			encodeAlphaBlock(block, 0, out);
+			encodeAlphaBlock(block, 1, out + 8);
+			break;
+		case COMPRESSION_BC7:
+			encodeBC7Block(block, out);
+			break;
+		default:
+			break;
+		}
+	}
+
+	// decoders, for measuring the encoders -----------------------------------
+	inline void decodeColorBlock(const std::uint8_t* in, std::uint8_t rgba[64])
+	{
+		std::uint16_t color0 = static_cast<std::uint16_t>(in[0] | (in[1] << 8));
+		std::uint16_t color1 = static_cast<std::uint16_t>(in[2] | (in[3] << 8));
+		std::uint32_t indices;
+		std::memcpy(&indices, in + 4, 4);
+		int palette[4][4];
+		colorPalette(color0, color1, palette);
+		for (int i = 0; i < 16; i++)
+		{
+			for (int c = 0; c < 4; c++)
+				rgba[i * 4 + c] = static_cast<std::uint8_t>(palette[(indices >> (i * 2)) & 3][c]);
+		}
+	}
+	inline void decodeAlphaBlock(const std::uint8_t* in, std::uint8_t rgba[64], int channel)
+	{
+		int palette[8];
+		alphaPalette(in[0], in[1], palette);
+		std::uint64_t indices = 0;
+		for (int i = 0; i < 6; i++)
+			indices |= static_cast<std::uint64_t>(in[2 + i]) << (i * 8);
+		for (int i = 0; i < 16; i++)
+			rgba[i * 4 + channel] = static_cast<std::uint8_t>(palette[(indices >> (i * 3)) & 7]);
+	}
+	// mode 6 only; blocks in other modes decode to opaque magenta
+	inline void decodeBC7Block(const std::uint8_t* in, std::uint8_t rgba[64])
+	{
+		if (in[0] != (1 << 6) && (in[0] & 0x7F) != (1 << 6))
+		{
+			for (int i = 0; i < 16; i++)
+			{
+				rgba[i * 4 + 0] = 255;
+				rgba[i * 4 + 1] = 0;
+				rgba[i * 4 + 2] = 255;
+				rgba[i * 4 + 3] = 255;
+			}
+			return;
+		}
+		BitReader reader{ in };
+		reader.read(7);
+		int endpoints[2][4];
+		for (int c = 0; c < 4; c++)
+		{
+			endpoints[0][c] = reader.read(7);
+			endpoints[1][c] = reader.read(7);
+		}
+		int p0 = reader.read(1), p1 = reader.read(1);
+		for (int c = 0; c < 4; c++)
+		{
+			endpoints[0][c] = (endpoints[0][c] << 1) | p0;
+			endpoints[1][c] = (endpoints[1][c] << 1) | p1;
+		}
+		for (int i = 0; i < 16; i++)
+		{
+			int index = reader.read(i == 0 ? 3 : 4);
+			for (int c = 0; c < 4; c++)
+				rgba[i * 4 + c] = static_cast<std::uint8_t>(((64 - bc7Weights[index]) * endpoints[0][c] + bc7Weights[index] * endpoints[1][c] + 32) >> 6);
+		}
+	}
+	inline void decodeBlock(const std::uint8_t* in, TextureCompression compression, std::uint8_t rgba[64])
+	{
+		switch (compression)
+		{
+		case COMPRESSION_BC1:
+			decodeColorBlock(in, rgba);
+			break;
+		case COMPRESSION_BC3:
+			decodeColorBlock(in + 8, rgba);
+			decodeAlphaBlock(in, rgba, 3);
+			break;
+		case COMPRESSION_BC4:
+			std::memset(rgba, 0, 64);
+			decodeAlphaBlock(in, rgba, 0);
+			for (int i = 0; i < 16; i++)
+				rgba[i * 4 + 3] = 255;
+			break;
+		case COMPRESSION_BC5:
+			std::memset(rgba, 0, 64);
+			decodeAlphaBlock(in, rgba, 0);
+			decodeAlphaBlock(in + 8, rgba, 1);
+			for (int i = 0; i < 16; i++)
+				rgba[i * 4 + 3] = 255;
+			break;
+		case COMPRESSION_BC7:
+			decodeBC7Block(in, rgba);
+			break;
+		default:
+			break;
+		}
+	}
+}
+
+// encodes an RGBA8 image into compressedSize(compression, width, height)
+// bytes at out. With a pool, rows of blocks are shared between the calling
+// thread and the pool's workers; see parallelFor.
+// ------------------------------------------------------------------------
+inline void encodeImage(const std::uint8_t* rgba, int width, int height, TextureCompression compression, std::uint8_t* out, JobPool* pool = nullptr)
+{
+	int blocksX = (width + 3) / 4;
+	int blocksY = (height + 3) / 4;
+	size_t rowBytes = blocksX * blockBytes(compression);
+	parallelFor(pool, blocksY, [&](int blockY)
+	{
+		bc_detail::Block block;
+		for (int blockX = 0; blockX < blocksX; blockX++)
+		{
+			bc_detail::fetchBlock(rgba, width, height, blockX, blockY, block);
+			bc_detail::encodeBlock(block, compression, out + blockY * rowBytes + blockX * blockBytes(compression));
+		}
+	});
+}
+
+// ------------------------------------------------------------------------
+inline void decodeImage(const std::uint8_t* blocks, int width, int height, TextureCompression compression, std::uint8_t* rgba)
+{
+	int blocksX = (width + 3) / 4;
+	int blocksY = (height + 3) / 4;
+	std::uint8_t texels[64];
+	for (int blockY = 0; blockY < blocksY; blockY++)
+	{
+		for (int blockX = 0; blockX < blocksX; blockX++)
+		{
+			bc_detail::decodeBlock(blocks + (static_cast<size_t>(blockY) * blocksX + blockX) * blockBytes(compression), compression, texels);
+			for (int y = 0; y < 4 && blockY * 4 + y < height; y++)
+			{
+				for (int x = 0; x < 4 && blockX * 4 + x < width; x++)
+					std::memcpy(rgba + ((static_cast<size_t>(blockY) * 4 + y) * width + blockX * 4 + x) * 4, texels + (y * 4 + x) * 4, 4);
+			}
+		}
+	}
+}
+
+// peak signal-to-noise ratio in dB over the channels the format stores;
+// 99 dB for an exact match
+// ------------------------------------------------------------------------
+inline double psnr(const std::uint8_t* reference, const std::uint8_t* decoded, int width, int height, TextureCompression compression)
+{
+	int channels = compression == COMPRESSION_BC4 ? 1 : compression == COMPRESSION_BC5 ? 2 : compression == COMPRESSION_BC1 ? 3 : 4;
+	double squared = 0.0;
+	size_t count = static_cast<size_t>(width) * height;
+	for (size_t i = 0; i < count; i++)
+	{
+		for (int c = 0; c < channels; c++)
+		{
+			double delta = static_cast<double>(reference[i * 4 + c]) - decoded[i * 4 + c];
+			squared += delta * delta;
+		}
+	}
+	double meanSquared = squared / (count * channels);
+	return meanSquared == 0.0 ? 99.0 : 10.0 * std::log10(255.0 * 255.0 / meanSquared);
+}
+
+// any 8-bit channel count as RGBA8: grey to RGB, grey+alpha to RGB+A
+// ------------------------------------------------------------------------
+inline std::vector<std::uint8_t> expandToRGBA(const std::uint8_t* pixels, int width, int height, int channels)
+{
+	size_t count = static_cast<size_t>(width) * height;
+	std::vector<std::uint8_t> rgba(count * 4);
+	for (size_t i = 0; i < count; i++)
+	{
+		const std::uint8_t* texel = pixels + i * channels;
+		std::uint8_t* target = &rgba[i * 4];
+		switch (channels)
+		{
+		case 1:
+			target[0] = target[1] = target[2] = texel[0];
+			target[3] = 255;
+			break;
+		case 2:
+			target[0] = target[1] = target[2] = texel[0];
+			target[3] = texel[1];
+			break;
+		case 3:
+			target[0] = texel[0];
+			target[1] = texel[1];
+			target[2] = texel[2];
+			target[3] = 255;
+			break;
+		default:
+			std::memcpy(target, texel, 4);
+			break;
+		}
+	}
+	return rgba;
+}
+inline std::vector<std::uint8_t> expandToRGBA(const DecodedImage& image)
+{
+	return expandToRGBA(image.pixels, image.width, image.height, image.channels);
+}
+
+// a mip chain, level 0 first, levels packed back to back. Block-compressed,
+// or with COMPRESSION_NONE plain 8-bit texels of channels channels.
+// ------------------------------------------------------------------------
+struct CompressedImage
+{
+	struct Level
+	{
+		int width;
+		int height;
+		size_t offset;
+		size_t size;
+	};
+
+	TextureCompression compression = COMPRESSION_NONE;
+	int channels = 0;
+	std::vector<Level> levels;
+	std::vector<std::uint8_t> data;
+};
+
+// encodes a mip chain (see generateMips) of 8-bit texels with channels
+// channels; with COMPRESSION_NONE it is copied as is. See encodeImage for
+// the pool.
+// ------------------------------------------------------------------------
+inline CompressedImage compressLevels(const std::vector<MipLevel>& chain, int channels, TextureCompression compression, JobPool* pool = nullptr)
+{
+	CompressedImage compressed;
+	compressed.compression = compression;
+	compressed.channels = channels;
+	bool encode = compression != COMPRESSION_NONE;
+	for (const MipLevel& mip : chain)
+	{
+		size_t size = encode ? compressedSize(compression, mip.width, mip.height) : mip.pixels.size();
+		CompressedImage::Level level{ mip.width, mip.height, compressed.data.size(), size };
+		compressed.data.resize(level.offset + level.size);
+		if (encode)
+		{
+			std::vector<std::uint8_t> rgba = expandToRGBA(mip.pixels.data(), mip.width, mip.height, channels);
+			encodeImage(rgba.data(), mip.width, mip.height, compression, compressed.data.data() + level.offset, pool);
+		}
+		else
+			std::memcpy(compressed.data.data() + level.offset, mip.pixels.data(), size);
+		compressed.levels.push_back(level);
+	}
+	return compressed;
+}
+
+// encodes a decoded image, and when mipmaps is set its mip chain as
+// generateMips filters it; with COMPRESSION_NONE the chain keeps the
+// image's channels. See encodeImage for the pool.
+// ------------------------------------------------------------------------
+inline CompressedImage compressImage(const DecodedImage& image, TextureCompression compression, bool mipmaps, JobPool* pool = nullptr,
+	const MipOptions& mipOptions = MipOptions())
+{
+	if (!image.pixels)
+	{
+		CompressedImage compressed;
+		compressed.compression = compression;
+		compressed.channels = image.channels;
+		return compressed;
+	}
+
+	std::vector<MipLevel> chain;
+	if (mipmaps)
+		chain = generateMips(image.pixels, image.width, image.height, image.channels, mipOptions, pool);
+	else
+		chain.push_back(MipLevel{ image.width, image.height,
+			std::vector<std::uint8_t>(image.pixels, image.pixels + static_cast<size_t>(image.width) * image.height * image.channels) });
+	return compressLevels(chain, image.channels, compression, pool);
+}
+
+// encodes the image at path in every format and prints the PSNR against
+// the source and the throughput, on the calling thread alone and spread
+// over the pool. False when the image does not load.
+// ------------------------------------------------------------------------
+inline bool compressionReport(const std::string& path, JobPool& pool, std::ostream& out)
+{
+	static const char* names[] = { "", "BC1", "BC3", "BC4", "BC5", "BC7" };
+	DecodedImage image = AssetLoader::decode(path, false);
+	if (!image.pixels)
+	{
+		out << "Failed to load texture: " << path << std::endl;
+		return false;
+	}
+	std::vector<std::uint8_t> rgba = expandToRGBA(image);
+	int width = image.width, height = image.height;
+	image.release();
+
+	// per core divides by the threads that could actually run at once
+	unsigned int threads = pool.size() + 1;
+	unsigned int cores = std::min(threads, std::max(1u, std::thread::hardware_concurrency()));
+	double megapixels = static_cast<double>(width) * height / 1.0e6;
+	char line[160];
+	std::snprintf(line, sizeof(line), "%s: %dx%d, %u threads on %u cores\n", path.c_str(), width, height, threads, cores);
+	out << line;
+	std::snprintf(line, sizeof(line), "%-6s %9s %16s %16s %16s\n", "format", "PSNR dB", "1 thread MP/s", "all MP/s", "MP/s per core");
+	out << line;
+	for (int i = 1; i < 6; i++)
+	{
+		TextureCompression compression = static_cast<TextureCompression>(i);
+		std::vector<std::uint8_t> blocks(compressedSize(compression, width, height));
+		std::vector<std::uint8_t> decoded(rgba.size());
+
+		auto start = std::chrono::steady_clock::now();
+		encodeImage(rgba.data(), width, height, compression, blocks.data());
+		double single = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+		start = std::chrono::steady_clock::now();
+		encodeImage(rgba.data(), width, height, compression, blocks.data(), &pool);
+		double parallel = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+		decodeImage(blocks.data(), width, height, compression, decoded.data());
+		std::snprintf(line, sizeof(line), "%-6s %9.2f %16.2f %16.2f %16.2f\n", names[i],
+			psnr(rgba.data(), decoded.data(), width, height, compression),
+			megapixels / single, megapixels / parallel, megapixels / parallel / cores);
+		out << line;
+	}
+	return true;
+}
+#endif
@@ -0,0 +1,387 @@
+#ifndef BENCHMARKS_H
+#define BENCHMARKS_H
+
+#include <glad/glad.h>
+#include <glm/glm.hpp>
+#include <glm/gtc/matrix_transform.hpp>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <ostream>
+#include <random>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "assetloader.h"
+#include "frustumculling.h"
+#include "renderqueue.h"
+#include "shaderinit.h"
+#include "stb_image.h"
+
+// checks and timings behind the headless benchmark options (see
+// headless.h). Only main includes this; the renderer does not need it.
+
+namespace decode_detail
+{
+	// the zlib stream of a PNG file: its IDAT chunks joined; empty for
+	// anything else
+	inline std::vector<unsigned char> pngStream(const std::vector<unsigned char>& file)
+	{
+		static const unsigned char signature[8] = { 137, 80, 78, 71, 13, 10, 26, 10 };
+		std::vector<unsigned char> stream;
+		if (file.size() < 8 || std::memcmp(file.data(), signature, 8) != 0)
+			return stream;
+		size_t at = 8;
+		while (at + 12 <= file.size())
+		{
+			size_t length = (static_cast<size_t>(file[at]) << 24) | (static_cast<size_t>(file[at + 1]) << 16) |
+				(static_cast<size_t>(file[at + 2]) << 8) | file[at + 3];
+			if (length > file.size() - at - 12)
+				break;
+			if (std::memcmp(&file[at + 4], "IDAT", 4) == 0)
+				stream.insert(stream.end(), file.begin() + at + 8, file.begin() + at + 8 + length);
+			at += length + 12;
+		}
+		return stream;
+	}
+
+	// inflates the first length bytes of a zlib stream, with the fast loop
+	// or one symbol at a time; false if stb_image rejects the stream
+	inline bool inflate(const std::vector<unsigned char>& stream, size_t length, bool reference, std::vector<unsigned char>& out)
+	{
+		stbi_set_reference_decode(reference);
+		int size = 0;
+		char* data = stbi_zlib_decode_malloc(reinterpret_cast<const char*>(stream.data()), static_cast<int>(length), &size);
+		stbi_set_reference_decode(0);
+		out.assign(data, data ? data + size : data);
+		stbi_image_free(data);
+		return data != nullptr;
+	}
+
+	// inflates stream both ways and prints a row: both must give the same
+	// bytes, both must reject the stream cut short anywhere in the deflate
+	// data (the last bytes end up in the padded bit buffer), and both must
+	// agree on the stream with a byte damaged
+	inline bool zlibCheck(const std::string& name, const std::vector<unsigned char>& stream, int runs, std::ostream& out)
+	{
+		std::vector<unsigned char> decoded[2];
+		bool inflated[2] = {};
+		double best[2] = { 1e30, 1e30 };
+		for (int run = 0; run < runs; run++)
+		{
+			for (int reference = 0; reference < 2; reference++)
+			{
+				auto start = std::chrono::steady_clock::now();
+				inflated[reference] = inflate(stream, stream.size(), reference != 0, decoded[reference]);
+				best[reference] = std::min(best[reference], std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count());
+			}
+		}
+		bool match = inflated[0] && inflated[1] && decoded[0] == decoded[1];
+
+		// the header is 2 bytes and the Adler-32 checksum, which stb_image
+		// does not check, the last 4
+		bool truncationRejected = true;
+		std::vector<size_t> cuts = { stream.size() / 4, stream.size() / 2 };
+		for (size_t k = 1; k <= 8 && k + 4 < stream.size(); k++)
+			cuts.push_back(stream.size() - 4 - k);
+		std::vector<unsigned char> scratch;
+		for (size_t cut : cuts)
+		{
+			if (cut <= 2 || cut + 4 >= stream.size())
+				continue;
+			for (int reference = 0; reference < 2; reference++)
+				truncationRejected = truncationRejected && !inflate(stream, cut, reference != 0, scratch);
+		}
+
+		bool corruptAgrees = true;
+		const size_t damaged[] = { stream.size() / 3, stream.size() / 2 + 1, stream.size() - 6 };
+		for (size_t at : damaged)
+		{
+			if (at <= 2 || at + 4 >= stream.size())
+				continue;
+			std::vector<unsigned char> corrupt = stream;
+			corrupt[at] ^= 0x55;
+			std::vector<unsigned char> results[2];
+			bool ok0 = inflate(corrupt, corrupt.size(), false, results[0]);
+			bool ok1 = inflate(corrupt, corrupt.size(), true, results[1]);
+			corruptAgrees = corruptAgrees && ok0 == ok1 && results[0] == results[1];
+		}
+
+		double megabytes = static_cast<double>(decoded[1].size()) / 1.0e6;
+		const char* status = !match ? "MISMATCH" : !truncationRejected ? "ACCEPTS TRUNCATED STREAM" :
+			!corruptAgrees ? "DIFFERS ON CORRUPT STREAM" : "matches reference, rejects truncation";
+		char line[200];
+		std::snprintf(line, sizeof(line), "%-28s %14zu %16.1f %16.1f  %s\n", name.c_str(), decoded[1].size(),
+			megabytes / best[1], megabytes / best[0], status);
+		out << line;
+		return match && truncationRejected && corruptAgrees;
+	}
+}
+
+// decodes each file from memory with stb_image's SIMD kernels and with its
+// generic C code (stbi_set_reference_decode), checks that the pixels are
+// identical and prints the decode speed of both. The zlib streams of PNG
+// files, and a small fixed Huffman one, are then inflated with the fast
+// loop and one symbol at a time, whole, truncated and damaged (see
+// decode_detail::zlibCheck). False on any mismatch.
+// ------------------------------------------------------------------------
+inline bool decodeBenchmark(const std::vector<std::string>& paths, std::ostream& out)
+{
+	// best of several runs; the first one also warms the caches
+	const int runs = 10;
+	std::vector<std::pair<std::string, std::vector<unsigned char>>> streams;
+	bool allMatch = true;
+	char line[200];
+	std::snprintf(line, sizeof(line), "decode benchmark: best of %d runs\n", runs);
+	out << line;
+	std::snprintf(line, sizeof(line), "%-28s %14s %16s %16s\n", "file", "size", "reference MB/s", "SIMD MB/s");
+	out << line;
+	for (const std::string& path : paths)
+	{
+		std::vector<unsigned char> file;
+		if (!AssetLoader::readFile(path, file))
+		{
+			out << "Failed to read " << path << std::endl;
+			allMatch = false;
+			continue;
+		}
+		std::vector<unsigned char> stream = decode_detail::pngStream(file);
+		if (!stream.empty())
+			streams.emplace_back(path, std::move(stream));
+		std::vector<unsigned char> decoded[2];
+		int width[2] = {}, height[2] = {}, channels[2] = {};
+		double best[2] = { 1e30, 1e30 };
+		for (int run = 0; run < runs; run++)
+		{
+			for (int reference = 0; reference < 2; reference++)
+			{
+				stbi_set_reference_decode(reference);
+				auto start = std::chrono::steady_clock::now();
+				unsigned char* pixels = stbi_load_from_memory(file.data(), static_cast<int>(file.size()),
+					&width[reference], &height[reference], &channels[reference], 0);
+				best[reference] = std::min(best[reference], std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count());
+				size_t size = pixels ? static_cast<size_t>(width[reference]) * height[reference] * channels[reference] : 0;
+				decoded[reference].assign(pixels, pixels + size);
+				stbi_image_free(pixels);
+			}
+		}
+		stbi_set_reference_decode(0);
+
+		bool loaded = !decoded[0].empty() && !decoded[1].empty();
+		bool match = loaded && width[0] == width[1] && height[0] == height[1] && channels[0] == channels[1] &&
+			decoded[0] == decoded[1];
+		allMatch = allMatch && match;
+		double megabytes = static_cast<double>(decoded[0].size()) / 1.0e6;
+		char size[32];
+		std::snprintf(size, sizeof(size), "%dx%dx%d", width[0], height[0], channels[0]);
+		std::snprintf(line, sizeof(line), "%-28s %14s %16.1f %16.1f  %s\n", path.c_str(), size,
+			megabytes / best[1], megabytes / best[0], !loaded ? "FAILED TO DECODE" : match ? "matches reference" : "MISMATCH");
+		out << line;
+	}
+
+	// "ababa" with the fixed codes; cut after 7 bytes it used to inflate
+	// to garbage, since the missing bits were read as zeros
+	streams.emplace_back("fixed Huffman \"ababa\"", std::vector<unsigned char>{
+		0x78, 0x01, 0x4b, 0x4c, 0x4a, 0x4c, 0x4a, 0x04, 0x00, 0x05, 0xba, 0x01, 0xe8 });
+	std::snprintf(line, sizeof(line), "%-28s %14s %16s %16s\n", "zlib", "bytes", "reference MB/s", "fast MB/s");
+	out << line;
+	for (const auto& stream : streams)
+		allMatch = decode_detail::zlibCheck(stream.first, stream.second, runs, out) && allMatch;
+	return allMatch;
+}
+
+// checks cullSpheres against cullSpheresScalar on count random spheres
+// around a camera, then times both. Returns false if they disagree.
+// ------------------------------------------------------------------------
+inline bool cullBenchmark(size_t count, std::ostream& out)
+{
+	// a fixed seed so every run culls the same scene; about half the
+	// spheres end up visible, and many straddle a plane
+	std::mt19937 random(1234);
+	std::uniform_real_distribution<float> position(-60.0f, 60.0f);
+	std::uniform_real_distribution<float> size(0.05f, 4.0f);
+	SphereBounds bounds;
+	bounds.resize(count);
+	for (size_t i = 0; i < count; i++)
+	{
+		float x = position(random);
+		float y = position(random);
+		float z = position(random);
+		bounds.set(i, glm::vec3(x, y, z), size(random));
+	}
+	glm::mat4 projection = glm::perspective(glm::radians(60.0f), 1.5f, 0.1f, 100.0f);
+	glm::mat4 view = glm::lookAt(glm::vec3(0.0f, 0.0f, 50.0f), glm::vec3(0.0f), glm::vec3(0.0f, 1.0f, 0.0f));
+	Frustum frustum = extractFrustum(projection * view);
+
+	std::vector<std::uint32_t> reference;
+	std::vector<std::uint32_t> visible;
+	reference.reserve(count);
+	visible.reserve(count);
+
+	// best of several runs; the first one also warms the caches
+	const int runs = 10;
+	double scalarTime = 1e30, simdTime = 1e30;
+	for (int run = 0; run < runs; run++)
+	{
+		reference.clear();
+		auto start = std::chrono::steady_clock::now();
+		cullSpheresScalar(frustum, bounds, 0, count, reference);
+		scalarTime = std::min(scalarTime, std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count());
+
+		start = std::chrono::steady_clock::now();
+		cullSpheres(frustum, bounds, visible);
+		simdTime = std::min(simdTime, std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count());
+	}
+
+	bool match = visible == reference;
+#if defined(FRUSTUM_CULLING_AVX2)
+	const char* path = "AVX2";
+#elif defined(FRUSTUM_CULLING_SSE2)
+	const char* path = "SSE2";
+#else
+	const char* path = "scalar";
+#endif
+	char line[160];
+	std::snprintf(line, sizeof(line), "cull benchmark: %zu spheres, %zu visible, best of %d runs\n", count, reference.size(), runs);
+	out << line;
+	std::snprintf(line, sizeof(line), "%-8s %10.3f ms\n", "scalar", scalarTime);
+	out << line;
+	std::snprintf(line, sizeof(line), "%-8s %10.3f ms  %s\n", path, simdTime, match ? "matches scalar" : "MISMATCH");
+	out << line;
+	if (!match)
+	{
+		size_t first = 0;
+		while (first < std::min(visible.size(), reference.size()) && visible[first] == reference[first])
+			first++;
+		out << "first difference at visible index " << first << " (" << visible.size() << " vs " << reference.size() << " visible)" << std::endl;
+	}
+	return match;
+}
+
+// times one uniform update three ways: glGetUniformLocation on every call
+// (what the setters did before the cached table), the cached by-name
+// setter, and a resolved Uniform<T> handle. The program must be current.
+// ------------------------------------------------------------------------
+inline void uniformBenchmark(const Shader& shader, const char* name, unsigned int iterations, std::ostream& out)
+{
+	Uniform<glm::vec3> handle = shader.uniform<glm::vec3>(name);
+	if (!handle.valid())
+	{
+		out << "uniform benchmark: " << name << " is not an active uniform" << std::endl;
+		return;
+	}
+	glm::vec3 value(0.0f);
+	// each call goes to the driver; glFinish keeps queued work out of the next timing
+	auto time = [&](auto&& update)
+	{
+		glFinish();
+		auto start = std::chrono::steady_clock::now();
+		for (unsigned int i = 0; i < iterations; i++)
+		{
+			value.x = static_cast<float>(i);
+			update();
+		}
+		glFinish();
+		return std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count() / iterations;
+	};
+	double query = time([&]() { glUniform3fv(glGetUniformLocation(shader.ID, name), 1, &value[0]); });
+	double cached = time([&]() { shader.setVec3(name, value); });
+	double typed = time([&]() { shader.set(handle, value); });
+
+	char line[160];
+	std::snprintf(line, sizeof(line), "uniform benchmark: %s, %u updates, %zu active uniforms\n", name, iterations, shader.uniforms.size());
+	out << line;
+	std::snprintf(line, sizeof(line), "%-28s %10.1f ns\n", "glGetUniformLocation + set", query);
+	out << line;
+	std::snprintf(line, sizeof(line), "%-28s %10.1f ns\n", "cached table, by name", cached);
+	out << line;
+	std::snprintf(line, sizeof(line), "%-28s %10.1f ns\n", "Uniform<T> handle", typed);
+	out << line;
+}
+
+// times one frame's worth of RenderQueue work: submitting count packets
+// spread over materials, passes and depths, then sorting them
+// ------------------------------------------------------------------------
+inline bool queueBenchmark(size_t count, std::ostream& out)
+{
+	const unsigned int materialCount = 64;
+	const RenderPass passes[] = { PASS_OPAQUE, PASS_SKYBOX, PASS_TRANSPARENT };
+
+	// a fixed seed so every run sorts the same frame
+	std::mt19937 random(1234);
+	std::uniform_real_distribution<float> position(-50.0f, 50.0f);
+	std::uniform_int_distribution<unsigned int> material(0, materialCount - 1);
+	std::uniform_int_distribution<unsigned int> pass(0, 2);
+	std::vector<glm::mat4> transforms(count);
+	std::vector<unsigned char> materials(count), packetPasses(count);
+	for (size_t i = 0; i < count; i++)
+	{
+		float x = position(random);
+		float y = position(random);
+		float z = position(random) - 60.0f;
+		transforms[i] = glm::translate(glm::mat4(1.0f), glm::vec3(x, y, z));
+		materials[i] = static_cast<unsigned char>(material(random));
+		packetPasses[i] = static_cast<unsigned char>(pass(random));
+	}
+
+	RenderQueue queue;
+	for (unsigned int i = 0; i < materialCount; i++)
+		queue.addMaterial(Material());
+	glm::mat4 view = glm::lookAt(glm::vec3(0.0f), glm::vec3(0.0f, 0.0f, -1.0f), glm::vec3(0.0f, 1.0f, 0.0f));
+
+	// best of several runs; the first one also grows the queue's buffers,
+	// as the first frame would
+	const int runs = 10;
+	double submitTime = 1e30, sortTime = 1e30;
+	for (int run = 0; run < runs; run++)
+	{
+		auto start = std::chrono::steady_clock::now();
+		queue.begin(view, 0.1f, 200.0f);
+		// packets are built as they are submitted, as a scene walk would
+		DrawPacket packet;
+		packet.mesh.count = 36;
+		for (size_t i = 0; i < count; i++)
+		{
+			packet.material = materials[i];
+			packet.transform = &transforms[i];
+			packet.pass = passes[packetPasses[i]];
+			queue.submit(packet);
+		}
+		auto submitted = std::chrono::steady_clock::now();
+		queue.sort();
+		auto sorted = std::chrono::steady_clock::now();
+		submitTime = std::min(submitTime, std::chrono::duration<double, std::milli>(submitted - start).count());
+		sortTime = std::min(sortTime, std::chrono::duration<double, std::milli>(sorted - submitted).count());
+	}
+
+	// passes in order and strictly increasing (key, packet) pairs inside a
+	// pass: sorted, stable, and every packet exactly once
+	bool ordered = queue.size() == count;
+	for (size_t i = 0; ordered && i < count; i++)
+	{
+		size_t index = queue.packetIndex(i);
+		ordered = index < count && queue.packet(i).pass == passes[packetPasses[index]];
+		if (!ordered || i == 0)
+			continue;
+		RenderPass previousPass = queue.packet(i - 1).pass, packetPass = queue.packet(i).pass;
+		std::uint32_t previous = queue.sortKey(i - 1), key = queue.sortKey(i);
+		ordered = previousPass < packetPass ||
+			(previousPass == packetPass && (previous < key || (previous == key && queue.packetIndex(i - 1) < index)));
+	}
+
+	char line[160];
+	std::snprintf(line, sizeof(line), "queue benchmark: %zu packets, %u materials, 3 passes, best of %d runs\n", count, materialCount, runs);
+	out << line;
+	std::snprintf(line, sizeof(line), "%-8s %10.3f ms\n", "submit", submitTime);
+	out << line;
+	std::snprintf(line, sizeof(line), "%-8s %10.3f ms\n", "sort", sortTime);
+	out << line;
+	std::snprintf(line, sizeof(line), "%-8s %10.3f ms  %s\n", "total", submitTime + sortTime, ordered ? "in key order" : "NOT IN KEY ORDER");
+	out << line;
+	return ordered;
+}
+#endif
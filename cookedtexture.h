@@ -0,0 +1,556 @@
+#ifndef COOKED_TEXTURE_H
+#define COOKED_TEXTURE_H
+
+#include <glad/glad.h>
+
+#include <algorithm>
+#include <cctype>
+#include <condition_variable>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <mutex>
+#include <ostream>
+#include <string>
+#include <vector>
+
+#if defined(_WIN32)
+// windows.h redefines APIENTRY to the same __stdcall glad gave it
+#undef APIENTRY
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#include <direct.h>
+#else
+#include <dirent.h>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#include "assetloader.h"
+#include "bcencoder.h"
+#include "glstate.h"
+#include "texturestream.h"
+
+// cooked texture file: everything the uploader needs, already in GPU layout,
+// so loading is a map and a copy instead of a decode.
+//
+//   CookedHeader          64 bytes
+//   CookedLevel[levels]   16 bytes each, level 0 first
+//   level data            each level starts on a 64-byte boundary
+//
+// A level holds every image of that size back to back: layer by layer, and
+// within a layer the cube faces in +X, -X, +Y, -Y, +Z, -Z order. Plain
+// texels are tightly packed rows, bottom row first like GL expects; block
+// formats are rows of 4x4 blocks. All fields are little-endian.
+// ------------------------------------------------------------------------
+struct CookedHeader
+{
+	char magic[8];
+	std::uint32_t version;
+	std::uint32_t compression;	// TextureCompression
+	std::uint32_t channels;		// texel channels for COMPRESSION_NONE
+	std::uint32_t width;
+	std::uint32_t height;
+	std::uint32_t layers;		// 0 for a texture that is not an array
+	std::uint32_t faces;		// 1, or 6 for a cube map
+	std::uint32_t levels;
+	std::uint32_t flags;
+	std::uint8_t reserved[20];
+};
+static_assert(sizeof(CookedHeader) == 64, "the cooked header is one 64-byte line");
+
+// ------------------------------------------------------------------------
+struct CookedLevel
+{
+	std::uint64_t offset;	// from the start of the file
+	std::uint64_t size;		// every image of the level
+};
+
+static const char COOKED_MAGIC[8] = { 'C', 'T', 'E', 'X', '\r', '\n', 0x1A, '\n' };
+static const std::uint32_t COOKED_VERSION = 1;
+static const std::uint32_t COOKED_ALIGNMENT = 64;
+static const char* const COOKED_EXTENSION = ".ctex";
+
+// read-only view of a whole file through the virtual memory system
+// ------------------------------------------------------------------------
+class MappedFile
+{
+public:
+	MappedFile() = default;
+	MappedFile(const MappedFile&) = delete;
+	MappedFile& operator=(const MappedFile&) = delete;
+	~MappedFile()
+	{
+		close();
+	}
+
+	// ------------------------------------------------------------------------
+	bool open(const std::string& path)
+	{
+		close();
+#if defined(_WIN32)
+		file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+		if (file == INVALID_HANDLE_VALUE)
+			return false;
+		LARGE_INTEGER fileSize;
+		if (!GetFileSizeEx(file, &fileSize) || fileSize.QuadPart == 0)
+		{
+			close();
+			return false;
+		}
+		mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+		if (mapping)
+			bytes = static_cast<const std::uint8_t*>(MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0));
+		length = static_cast<size_t>(fileSize.QuadPart);
+#else
+		int file = ::open(path.c_str(), O_RDONLY);
+		if (file < 0)
+			return false;
+		struct stat status;
+		if (fstat(file, &status) == 0 && status.st_size > 0)
+		{
+			void* view = mmap(nullptr, static_cast<size_t>(status.st_size), PROT_READ, MAP_PRIVATE, file, 0);
+			if (view != MAP_FAILED)
+			{
+				bytes = static_cast<const std::uint8_t*>(view);
+				length = static_cast<size_t>(status.st_size);
+				// the data is read front to back, once
+				madvise(view, length, MADV_SEQUENTIAL);
+			}
+		}
+		// the mapping keeps the file alive
+		::close(file);
+#endif
+		if (!bytes)
+		{
+			close();
+			return false;
+		}
+		return true;
+	}
+	// ------------------------------------------------------------------------
+	void close()
+	{
+#if defined(_WIN32)
+		if (bytes)
+			UnmapViewOfFile(bytes);
+		if (mapping)
+			CloseHandle(mapping);
+		if (file != INVALID_HANDLE_VALUE)
+			CloseHandle(file);
+		mapping = nullptr;
+		file = INVALID_HANDLE_VALUE;
+#else
+		if (bytes)
+			munmap(const_cast<std::uint8_t*>(bytes), length);
+#endif
+		bytes = nullptr;
+		length = 0;
+	}
+	// ------------------------------------------------------------------------
+	const std::uint8_t* data() const
+	{
+		return bytes;
+	}
+	// ------------------------------------------------------------------------
+	size_t size() const
+	{
+		return length;
+	}
+
+private:
+	const std::uint8_t* bytes = nullptr;
+	size_t length = 0;
+#if defined(_WIN32)
+	HANDLE file = INVALID_HANDLE_VALUE;
+	HANDLE mapping = nullptr;
+#endif
+};
+
+// a validated cooked texture, read straight out of a mapped file (or any
+// memory that outlives it)
+// ------------------------------------------------------------------------
+class CookedTexture
+{
+public:
+	CookedTexture() = default;
+	CookedTexture(const CookedTexture&) = delete;
+	CookedTexture& operator=(const CookedTexture&) = delete;
+
+	// maps the file; false when it is missing or not a valid cooked texture
+	// ------------------------------------------------------------------------
+	bool open(const std::string& path)
+	{
+		return file.open(path) && view(file.data(), file.size());
+	}
+	// ------------------------------------------------------------------------
+	bool view(const std::uint8_t* data, size_t size)
+	{
+		header = nullptr;
+		if (size < sizeof(CookedHeader))
+			return false;
+		const CookedHeader* candidate = reinterpret_cast<const CookedHeader*>(data);
+		if (std::memcmp(candidate->magic, COOKED_MAGIC, sizeof(COOKED_MAGIC)) != 0 || candidate->version != COOKED_VERSION)
+			return false;
+		if (candidate->compression > COMPRESSION_BC7 || candidate->width == 0 || candidate->height == 0 || candidate->levels == 0 ||
+			candidate->levels > 32 || (candidate->faces != 1 && candidate->faces != 6) ||
+			(candidate->compression == COMPRESSION_NONE && (candidate->channels < 1 || candidate->channels > 4)))
+			return false;
+		// cube map arrays are not supported by the uploader
+		if (candidate->faces == 6 && candidate->layers > 0)
+			return false;
+		if (size < sizeof(CookedHeader) + candidate->levels * sizeof(CookedLevel))
+			return false;
+
+		const CookedLevel* levels = reinterpret_cast<const CookedLevel*>(data + sizeof(CookedHeader));
+		header = candidate;
+		table = levels;
+		for (unsigned int level = 0; level < candidate->levels; level++)
+		{
+			if (levels[level].offset % COOKED_ALIGNMENT != 0 || levels[level].offset > size ||
+				levels[level].size != imageSize(level) * images() || levels[level].size > size - levels[level].offset)
+			{
+				header = nullptr;
+				return false;
+			}
+		}
+		bytes = data;
+		return true;
+	}
+	// ------------------------------------------------------------------------
+	void close()
+	{
+		header = nullptr;
+		file.close();
+	}
+
+	bool valid() const
+	{
+		return header != nullptr;
+	}
+	TextureCompression compression() const
+	{
+		return static_cast<TextureCompression>(header->compression);
+	}
+	int channels() const
+	{
+		return static_cast<int>(header->channels);
+	}
+	unsigned int levels() const
+	{
+		return header->levels;
+	}
+	// layers times faces
+	unsigned int images() const
+	{
+		return std::max(1u, header->layers) * header->faces;
+	}
+	int width(unsigned int level) const
+	{
+		return std::max(1, static_cast<int>(header->width >> level));
+	}
+	int height(unsigned int level) const
+	{
+		return std::max(1, static_cast<int>(header->height >> level));
+	}
+	// ------------------------------------------------------------------------
+	GLenum target() const
+	{
+		if (header->faces == 6)
+			return GL_TEXTURE_CUBE_MAP;
+		return header->layers > 0 ? GL_TEXTURE_2D_ARRAY : GL_TEXTURE_2D;
+	}
+	// ------------------------------------------------------------------------
+	size_t imageSize(unsigned int level) const
+	{
+		if (compression() != COMPRESSION_NONE)
+			return compressedSize(compression(), width(level), height(level));
+		return static_cast<size_t>(width(level)) * height(level) * channels();
+	}
+	// ------------------------------------------------------------------------
+	const std::uint8_t* data(unsigned int level, unsigned int image = 0) const
+	{
+		return bytes + table[level].offset + image * imageSize(level);
+	}
+	// ------------------------------------------------------------------------
+	size_t levelSize(unsigned int level) const
+	{
+		return static_cast<size_t>(table[level].size);
+	}
+
+private:
+	MappedFile file;
+	const std::uint8_t* bytes = nullptr;
+	const CookedHeader* header = nullptr;
+	const CookedLevel* table = nullptr;
+};
+
+// gives texture immutable storage and uploads every level from the cooked
+// data, on the GL thread; returns the bytes uploaded. No unpack buffer may
+// be bound.
+// ------------------------------------------------------------------------
+inline size_t uploadCookedTexture(GLuint texture, const CookedTexture& cooked)
+{
+	GLenum target = cooked.target();
+	TextureCompression compression = cooked.compression();
+	GLenum format = compression != COMPRESSION_NONE ? compressedFormat(compression) : internalFormat(cooked.channels());
+	GLsizei levels = static_cast<GLsizei>(cooked.levels());
+	glState().bindTexture(0, target, texture);
+	if (target == GL_TEXTURE_2D_ARRAY)
+		glTexStorage3D(target, levels, format, cooked.width(0), cooked.height(0), cooked.images());
+	else
+		glTexStorage2D(target, levels, format, cooked.width(0), cooked.height(0));
+
+	glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+	size_t bytes = 0;
+	for (unsigned int level = 0; level < cooked.levels(); level++)
+	{
+		GLint mip = static_cast<GLint>(level);
+		int width = cooked.width(level), height = cooked.height(level);
+		GLsizei size = static_cast<GLsizei>(cooked.imageSize(level));
+		if (target == GL_TEXTURE_2D_ARRAY)
+		{
+			if (compression != COMPRESSION_NONE)
+				glCompressedTexSubImage3D(target, mip, 0, 0, 0, width, height, cooked.images(), format,
+					static_cast<GLsizei>(cooked.levelSize(level)), cooked.data(level));
+			else
+				glTexSubImage3D(target, mip, 0, 0, 0, width, height, cooked.images(), pixelFormat(cooked.channels()),
+					GL_UNSIGNED_BYTE, cooked.data(level));
+		}
+		else
+		{
+			for (unsigned int face = 0; face < cooked.images(); face++)
+			{
+				GLenum faceTarget = target == GL_TEXTURE_CUBE_MAP ? GL_TEXTURE_CUBE_MAP_POSITIVE_X + face : target;
+				if (compression != COMPRESSION_NONE)
+					glCompressedTexSubImage2D(faceTarget, mip, 0, 0, width, height, format, size, cooked.data(level, face));
+				else
+					glTexSubImage2D(faceTarget, mip, 0, 0, width, height, pixelFormat(cooked.channels()), GL_UNSIGNED_BYTE,
+						cooked.data(level, face));
+			}
+		}
+		bytes += cooked.levelSize(level);
+	}
+	glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+	return bytes;
+}
+
+// writes images (one per layer and face, all the same size and format) as
+// a cooked texture; layers is 0 unless it is an array
+// ------------------------------------------------------------------------
+inline bool writeCookedTexture(const std::string& path, const std::vector<CompressedImage>& images, unsigned int layers, unsigned int faces)
+{
+	if (images.empty() || images[0].levels.empty())
+		return false;
+	const CompressedImage& first = images[0];
+	CookedHeader header = {};
+	std::memcpy(header.magic, COOKED_MAGIC, sizeof(COOKED_MAGIC));
+	header.version = COOKED_VERSION;
+	header.compression = first.compression;
+	header.channels = static_cast<std::uint32_t>(first.channels);
+	header.width = static_cast<std::uint32_t>(first.levels[0].width);
+	header.height = static_cast<std::uint32_t>(first.levels[0].height);
+	header.layers = layers;
+	header.faces = faces;
+	header.levels = static_cast<std::uint32_t>(first.levels.size());
+
+	auto align = [](std::uint64_t offset) { return (offset + COOKED_ALIGNMENT - 1) / COOKED_ALIGNMENT * COOKED_ALIGNMENT; };
+	std::vector<CookedLevel> table(header.levels);
+	std::uint64_t offset = align(sizeof(CookedHeader) + table.size() * sizeof(CookedLevel));
+	for (unsigned int level = 0; level < header.levels; level++)
+	{
+		table[level].offset = offset;
+		table[level].size = 0;
+		for (const CompressedImage& image : images)
+		{
+			if (image.levels.size() != header.levels || image.compression != first.compression ||
+				image.levels[level].width != first.levels[level].width || image.levels[level].height != first.levels[level].height)
+				return false;
+			table[level].size += image.levels[level].size;
+		}
+		offset = align(offset + table[level].size);
+	}
+
+	std::FILE* file = std::fopen(path.c_str(), "wb");
+	if (!file)
+		return false;
+	static const std::uint8_t padding[COOKED_ALIGNMENT] = {};
+	bool ok = std::fwrite(&header, sizeof(header), 1, file) == 1 &&
+		std::fwrite(table.data(), sizeof(CookedLevel), table.size(), file) == table.size();
+	std::uint64_t written = sizeof(CookedHeader) + table.size() * sizeof(CookedLevel);
+	for (unsigned int level = 0; ok && level < header.levels; level++)
+	{
+		ok = std::fwrite(padding, 1, static_cast<size_t>(table[level].offset - written), file) == table[level].offset - written;
+		for (const CompressedImage& image : images)
+		{
+			const CompressedImage::Level& mip = image.levels[level];
+			ok = ok && std::fwrite(image.data.data() + mip.offset, 1, mip.size, file) == mip.size;
+		}
+		written = table[level].offset + table[level].size;
+	}
+	ok = std::fclose(file) == 0 && ok;
+	return ok;
+}
+
+namespace cook_detail
+{
+	// ------------------------------------------------------------------------
+	inline bool hasSuffix(const std::string& name, const std::string& suffix)
+	{
+		if (name.size() < suffix.size())
+			return false;
+		for (size_t i = 0; i < suffix.size(); i++)
+		{
+			if (std::tolower(static_cast<unsigned char>(name[name.size() - suffix.size() + i])) != suffix[i])
+				return false;
+		}
+		return true;
+	}
+
+	// names in directory, without . and ..; directories get a trailing /
+	inline std::vector<std::string> listDirectory(const std::string& directory)
+	{
+		std::vector<std::string> names;
+#if defined(_WIN32)
+		WIN32_FIND_DATAA found;
+		HANDLE search = FindFirstFileA((directory + "/*").c_str(), &found);
+		if (search == INVALID_HANDLE_VALUE)
+			return names;
+		do
+		{
+			std::string name = found.cFileName;
+			if (name != "." && name != "..")
+				names.push_back((found.dwFileAttributes & FILE_ATTRIBUTE_DIRECTORY) ? name + "/" : name);
+		} while (FindNextFileA(search, &found));
+		FindClose(search);
+#else
+		DIR* dir = opendir(directory.c_str());
+		if (!dir)
+			return names;
+		while (dirent* entry = readdir(dir))
+		{
+			std::string name = entry->d_name;
+			if (name == "." || name == "..")
+				continue;
+			struct stat status;
+			bool isDirectory = stat((directory + "/" + name).c_str(), &status) == 0 && S_ISDIR(status.st_mode);
+			names.push_back(isDirectory ? name + "/" : name);
+		}
+		closedir(dir);
+#endif
+		std::sort(names.begin(), names.end());
+		return names;
+	}
+
+	// ------------------------------------------------------------------------
+	inline void makeDirectory(const std::string& directory)
+	{
+#if defined(_WIN32)
+		_mkdir(directory.c_str());
+#else
+		mkdir(directory.c_str(), 0755);
+#endif
+	}
+}
+
+// the six faces a cube map directory must hold, in GL face order
+static const char* const COOKED_CUBE_FACES[6] = { "right.jpg", "left.jpg", "top.jpg", "bottom.jpg", "front.jpg", "back.jpg" };
+
+// cooked file a source image is converted to: assets/box.png ->
+// assets/cooked/box.png.ctex, and a cube map directory assets/skybox ->
+// assets/cooked/skybox.ctex
+// ------------------------------------------------------------------------
+inline std::string cookedPath(const std::string& source)
+{
+	std::string path = source;
+	if (!path.empty() && path.back() == '/')
+		path.pop_back();
+	size_t slash = path.find_last_of("/\\");
+	std::string directory = slash == std::string::npos ? "" : path.substr(0, slash + 1);
+	std::string name = slash == std::string::npos ? path : path.substr(slash + 1);
+	return directory + "cooked/" + name + COOKED_EXTENSION;
+}
+
+// the cooked file for source if it has been cooked, else source itself
+// ------------------------------------------------------------------------
+inline std::string preferCooked(const std::string& source)
+{
+	std::string cooked = cookedPath(source);
+	std::FILE* file = std::fopen(cooked.c_str(), "rb");
+	if (!file)
+		return source;
+	std::fclose(file);
+	return cooked;
+}
+
+// converts every PNG and JPEG in sourceDirectory, and every subdirectory
+// holding the six COOKED_CUBE_FACES, into sourceDirectory/cooked. 2D images
+// are flipped the way the texture cache loads them, cube faces are not.
+// Mips use filter, and keep their alpha-test coverage on cutout images.
+// Each image is its own job on the pool; returns the number of failures.
+// ------------------------------------------------------------------------
+inline unsigned int cookDirectory(const std::string& sourceDirectory, TextureCompression compression, MipFilter filter, JobPool& pool,
+	std::ostream& out)
+{
+	std::string outDirectory = sourceDirectory + "/cooked";
+	cook_detail::makeDirectory(outDirectory);
+
+	std::mutex mutex;
+	std::condition_variable done;
+	unsigned int submitted = 0, finished = 0, failures = 0;
+	auto cook = [&, compression, filter](std::vector<std::string> sources, std::string target, bool flip)
+	{
+		std::vector<CompressedImage> images;
+		bool ok = true;
+		for (const std::string& source : sources)
+		{
+			DecodedImage image = AssetLoader::decode(source, flip);
+			MipOptions mipOptions;
+			mipOptions.filter = filter;
+			if (image.pixels && isAlphaCutout(image.pixels, image.width, image.height, image.channels))
+				mipOptions.alphaCutoff = 0.5f;
+			images.push_back(compressImage(image, compression, true, nullptr, mipOptions));
+			ok = ok && image.pixels;
+			image.release();
+		}
+		unsigned int faces = static_cast<unsigned int>(sources.size());
+		ok = ok && writeCookedTexture(target, images, 0, faces);
+		std::lock_guard<std::mutex> lock(mutex);
+		out << (ok ? "Cooked " : "Failed to cook ") << target << std::endl;
+		failures += ok ? 0 : 1;
+		finished++;
+		done.notify_one();
+	};
+
+	for (const std::string& name : cook_detail::listDirectory(sourceDirectory))
+	{
+		std::string source = sourceDirectory + "/" + name;
+		if (name.back() == '/')
+		{
+			std::vector<std::string> entries = cook_detail::listDirectory(source);
+			std::vector<std::string> faces;
+			for (const char* face : COOKED_CUBE_FACES)
+			{
+				if (std::find(entries.begin(), entries.end(), face) != entries.end())
+					faces.push_back(source + face);
+			}
+			if (faces.size() != 6)
+				continue;
+			submitted++;
+			pool.submit([=] { cook(faces, cookedPath(source), false); });
+		}
+		else if (cook_detail::hasSuffix(name, ".png") || cook_detail::hasSuffix(name, ".jpg") || cook_detail::hasSuffix(name, ".jpeg"))
+		{
+			submitted++;
+			pool.submit([=] { cook(std::vector<std::string>{ source }, cookedPath(source), true); });
+		}
+	}
+
+	std::unique_lock<std::mutex> lock(mutex);
+	done.wait(lock, [&] { return finished == submitted; });
+	return failures;
+}
+#endif
@@ -0,0 +1,62 @@
+#ifndef FIXED_TIMESTEP_H
+#define FIXED_TIMESTEP_H
+
+#include <algorithm>
+
+// turns variable frame times into a whole number of fixed simulation ticks.
+// Leftover time carries over to the next frame and alpha() gives how far the
+// render time is between the last two ticks, for interpolating state.
+class FixedTimestep
+{
+public:
+	// seconds per tick
+	double step;
+	// upper bound on ticks per frame; time beyond it is dropped so one slow
+	// frame cannot snowball into ever longer catch-up frames
+	unsigned int maxStepsPerFrame;
+	// scales real time; above 1 simulates faster than real time
+	double timeScale = 1.0;
+
+	// ------------------------------------------------------------------------
+	FixedTimestep(double ticksPerSecond = 60.0, unsigned int maxSteps = 8)
+		: step(1.0 / ticksPerSecond), maxStepsPerFrame(maxSteps)
+	{
+	}
+	// ------------------------------------------------------------------------
+	void setTickRate(double ticksPerSecond)
+	{
+		step = 1.0 / ticksPerSecond;
+	}
+	// adds a frame's elapsed time and returns how many ticks to run now
+	// ------------------------------------------------------------------------
+	unsigned int advance(double frameTime)
+	{
+		accumulator += std::max(frameTime, 0.0) * timeScale;
+		unsigned int steps = static_cast<unsigned int>(accumulator / step);
+		if (steps > maxStepsPerFrame)
+		{
+			steps = maxStepsPerFrame;
+			droppedTime += accumulator - steps * step;
+			accumulator = steps * step;
+		}
+		accumulator -= steps * step;
+		return steps;
+	}
+	// interpolation factor between the previous and current tick, in [0, 1)
+	// ------------------------------------------------------------------------
+	float alpha() const
+	{
+		return static_cast<float>(accumulator / step);
+	}
+	// total simulation time given up to the catch-up cap
+	// ------------------------------------------------------------------------
+	double dropped() const
+	{
+		return droppedTime;
+	}
+
+private:
+	double accumulator = 0.0;
+	double droppedTime = 0.0;
+};
+#endif
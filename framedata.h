@@ -0,0 +1,91 @@
+#ifndef FRAME_DATA_H
+#define FRAME_DATA_H
+
+#include <glad/glad.h>
+#include <glm/glm.hpp>
+
+#include <cstring>
+
+// binding point of the FrameData block in shader.vs and skyboxshader.vs
+const GLuint FRAME_DATA_BINDING = 0;
+
+// per-frame constants, std140 layout of the FrameData uniform block
+// ------------------------------------------------------------------------
+struct FrameData
+{
+	glm::mat4 view;
+	glm::mat4 projection;
+	glm::mat4 viewProjection;
+	glm::mat4 skyboxView;		// view with the translation removed
+	glm::vec3 cameraPos;
+	float time;
+};
+static_assert(sizeof(FrameData) == 4 * 64 + 16, "FrameData must match the std140 block layout");
+
+// ring of FrameData slots in one persistently mapped UBO. Each frame writes
+// the next slot and binds it at FRAME_DATA_BINDING, so the CPU never
+// overwrites data a frame still in flight is reading.
+class FrameDataBuffer
+{
+public:
+	static const unsigned int RING_SIZE = 3;
+	unsigned int UBO = 0;
+
+	// ------------------------------------------------------------------------
+	void init()
+	{
+		GLint alignment = 256;
+		glGetIntegerv(GL_UNIFORM_BUFFER_OFFSET_ALIGNMENT, &alignment);
+		slotSize = (sizeof(FrameData) + alignment - 1) / alignment * alignment;
+
+		GLbitfield flags = GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+		glGenBuffers(1, &UBO);
+		glBindBuffer(GL_UNIFORM_BUFFER, UBO);
+		glBufferStorage(GL_UNIFORM_BUFFER, slotSize * RING_SIZE, nullptr, flags);
+		mapped = static_cast<unsigned char*>(glMapBufferRange(GL_UNIFORM_BUFFER, 0, slotSize * RING_SIZE, flags));
+		glBindBuffer(GL_UNIFORM_BUFFER, 0);
+	}
+	// copies this frame's constants into the next free slot and binds it
+	// ------------------------------------------------------------------------
+	void update(const FrameData& data)
+	{
+		slot = (slot + 1) % RING_SIZE;
+		if (fences[slot])
+		{
+			// only blocks when the GPU is more than RING_SIZE frames behind
+			glClientWaitSync(fences[slot], GL_SYNC_FLUSH_COMMANDS_BIT, GL_TIMEOUT_IGNORED);
+			glDeleteSync(fences[slot]);
+			fences[slot] = 0;
+		}
+		std::memcpy(mapped + slot * slotSize, &data, sizeof(FrameData));
+		glBindBufferRange(GL_UNIFORM_BUFFER, FRAME_DATA_BINDING, UBO, slot * slotSize, sizeof(FrameData));
+	}
+	// call once the frame's draws are submitted
+	// ------------------------------------------------------------------------
+	void endFrame()
+	{
+		fences[slot] = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+	}
+	// ------------------------------------------------------------------------
+	void release()
+	{
+		for (GLsync& fence : fences)
+		{
+			if (fence)
+				glDeleteSync(fence);
+			fence = 0;
+		}
+		glBindBuffer(GL_UNIFORM_BUFFER, UBO);
+		glUnmapBuffer(GL_UNIFORM_BUFFER);
+		glBindBuffer(GL_UNIFORM_BUFFER, 0);
+		glDeleteBuffers(1, &UBO);
+		mapped = nullptr;
+	}
+
+private:
+	unsigned char* mapped = nullptr;
+	GLsizeiptr slotSize = 0;
+	unsigned int slot = 0;
+	GLsync fences[RING_SIZE] = {};
+};
+#endif
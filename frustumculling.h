@@ -0,0 +1,174 @@
+#ifndef FRUSTUM_CULLING_H
+#define FRUSTUM_CULLING_H
+
+#include <glm/glm.hpp>
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#if defined(__AVX2__)
+#define FRUSTUM_CULLING_AVX2
+#include <immintrin.h>
+#elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define FRUSTUM_CULLING_SSE2
+#include <emmintrin.h>
+#endif
+
+// six normalized planes (xyz = normal pointing inside, w = distance)
+// ------------------------------------------------------------------------
+struct Frustum
+{
+	glm::vec4 planes[6];
+};
+
+// Gribb/Hartmann plane extraction from a projection * view matrix
+// ------------------------------------------------------------------------
+inline Frustum extractFrustum(const glm::mat4& viewProjection)
+{
+	glm::vec4 rows[4];
+	for (int i = 0; i < 4; i++)
+		rows[i] = glm::vec4(viewProjection[0][i], viewProjection[1][i], viewProjection[2][i], viewProjection[3][i]);
+
+	Frustum frustum;
+	frustum.planes[0] = rows[3] + rows[0];	// left
+	frustum.planes[1] = rows[3] - rows[0];	// right
+	frustum.planes[2] = rows[3] + rows[1];	// bottom
+	frustum.planes[3] = rows[3] - rows[1];	// top
+	frustum.planes[4] = rows[3] + rows[2];	// near
+	frustum.planes[5] = rows[3] - rows[2];	// far
+	for (glm::vec4& plane : frustum.planes)
+		plane /= glm::length(glm::vec3(plane));
+	return frustum;
+}
+
+// bounding spheres in structure-of-arrays layout, one lane per object
+// ------------------------------------------------------------------------
+struct SphereBounds
+{
+	std::vector<float> x;
+	std::vector<float> y;
+	std::vector<float> z;
+	std::vector<float> radius;
+
+	void resize(size_t count)
+	{
+		x.resize(count);
+		y.resize(count);
+		z.resize(count);
+		radius.resize(count);
+	}
+	size_t size() const
+	{
+		return x.size();
+	}
+	void set(size_t i, const glm::vec3& center, float r)
+	{
+		x[i] = center.x;
+		y[i] = center.y;
+		z[i] = center.z;
+		radius[i] = r;
+	}
+};
+
+// reference implementation, one sphere at a time
+// ------------------------------------------------------------------------
+inline void cullSpheresScalar(const Frustum& frustum, const SphereBounds& bounds, size_t begin, size_t end, std::vector<std::uint32_t>& visible)
+{
+	for (size_t i = begin; i < end; i++)
+	{
+		bool inside = true;
+		for (const glm::vec4& plane : frustum.planes)
+		{
+			float distance = plane.x * bounds.x[i] + plane.y * bounds.y[i];
+			distance = distance + plane.z * bounds.z[i] + plane.w;
+			if (distance < -bounds.radius[i])
+			{
+				inside = false;
+				break;
+			}
+		}
+		if (inside)
+			visible.push_back(static_cast<std::uint32_t>(i));
+	}
+}
+
+// writes the indices of every sphere that touches the frustum to visible,
+// in ascending order. Tests 8 spheres per iteration with AVX2, 4 with SSE2.
+// ------------------------------------------------------------------------
+inline void cullSpheres(const Frustum& frustum, const SphereBounds& bounds, std::vector<std::uint32_t>& visible)
+{
+	size_t count = bounds.size();
+	visible.resize(count);
+	std::uint32_t* out = visible.data();
+	size_t i = 0;
+
+#if defined(FRUSTUM_CULLING_AVX2)
+	__m256 planeX[6], planeY[6], planeZ[6], planeW[6];
+	for (int p = 0; p < 6; p++)
+	{
+		planeX[p] = _mm256_set1_ps(frustum.planes[p].x);
+		planeY[p] = _mm256_set1_ps(frustum.planes[p].y);
+		planeZ[p] = _mm256_set1_ps(frustum.planes[p].z);
+		planeW[p] = _mm256_set1_ps(frustum.planes[p].w);
+	}
+	const __m256 signMask = _mm256_set1_ps(-0.0f);
+	for (; i + 8 <= count; i += 8)
+	{
+		__m256 x = _mm256_loadu_ps(&bounds.x[i]);
+		__m256 y = _mm256_loadu_ps(&bounds.y[i]);
+		__m256 z = _mm256_loadu_ps(&bounds.z[i]);
+		__m256 negRadius = _mm256_xor_ps(_mm256_loadu_ps(&bounds.radius[i]), signMask);
+		__m256 inside = _mm256_castsi256_ps(_mm256_set1_epi32(-1));
+		for (int p = 0; p < 6; p++)
+		{
+			// same association as the scalar path so both agree on edge cases
+			__m256 distance = _mm256_add_ps(_mm256_mul_ps(planeX[p], x), _mm256_mul_ps(planeY[p], y));
+			distance = _mm256_add_ps(_mm256_add_ps(distance, _mm256_mul_ps(planeZ[p], z)), planeW[p]);
+			inside = _mm256_and_ps(inside, _mm256_cmp_ps(distance, negRadius, _CMP_GE_OQ));
+		}
+		// branchless compaction: always store, only advance for visible lanes
+		int mask = _mm256_movemask_ps(inside);
+		for (int lane = 0; lane < 8; lane++)
+		{
+			*out = static_cast<std::uint32_t>(i + lane);
+			out += (mask >> lane) & 1;
+		}
+	}
+#elif defined(FRUSTUM_CULLING_SSE2)
+	__m128 planeX[6], planeY[6], planeZ[6], planeW[6];
+	for (int p = 0; p < 6; p++)
+	{
+		planeX[p] = _mm_set1_ps(frustum.planes[p].x);
+		planeY[p] = _mm_set1_ps(frustum.planes[p].y);
+		planeZ[p] = _mm_set1_ps(frustum.planes[p].z);
+		planeW[p] = _mm_set1_ps(frustum.planes[p].w);
+	}
+	const __m128 signMask = _mm_set1_ps(-0.0f);
+	for (; i + 4 <= count; i += 4)
+	{
+		__m128 x = _mm_loadu_ps(&bounds.x[i]);
+		__m128 y = _mm_loadu_ps(&bounds.y[i]);
+		__m128 z = _mm_loadu_ps(&bounds.z[i]);
+		__m128 negRadius = _mm_xor_ps(_mm_loadu_ps(&bounds.radius[i]), signMask);
+		__m128 inside = _mm_castsi128_ps(_mm_set1_epi32(-1));
+		for (int p = 0; p < 6; p++)
+		{
+			__m128 distance = _mm_add_ps(_mm_mul_ps(planeX[p], x), _mm_mul_ps(planeY[p], y));
+			distance = _mm_add_ps(_mm_add_ps(distance, _mm_mul_ps(planeZ[p], z)), planeW[p]);
+			inside = _mm_and_ps(inside, _mm_cmpge_ps(distance, negRadius));
+		}
+		// branchless compaction: always store, only advance for visible lanes
+		int mask = _mm_movemask_ps(inside);
+		for (int lane = 0; lane < 4; lane++)
+		{
+			*out = static_cast<std::uint32_t>(i + lane);
+			out += (mask >> lane) & 1;
+		}
+	}
+#endif
+
+	visible.resize(out - visible.data());
+	cullSpheresScalar(frustum, bounds, i, count, visible);
+}
+#endif
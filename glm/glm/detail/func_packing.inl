@@ -3,6 +3,98 @@
 
 #include "../common.hpp"
 #include "type_half.hpp"
+#include <limits>
+
+namespace glm{
+namespace detail
+{
+	// Component wise conversions of count values, used by the bulk functions of GLM_GTC_packing
+
+	template<typename T>
+	GLM_FUNC_QUALIFIER void pack_half_scalar(T const* v, unsigned short* p, std::size_t first, std::size_t count)
+	{
+		for(std::size_t i = first; i < count; ++i)
+			p[i] = static_cast<unsigned short>(toFloat16(v[i]));
+	}
+
+	template<typename T>
+	GLM_FUNC_QUALIFIER void unpack_half_scalar(unsigned short const* p, T* v, std::size_t first, std::size_t count)
+	{
+		for(std::size_t i = first; i < count; ++i)
+			v[i] = toFloat32(static_cast<hdata>(p[i]));
+	}
+
+	template<typename uintType, typename floatType>
+	GLM_FUNC_QUALIFIER void pack_unorm_scalar(floatType const* v, uintType* p, std::size_t first, std::size_t count)
+	{
+		for(std::size_t i = first; i < count; ++i)
+			p[i] = static_cast<uintType>(round(clamp(v[i], static_cast<floatType>(0), static_cast<floatType>(1)) * static_cast<floatType>(std::numeric_limits<uintType>::max())));
+	}
+
+	template<typename uintType, typename floatType>
+	GLM_FUNC_QUALIFIER void unpack_unorm_scalar(uintType const* p, floatType* v, std::size_t first, std::size_t count)
+	{
+		for(std::size_t i = first; i < count; ++i)
+			v[i] = static_cast<floatType>(p[i]) * (static_cast<floatType>(1) / static_cast<floatType>(std::numeric_limits<uintType>::max()));
+	}
+
+	template<typename intType, typename floatType>
+	GLM_FUNC_QUALIFIER void pack_snorm_scalar(floatType const* v, intType* p, std::size_t first, std::size_t count)
+	{
+		for(std::size_t i = first; i < count; ++i)
+			p[i] = static_cast<intType>(round(clamp(v[i], static_cast<floatType>(-1), static_cast<floatType>(1)) * static_cast<floatType>(std::numeric_limits<intType>::max())));
+	}
+
+	template<typename intType, typename floatType>
+	GLM_FUNC_QUALIFIER void unpack_snorm_scalar(intType const* p, floatType* v, std::size_t first, std::size_t count)
+	{
+		for(std::size_t i = first; i < count; ++i)
+			v[i] = clamp(static_cast<floatType>(p[i]) * (static_cast<floatType>(1) / static_cast<floatType>(std::numeric_limits<intType>::max())), static_cast<floatType>(-1), static_cast<floatType>(1));
+	}
+
+	template<typename T>
+	struct compute_half_batch
+	{
+		GLM_FUNC_QUALIFIER static void pack(T const* v, unsigned short* p, std::size_t count)
+		{
+			pack_half_scalar(v, p, 0, count);
+		}
+
+		GLM_FUNC_QUALIFIER static void unpack(unsigned short const* p, T* v, std::size_t count)
+		{
+			unpack_half_scalar(p, v, 0, count);
+		}
+	};
+
+	template<typename uintType, typename floatType>
+	struct compute_unorm_batch
+	{
+		GLM_FUNC_QUALIFIER static void pack(floatType const* v, uintType* p, std::size_t count)
+		{
+			pack_unorm_scalar(v, p, 0, count);
+		}
+
+		GLM_FUNC_QUALIFIER static void unpack(uintType const* p, floatType* v, std::size_t count)
+		{
+			unpack_unorm_scalar(p, v, 0, count);
+		}
+	};
+
+	template<typename intType, typename floatType>
+	struct compute_snorm_batch
+	{
+		GLM_FUNC_QUALIFIER static void pack(floatType const* v, intType* p, std::size_t count)
+		{
+			pack_snorm_scalar(v, p, 0, count);
+		}
+
+		GLM_FUNC_QUALIFIER static void unpack(intType const* p, floatType* v, std::size_t count)
+		{
+			unpack_snorm_scalar(p, v, 0, count);
+		}
+	};
+}//namespace detail
+}//namespace glm
 
 namespace glm
 {
@@ -1,6 +1,246 @@
+/// @ref core
+/// @file glm/detail/func_packing_simd.inl
+
+#include "../simd/packing.h"
+#include <cstring>
+
+#if GLM_ARCH & GLM_ARCH_SSE2_BIT
+
 namespace glm{
 namespace detail
 {
+#	if GLM_CONFIG_HALF_F16C == GLM_ENABLE
+	// Rounds halfway cases to even and quiets NaNs, tails included, see GLM_FORCE_HALF_F16C
+	template<>
+	struct compute_half_batch<float>
+	{
+		GLM_FUNC_QUALIFIER static void pack(float const* v, unsigned short* p, std::size_t count)
+		{
+			std::size_t i = 0;
+			for(; i + 8 <= count; i += 8)
+				_mm_storeu_si128(reinterpret_cast<glm_ivec4*>(p + i), _mm256_cvtps_ph(_mm256_loadu_ps(v + i), _MM_FROUND_TO_NEAREST_INT));
+
+			if(i < count)
+			{
+				float In[8] = {0};
+				unsigned short Out[8];
+				std::memcpy(In, v + i, (count - i) * sizeof(float));
+				_mm_storeu_si128(reinterpret_cast<glm_ivec4*>(Out), _mm256_cvtps_ph(_mm256_loadu_ps(In), _MM_FROUND_TO_NEAREST_INT));
+				std::memcpy(p + i, Out, (count - i) * sizeof(unsigned short));
+			}
+		}
+
+		GLM_FUNC_QUALIFIER static void unpack(unsigned short const* p, float* v, std::size_t count)
+		{
+			std::size_t i = 0;
+			for(; i + 8 <= count; i += 8)
+				_mm256_storeu_ps(v + i, _mm256_cvtph_ps(_mm_loadu_si128(reinterpret_cast<glm_ivec4 const*>(p + i))));
+
+			if(i < count)
+			{
+				unsigned short In[8] = {0};
+				float Out[8];
+				std::memcpy(In, p + i, (count - i) * sizeof(unsigned short));
+				_mm256_storeu_ps(Out, _mm256_cvtph_ps(_mm_loadu_si128(reinterpret_cast<glm_ivec4 const*>(In))));
+				std::memcpy(v + i, Out, (count - i) * sizeof(float));
+			}
+		}
+	};
+#	else
+	template<>
+	struct compute_half_batch<float>
+	{
+		GLM_FUNC_QUALIFIER static void pack(float const* v, unsigned short* p, std::size_t count)
+		{
+			std::size_t i = 0;
+			for(; i + 8 <= count; i += 8)
+			{
+				glm_ivec4 const a = glm_vec4_pack_half(_mm_loadu_ps(v + i));
+				glm_ivec4 const b = glm_vec4_pack_half(_mm_loadu_ps(v + i + 4));
+				_mm_storeu_si128(reinterpret_cast<glm_ivec4*>(p + i), glm_ivec4_pack_u16(a, b));
+			}
+
+			pack_half_scalar(v, p, i, count);
+		}
+
+		GLM_FUNC_QUALIFIER static void unpack(unsigned short const* p, float* v, std::size_t count)
+		{
+			glm_ivec4 const zero = _mm_setzero_si128();
+
+			std::size_t i = 0;
+			for(; i + 8 <= count; i += 8)
+			{
+				glm_ivec4 const h = _mm_loadu_si128(reinterpret_cast<glm_ivec4 const*>(p + i));
+				_mm_storeu_ps(v + i, glm_vec4_unpack_half(_mm_unpacklo_epi16(h, zero)));
+				_mm_storeu_ps(v + i + 4, glm_vec4_unpack_half(_mm_unpackhi_epi16(h, zero)));
+			}
+
+			unpack_half_scalar(p, v, i, count);
+		}
+	};
+#	endif//GLM_CONFIG_HALF_F16C
+
+	template<>
+	struct compute_unorm_batch<unsigned char, float>
+	{
+		GLM_FUNC_QUALIFIER static void pack(float const* v, unsigned char* p, std::size_t count)
+		{
+			glm_vec4 const scale = _mm_set1_ps(255.0f);
+
+			std::size_t i = 0;
+			for(; i + 16 <= count; i += 16)
+			{
+				glm_ivec4 const a = glm_vec4_pack_unorm(_mm_loadu_ps(v + i), scale);
+				glm_ivec4 const b = glm_vec4_pack_unorm(_mm_loadu_ps(v + i + 4), scale);
+				glm_ivec4 const c = glm_vec4_pack_unorm(_mm_loadu_ps(v + i + 8), scale);
+				glm_ivec4 const d = glm_vec4_pack_unorm(_mm_loadu_ps(v + i + 12), scale);
+				_mm_storeu_si128(reinterpret_cast<glm_ivec4*>(p + i), _mm_packus_epi16(_mm_packs_epi32(a, b), _mm_packs_epi32(c, d)));
+			}
+
+			pack_unorm_scalar(v, p, i, count);
+		}
+
+		GLM_FUNC_QUALIFIER static void unpack(unsigned char const* p, float* v, std::size_t count)
+		{
+			glm_vec4 const scale = _mm_set1_ps(1.0f / 255.0f);
+			glm_ivec4 const zero = _mm_setzero_si128();
+
+			std::size_t i = 0;
+			for(; i + 16 <= count; i += 16)
+			{
+				glm_ivec4 const x = _mm_loadu_si128(reinterpret_cast<glm_ivec4 const*>(p + i));
+				glm_ivec4 const lo = _mm_unpacklo_epi8(x, zero);
+				glm_ivec4 const hi = _mm_unpackhi_epi8(x, zero);
+				_mm_storeu_ps(v + i, _mm_mul_ps(_mm_cvtepi32_ps(_mm_unpacklo_epi16(lo, zero)), scale));
+				_mm_storeu_ps(v + i + 4, _mm_mul_ps(_mm_cvtepi32_ps(_mm_unpackhi_epi16(lo, zero)), scale));
+				_mm_storeu_ps(v + i + 8, _mm_mul_ps(_mm_cvtepi32_ps(_mm_unpacklo_epi16(hi, zero)), scale));
+				_mm_storeu_ps(v + i + 12, _mm_mul_ps(_mm_cvtepi32_ps(_mm_unpackhi_epi16(hi, zero)), scale));
+			}
+
+			unpack_unorm_scalar(p, v, i, count);
+		}
+	};
+
+	template<>
+	struct compute_unorm_batch<unsigned short, float>
+	{
+		GLM_FUNC_QUALIFIER static void pack(float const* v, unsigned short* p, std::size_t count)
+		{
+			glm_vec4 const scale = _mm_set1_ps(65535.0f);
 
+			std::size_t i = 0;
+			for(; i + 8 <= count; i += 8)
+			{
+				glm_ivec4 const a = glm_vec4_pack_unorm(_mm_loadu_ps(v + i), scale);
+				glm_ivec4 const b = glm_vec4_pack_unorm(_mm_loadu_ps(v + i + 4), scale);
+				_mm_storeu_si128(reinterpret_cast<glm_ivec4*>(p + i), glm_ivec4_pack_u16(a, b));
+			}
+
+			pack_unorm_scalar(v, p, i, count);
+		}
+
+		GLM_FUNC_QUALIFIER static void unpack(unsigned short const* p, float* v, std::size_t count)
+		{
+			glm_vec4 const scale = _mm_set1_ps(1.0f / 65535.0f);
+			glm_ivec4 const zero = _mm_setzero_si128();
+
+			std::size_t i = 0;
+			for(; i + 8 <= count; i += 8)
+			{
+				glm_ivec4 const x = _mm_loadu_si128(reinterpret_cast<glm_ivec4 const*>(p + i));
+				_mm_storeu_ps(v + i, _mm_mul_ps(_mm_cvtepi32_ps(_mm_unpacklo_epi16(x, zero)), scale));
+				_mm_storeu_ps(v + i + 4, _mm_mul_ps(_mm_cvtepi32_ps(_mm_unpackhi_epi16(x, zero)), scale));
+			}
+
+			unpack_unorm_scalar(p, v, i, count);
+		}
+	};
+
+	template<>
+	struct compute_snorm_batch<signed char, float>
+	{
+		GLM_FUNC_QUALIFIER static void pack(float const* v, signed char* p, std::size_t count)
+		{
+			glm_vec4 const scale = _mm_set1_ps(127.0f);
+
+			std::size_t i = 0;
+			for(; i + 16 <= count; i += 16)
+			{
+				glm_ivec4 const a = glm_vec4_pack_snorm(_mm_loadu_ps(v + i), scale);
+				glm_ivec4 const b = glm_vec4_pack_snorm(_mm_loadu_ps(v + i + 4), scale);
+				glm_ivec4 const c = glm_vec4_pack_snorm(_mm_loadu_ps(v + i + 8), scale);
+				glm_ivec4 const d = glm_vec4_pack_snorm(_mm_loadu_ps(v + i + 12), scale);
+				_mm_storeu_si128(reinterpret_cast<glm_ivec4*>(p + i), _mm_packs_epi16(_mm_packs_epi32(a, b), _mm_packs_epi32(c, d)));
+			}
+
+			pack_snorm_scalar(v, p, i, count);
+		}
+
+		GLM_FUNC_QUALIFIER static void unpack(signed char const* p, float* v, std::size_t count)
+		{
+			glm_vec4 const scale = _mm_set1_ps(1.0f / 127.0f);
+			glm_vec4 const minusOne = _mm_set1_ps(-1.0f);
+			glm_vec4 const one = _mm_set1_ps(1.0f);
+
+			std::size_t i = 0;
+			for(; i + 16 <= count; i += 16)
+			{
+				// Sign extends by placing the bytes in the high part of the 16 then 32 bit lanes
+				glm_ivec4 const x = _mm_loadu_si128(reinterpret_cast<glm_ivec4 const*>(p + i));
+				glm_ivec4 const lo = _mm_srai_epi16(_mm_unpacklo_epi8(x, x), 8);
+				glm_ivec4 const hi = _mm_srai_epi16(_mm_unpackhi_epi8(x, x), 8);
+				glm_vec4 const a = _mm_cvtepi32_ps(_mm_srai_epi32(_mm_unpacklo_epi16(lo, lo), 16));
+				glm_vec4 const b = _mm_cvtepi32_ps(_mm_srai_epi32(_mm_unpackhi_epi16(lo, lo), 16));
+				glm_vec4 const c = _mm_cvtepi32_ps(_mm_srai_epi32(_mm_unpacklo_epi16(hi, hi), 16));
+				glm_vec4 const d = _mm_cvtepi32_ps(_mm_srai_epi32(_mm_unpackhi_epi16(hi, hi), 16));
+				_mm_storeu_ps(v + i, _mm_min_ps(_mm_max_ps(_mm_mul_ps(a, scale), minusOne), one));
+				_mm_storeu_ps(v + i + 4, _mm_min_ps(_mm_max_ps(_mm_mul_ps(b, scale), minusOne), one));
+				_mm_storeu_ps(v + i + 8, _mm_min_ps(_mm_max_ps(_mm_mul_ps(c, scale), minusOne), one));
+				_mm_storeu_ps(v + i + 12, _mm_min_ps(_mm_max_ps(_mm_mul_ps(d, scale), minusOne), one));
+			}
+
+			unpack_snorm_scalar(p, v, i, count);
+		}
+	};
+
+	template<>
+	struct compute_snorm_batch<short, float>
+	{
+		GLM_FUNC_QUALIFIER static void pack(float const* v, short* p, std::size_t count)
+		{
+			glm_vec4 const scale = _mm_set1_ps(32767.0f);
+
+			std::size_t i = 0;
+			for(; i + 8 <= count; i += 8)
+			{
+				glm_ivec4 const a = glm_vec4_pack_snorm(_mm_loadu_ps(v + i), scale);
+				glm_ivec4 const b = glm_vec4_pack_snorm(_mm_loadu_ps(v + i + 4), scale);
+				_mm_storeu_si128(reinterpret_cast<glm_ivec4*>(p + i), _mm_packs_epi32(a, b));
+			}
+
+			pack_snorm_scalar(v, p, i, count);
+		}
+
+		GLM_FUNC_QUALIFIER static void unpack(short const* p, float* v, std::size_t count)
+		{
+			glm_vec4 const scale = _mm_set1_ps(1.0f / 32767.0f);
+			glm_vec4 const minusOne = _mm_set1_ps(-1.0f);
+			glm_vec4 const one = _mm_set1_ps(1.0f);
+
+			std::size_t i = 0;
+			for(; i + 8 <= count; i += 8)
+			{
+				glm_ivec4 const x = _mm_loadu_si128(reinterpret_cast<glm_ivec4 const*>(p + i));
+				glm_vec4 const a = _mm_cvtepi32_ps(_mm_srai_epi32(_mm_unpacklo_epi16(x, x), 16));
+				glm_vec4 const b = _mm_cvtepi32_ps(_mm_srai_epi32(_mm_unpackhi_epi16(x, x), 16));
+				_mm_storeu_ps(v + i, _mm_min_ps(_mm_max_ps(_mm_mul_ps(a, scale), minusOne), one));
+				_mm_storeu_ps(v + i + 4, _mm_min_ps(_mm_max_ps(_mm_mul_ps(b, scale), minusOne), one));
+			}
+
+			unpack_snorm_scalar(p, v, i, count);
+		}
+	};
 }//namespace detail
 }//namespace glm
+
+#endif//GLM_ARCH & GLM_ARCH_SSE2_BIT
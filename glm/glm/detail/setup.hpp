@@ -807,6 +807,18 @@ namespace detail
 #	define GLM_CONFIG_SIMD GLM_DISABLE
 #endif
 
+///////////////////////////////////////////////////////////////////////////////////
+// Use F16C in the bulk half conversions of GLM_GTC_packing, define GLM_FORCE_HALF_F16C before including GLM.
+// F16C rounds halfway cases to even and quiets signaling NaNs, where the other half conversions round halfway cases up
+// and keep the NaN payload. MSVC does not report F16C, so there AVX2 stands for it: every CPU with AVX2 has F16C.
+
+#if defined(GLM_FORCE_HALF_F16C) && (GLM_CONFIG_SIMD == GLM_ENABLE) && (GLM_ARCH & GLM_ARCH_AVX_BIT) && \
+	(defined(__F16C__) || ((GLM_COMPILER & GLM_COMPILER_VC) && (GLM_ARCH & GLM_ARCH_AVX2_BIT)))
+#	define GLM_CONFIG_HALF_F16C GLM_ENABLE
+#else
+#	define GLM_CONFIG_HALF_F16C GLM_DISABLE
+#endif
+
 ///////////////////////////////////////////////////////////////////////////////////
 // Configure the use of defaulted function
 
@@ -977,7 +989,12 @@ namespace detail
 #	endif
 
 	// Report build target
-#	if (GLM_ARCH & GLM_ARCH_AVX2_BIT) && (GLM_MODEL == GLM_MODEL_64)
+#	if (GLM_ARCH & GLM_ARCH_AVX512_BIT) && (GLM_MODEL == GLM_MODEL_64)
+#		pragma message("GLM: x86 64 bits with AVX-512 instruction set build target")
+#	elif (GLM_ARCH & GLM_ARCH_AVX512_BIT) && (GLM_MODEL == GLM_MODEL_32)
+#		pragma message("GLM: x86 32 bits with AVX-512 instruction set build target")
+
+#	elif (GLM_ARCH & GLM_ARCH_AVX2_BIT) && (GLM_MODEL == GLM_MODEL_64)
 #		pragma message("GLM: x86 64 bits with AVX2 instruction set build target")
 #	elif (GLM_ARCH & GLM_ARCH_AVX2_BIT) && (GLM_MODEL == GLM_MODEL_32)
 #		pragma message("GLM: x86 32 bits with AVX2 instruction set build target")
@@ -1040,6 +1057,16 @@ namespace detail
 #		pragma message("GLM: Unknown build target")
 #	endif//GLM_ARCH
 
+#	if GLM_ARCH_DISPATCH & GLM_ARCH_AVX2_BIT
+#		pragma message("GLM: AVX2 and AVX-512 batch kernels selected at run time")
+#	elif GLM_ARCH_DISPATCH & GLM_ARCH_AVX512_BIT
+#		pragma message("GLM: AVX-512 batch kernels selected at run time")
+#	endif//GLM_ARCH_DISPATCH
+
+#	if GLM_CONFIG_HALF_F16C == GLM_ENABLE
+#		pragma message("GLM: F16C bulk half conversions, rounding halfway cases to even")
+#	endif
+
 	// Report platform name
 #	if(GLM_PLATFORM & GLM_PLATFORM_QNXNTO)
 #		pragma message("GLM: QNX platform detected")
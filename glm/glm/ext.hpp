@@ -13,6 +13,9 @@
 #	pragma message("GLM: All extensions included (not recommended)")
 #endif//GLM_MESSAGES
 
+#include "./ext/batch_soa.hpp"
+#include "./ext/batch_transform.hpp"
+
 #include "./ext/matrix_clip_space.hpp"
 #include "./ext/matrix_common.hpp"
 
@@ -0,0 +1,81 @@
+/// @ref ext_batch_soa
+/// @file glm/ext/batch_soa.hpp
+///
+/// @defgroup ext_batch_soa GLM_EXT_batch_soa
+/// @ingroup ext
+///
+/// Structure of arrays views over vectors and matrices, for the batch functions of ext_batch_transform.
+/// A view only points at arrays the caller owns: one array per component, all of the same size.
+///
+/// Include <glm/ext/batch_soa.hpp> to use the features of this extension.
+///
+/// @see ext_batch_transform
+
+#pragma once
+
+// Dependencies
+#include "../mat4x4.hpp"
+
+#if GLM_MESSAGES == GLM_ENABLE && !defined(GLM_EXT_INCLUDED)
+#	pragma message("GLM: GLM_EXT_batch_soa extension included")
+#endif
+
+namespace glm
+{
+	/// @addtogroup ext_batch_soa
+	/// @{
+
+	/// View of size 3 component vectors stored as an array of x, an array of y and an array of z.
+	///
+	/// @tparam T Floating-point or integer scalar types
+	template<typename T>
+	struct vec3_soa
+	{
+		T* x;
+		T* y;
+		T* z;
+		std::size_t size;
+
+		GLM_FUNC_DECL vec3_soa();
+
+		/// View of three separate component arrays of size elements each.
+		GLM_FUNC_DECL vec3_soa(T* x, T* y, T* z, std::size_t size);
+
+		/// View of a block of 3 * size elements: the x array, then the y array, then the z array.
+		GLM_FUNC_DECL vec3_soa(T* data, std::size_t size);
+
+		/// Gathers the vector at index i.
+		GLM_FUNC_DECL vec<3, T, defaultp> operator[](std::size_t i) const;
+
+		/// Scatters v to index i.
+		template<qualifier Q>
+		GLM_FUNC_DECL void set(std::size_t i, vec<3, T, Q> const& v) const;
+	};
+
+	/// View of 4 * 4 matrices stored as one array per component.
+	///
+	/// @tparam T Floating-point or integer scalar types
+	template<typename T>
+	struct mat4_soa
+	{
+		/// data[c][r] is the array of the components at column c and row r.
+		T* data[4][4];
+		std::size_t size;
+
+		GLM_FUNC_DECL mat4_soa();
+
+		/// View of a block of 16 * size elements, the array of column c and row r starting at (c * 4 + r) * size.
+		GLM_FUNC_DECL mat4_soa(T* data, std::size_t size);
+
+		/// Gathers the matrix at index i.
+		GLM_FUNC_DECL mat<4, 4, T, defaultp> operator[](std::size_t i) const;
+
+		/// Scatters m to index i.
+		template<qualifier Q>
+		GLM_FUNC_DECL void set(std::size_t i, mat<4, 4, T, Q> const& m) const;
+	};
+
+	/// @}
+}//namespace glm
+
+#include "batch_soa.inl"
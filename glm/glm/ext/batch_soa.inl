@@ -0,0 +1,76 @@
+/// @ref ext_batch_soa
+/// @file glm/ext/batch_soa.inl
+
+namespace glm
+{
+	template<typename T>
+	GLM_FUNC_QUALIFIER vec3_soa<T>::vec3_soa()
+		: x(GLM_NULLPTR), y(GLM_NULLPTR), z(GLM_NULLPTR), size(0)
+	{}
+
+	template<typename T>
+	GLM_FUNC_QUALIFIER vec3_soa<T>::vec3_soa(T* x_, T* y_, T* z_, std::size_t size_)
+		: x(x_), y(y_), z(z_), size(size_)
+	{}
+
+	template<typename T>
+	GLM_FUNC_QUALIFIER vec3_soa<T>::vec3_soa(T* data, std::size_t size_)
+		: x(data), y(data + size_), z(data + size_ * 2), size(size_)
+	{}
+
+	template<typename T>
+	GLM_FUNC_QUALIFIER vec<3, T, defaultp> vec3_soa<T>::operator[](std::size_t i) const
+	{
+		assert(i < size);
+		return vec<3, T, defaultp>(x[i], y[i], z[i]);
+	}
+
+	template<typename T>
+	template<qualifier Q>
+	GLM_FUNC_QUALIFIER void vec3_soa<T>::set(std::size_t i, vec<3, T, Q> const& v) const
+	{
+		assert(i < size);
+		x[i] = v.x;
+		y[i] = v.y;
+		z[i] = v.z;
+	}
+
+	template<typename T>
+	GLM_FUNC_QUALIFIER mat4_soa<T>::mat4_soa()
+		: size(0)
+	{
+		for(length_t c = 0; c < 4; ++c)
+		for(length_t r = 0; r < 4; ++r)
+			this->data[c][r] = GLM_NULLPTR;
+	}
+
+	template<typename T>
+	GLM_FUNC_QUALIFIER mat4_soa<T>::mat4_soa(T* data_, std::size_t size_)
+		: size(size_)
+	{
+		for(length_t c = 0; c < 4; ++c)
+		for(length_t r = 0; r < 4; ++r)
+			this->data[c][r] = data_ + static_cast<std::size_t>(c * 4 + r) * size_;
+	}
+
+	template<typename T>
+	GLM_FUNC_QUALIFIER mat<4, 4, T, defaultp> mat4_soa<T>::operator[](std::size_t i) const
+	{
+		assert(i < size);
+		mat<4, 4, T, defaultp> Result;
+		for(length_t c = 0; c < 4; ++c)
+		for(length_t r = 0; r < 4; ++r)
+			Result[c][r] = this->data[c][r][i];
+		return Result;
+	}
+
+	template<typename T>
+	template<qualifier Q>
+	GLM_FUNC_QUALIFIER void mat4_soa<T>::set(std::size_t i, mat<4, 4, T, Q> const& m) const
+	{
+		assert(i < size);
+		for(length_t c = 0; c < 4; ++c)
+		for(length_t r = 0; r < 4; ++r)
+			this->data[c][r][i] = m[c][r];
+	}
+}//namespace glm
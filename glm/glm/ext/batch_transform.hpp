@@ -0,0 +1,99 @@
+/// @ref ext_batch_transform
+/// @file glm/ext/batch_transform.hpp
+///
+/// @defgroup ext_batch_transform GLM_EXT_batch_transform
+/// @ingroup ext
+///
+/// Transforms and multiplies whole arrays of vectors and matrices in one call, for arrays of structures
+/// (plain arrays of vec3 and mat4) as well as structures of arrays (ext_batch_soa views).
+///
+/// With float components and GLM_FORCE_INTRINSICS, the arrays are processed 8 elements at a time on AVX2
+/// targets and 16 elements at a time on AVX-512 targets, except inverse and determinant which process 2 and 4 matrices
+/// at a time; the remaining elements and other targets use the scalar path.
+/// Both paths sum in the order of the scalar mat4 operators and functions, so results only differ from a loop over those
+/// where the compiler contracts that loop to fused multiply-adds, or where aligned types use their own SIMD functions.
+///
+/// With GLM_FORCE_SIMD_DISPATCH, a build targeting SSE2 or above also compiles the AVX2 and AVX-512 paths and
+/// selects them at run time, once it has checked that the CPU and the operating system support them.
+///
+/// Output arrays may be the input arrays, but must not partially overlap them.
+///
+/// Include <glm/ext/batch_transform.hpp> to use the features of this extension.
+///
+/// @see ext_batch_soa
+
+#pragma once
+
+// Dependencies
+#include "../mat4x4.hpp"
+#include "../matrix.hpp"
+#include "../ext/batch_soa.hpp"
+
+#if GLM_MESSAGES == GLM_ENABLE && !defined(GLM_EXT_INCLUDED)
+#	pragma message("GLM: GLM_EXT_batch_transform extension included")
+#endif
+
+namespace glm
+{
+	/// @addtogroup ext_batch_transform
+	/// @{
+
+	/// Writes vec3(m * vec4(in[i], 1)) to out[i] for each of the count points, without perspective division.
+	///
+	/// @tparam T Floating-point or integer scalar types
+	/// @tparam Q Value from qualifier enum
+	template<typename T, qualifier Q>
+	GLM_FUNC_DECL void transform_points(mat<4, 4, T, Q> const& m, vec<3, T, Q> const* in, vec<3, T, Q>* out, std::size_t count);
+
+	/// Writes vec3(m * vec4(in[i], 1)) to out for each point of in. out.size must be at least in.size.
+	///
+	/// @tparam T Floating-point or integer scalar types
+	/// @tparam Q Value from qualifier enum
+	template<typename T, qualifier Q>
+	GLM_FUNC_DECL void transform_points(mat<4, 4, T, Q> const& m, vec3_soa<T> const& in, vec3_soa<T> const& out);
+
+	/// Writes vec3(m * vec4(in[i], 0)) to out[i] for each of the count directions.
+	///
+	/// @tparam T Floating-point or integer scalar types
+	/// @tparam Q Value from qualifier enum
+	template<typename T, qualifier Q>
+	GLM_FUNC_DECL void transform_directions(mat<4, 4, T, Q> const& m, vec<3, T, Q> const* in, vec<3, T, Q>* out, std::size_t count);
+
+	/// Writes vec3(m * vec4(in[i], 0)) to out for each direction of in. out.size must be at least in.size.
+	///
+	/// @tparam T Floating-point or integer scalar types
+	/// @tparam Q Value from qualifier enum
+	template<typename T, qualifier Q>
+	GLM_FUNC_DECL void transform_directions(mat<4, 4, T, Q> const& m, vec3_soa<T> const& in, vec3_soa<T> const& out);
+
+	/// Writes a[i] * b[i] to out[i] for each of the count pairs of matrices.
+	///
+	/// @tparam T Floating-point or integer scalar types
+	/// @tparam Q Value from qualifier enum
+	template<typename T, qualifier Q>
+	GLM_FUNC_DECL void mul(mat<4, 4, T, Q> const* a, mat<4, 4, T, Q> const* b, mat<4, 4, T, Q>* out, std::size_t count);
+
+	/// Writes a[i] * b[i] to out for each pair of matrices of a and b. b.size and out.size must be at least a.size.
+	///
+	/// @tparam T Floating-point or integer scalar types
+	template<typename T>
+	GLM_FUNC_DECL void mul(mat4_soa<T> const& a, mat4_soa<T> const& b, mat4_soa<T> const& out);
+
+	/// Writes inverse(in[i]) to out[i] for each of the count matrices.
+	///
+	/// @tparam T Floating-point scalar types
+	/// @tparam Q Value from qualifier enum
+	template<typename T, qualifier Q>
+	GLM_FUNC_DECL void inverse(mat<4, 4, T, Q> const* in, mat<4, 4, T, Q>* out, std::size_t count);
+
+	/// Writes determinant(in[i]) to out[i] for each of the count matrices.
+	///
+	/// @tparam T Floating-point scalar types
+	/// @tparam Q Value from qualifier enum
+	template<typename T, qualifier Q>
+	GLM_FUNC_DECL void determinant(mat<4, 4, T, Q> const* in, T* out, std::size_t count);
+
+	/// @}
+}//namespace glm
+
+#include "batch_transform.inl"
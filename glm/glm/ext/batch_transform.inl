@@ -0,0 +1,160 @@
+/// @ref ext_batch_transform
+/// @file glm/ext/batch_transform.inl
+
+namespace glm{
+namespace detail
+{
+	template<typename T, qualifier Q>
+	GLM_FUNC_QUALIFIER void transform_vec3_scalar(mat<4, 4, T, Q> const& m, T w, vec<3, T, Q> const* in, vec<3, T, Q>* out, std::size_t first, std::size_t count)
+	{
+		for(std::size_t i = first; i < count; ++i)
+			out[i] = vec<3, T, Q>(m * vec<4, T, Q>(in[i], w));
+	}
+
+	template<typename T, qualifier Q>
+	GLM_FUNC_QUALIFIER void transform_vec3_soa_scalar(mat<4, 4, T, Q> const& m, T w, vec3_soa<T> const& in, vec3_soa<T> const& out, std::size_t first)
+	{
+		for(std::size_t i = first; i < in.size; ++i)
+			out.set(i, vec<3, T, Q>(m * vec<4, T, Q>(in.x[i], in.y[i], in.z[i], w)));
+	}
+
+	template<typename T, qualifier Q>
+	GLM_FUNC_QUALIFIER void mul_mat4_scalar(mat<4, 4, T, Q> const* a, mat<4, 4, T, Q> const* b, mat<4, 4, T, Q>* out, std::size_t first, std::size_t count)
+	{
+		for(std::size_t i = first; i < count; ++i)
+			out[i] = a[i] * b[i];
+	}
+
+	template<typename T>
+	GLM_FUNC_QUALIFIER void mul_mat4_soa_scalar(mat4_soa<T> const& a, mat4_soa<T> const& b, mat4_soa<T> const& out, std::size_t first)
+	{
+		for(std::size_t i = first; i < a.size; ++i)
+			out.set(i, a[i] * b[i]);
+	}
+
+	template<typename T, qualifier Q>
+	GLM_FUNC_QUALIFIER void inverse_mat4_scalar(mat<4, 4, T, Q> const* in, mat<4, 4, T, Q>* out, std::size_t first, std::size_t count)
+	{
+		for(std::size_t i = first; i < count; ++i)
+			out[i] = inverse(in[i]);
+	}
+
+	template<typename T, qualifier Q>
+	GLM_FUNC_QUALIFIER void determinant_mat4_scalar(mat<4, 4, T, Q> const* in, T* out, std::size_t first, std::size_t count)
+	{
+		for(std::size_t i = first; i < count; ++i)
+			out[i] = determinant(in[i]);
+	}
+
+	template<typename T, qualifier Q, bool Aligned>
+	struct compute_transform_vec3
+	{
+		GLM_FUNC_QUALIFIER static void call(mat<4, 4, T, Q> const& m, T w, vec<3, T, Q> const* in, vec<3, T, Q>* out, std::size_t count)
+		{
+			transform_vec3_scalar(m, w, in, out, 0, count);
+		}
+	};
+
+	template<typename T, qualifier Q>
+	struct compute_transform_vec3_soa
+	{
+		GLM_FUNC_QUALIFIER static void call(mat<4, 4, T, Q> const& m, T w, vec3_soa<T> const& in, vec3_soa<T> const& out)
+		{
+			transform_vec3_soa_scalar(m, w, in, out, 0);
+		}
+	};
+
+	template<typename T, qualifier Q, bool Aligned>
+	struct compute_mat4_mul_batch
+	{
+		GLM_FUNC_QUALIFIER static void call(mat<4, 4, T, Q> const* a, mat<4, 4, T, Q> const* b, mat<4, 4, T, Q>* out, std::size_t count)
+		{
+			mul_mat4_scalar(a, b, out, 0, count);
+		}
+	};
+
+	template<typename T>
+	struct compute_mat4_mul_soa
+	{
+		GLM_FUNC_QUALIFIER static void call(mat4_soa<T> const& a, mat4_soa<T> const& b, mat4_soa<T> const& out)
+		{
+			mul_mat4_soa_scalar(a, b, out, 0);
+		}
+	};
+
+	template<typename T, qualifier Q, bool Aligned>
+	struct compute_mat4_inverse_batch
+	{
+		GLM_FUNC_QUALIFIER static void call(mat<4, 4, T, Q> const* in, mat<4, 4, T, Q>* out, std::size_t count)
+		{
+			inverse_mat4_scalar(in, out, 0, count);
+		}
+	};
+
+	template<typename T, qualifier Q, bool Aligned>
+	struct compute_mat4_determinant_batch
+	{
+		GLM_FUNC_QUALIFIER static void call(mat<4, 4, T, Q> const* in, T* out, std::size_t count)
+		{
+			determinant_mat4_scalar(in, out, 0, count);
+		}
+	};
+}//namespace detail
+
+	template<typename T, qualifier Q>
+	GLM_FUNC_QUALIFIER void transform_points(mat<4, 4, T, Q> const& m, vec<3, T, Q> const* in, vec<3, T, Q>* out, std::size_t count)
+	{
+		detail::compute_transform_vec3<T, Q, detail::is_aligned<Q>::value>::call(m, static_cast<T>(1), in, out, count);
+	}
+
+	template<typename T, qualifier Q>
+	GLM_FUNC_QUALIFIER void transform_points(mat<4, 4, T, Q> const& m, vec3_soa<T> const& in, vec3_soa<T> const& out)
+	{
+		assert(out.size >= in.size);
+		detail::compute_transform_vec3_soa<T, Q>::call(m, static_cast<T>(1), in, out);
+	}
+
+	template<typename T, qualifier Q>
+	GLM_FUNC_QUALIFIER void transform_directions(mat<4, 4, T, Q> const& m, vec<3, T, Q> const* in, vec<3, T, Q>* out, std::size_t count)
+	{
+		detail::compute_transform_vec3<T, Q, detail::is_aligned<Q>::value>::call(m, static_cast<T>(0), in, out, count);
+	}
+
+	template<typename T, qualifier Q>
+	GLM_FUNC_QUALIFIER void transform_directions(mat<4, 4, T, Q> const& m, vec3_soa<T> const& in, vec3_soa<T> const& out)
+	{
+		assert(out.size >= in.size);
+		detail::compute_transform_vec3_soa<T, Q>::call(m, static_cast<T>(0), in, out);
+	}
+
+	template<typename T, qualifier Q>
+	GLM_FUNC_QUALIFIER void mul(mat<4, 4, T, Q> const* a, mat<4, 4, T, Q> const* b, mat<4, 4, T, Q>* out, std::size_t count)
+	{
+		detail::compute_mat4_mul_batch<T, Q, detail::is_aligned<Q>::value>::call(a, b, out, count);
+	}
+
+	template<typename T>
+	GLM_FUNC_QUALIFIER void mul(mat4_soa<T> const& a, mat4_soa<T> const& b, mat4_soa<T> const& out)
+	{
+		assert(b.size >= a.size && out.size >= a.size);
+		detail::compute_mat4_mul_soa<T>::call(a, b, out);
+	}
+
+	template<typename T, qualifier Q>
+	GLM_FUNC_QUALIFIER void inverse(mat<4, 4, T, Q> const* in, mat<4, 4, T, Q>* out, std::size_t count)
+	{
+		GLM_STATIC_ASSERT(std::numeric_limits<T>::is_iec559 || GLM_CONFIG_UNRESTRICTED_GENTYPE, "'inverse' only accept floating-point inputs");
+		detail::compute_mat4_inverse_batch<T, Q, detail::is_aligned<Q>::value>::call(in, out, count);
+	}
+
+	template<typename T, qualifier Q>
+	GLM_FUNC_QUALIFIER void determinant(mat<4, 4, T, Q> const* in, T* out, std::size_t count)
+	{
+		GLM_STATIC_ASSERT(std::numeric_limits<T>::is_iec559 || GLM_CONFIG_UNRESTRICTED_GENTYPE, "'determinant' only accept floating-point inputs");
+		detail::compute_mat4_determinant_batch<T, Q, detail::is_aligned<Q>::value>::call(in, out, count);
+	}
+}//namespace glm
+
+#if GLM_CONFIG_SIMD == GLM_ENABLE
+#	include "batch_transform_simd.inl"
+#endif
@@ -0,0 +1,329 @@
+/// @ref ext_batch_transform
+/// @file glm/ext/batch_transform_simd.inl
+
+#include "../simd/batch.h"
+
+#if (GLM_ARCH | GLM_ARCH_DISPATCH) & GLM_ARCH_AVX2_BIT
+
+namespace glm{
+namespace detail
+{
+	// Each kernel processes the elements from first on while it has full registers, and returns the index of the next one
+
+	template<qualifier Q>
+	GLM_FUNC_AVX2 std::size_t transform_vec3_avx2(mat<4, 4, float, Q> const& m, float w, vec<3, float, Q> const* in, vec<3, float, Q>* out, std::size_t first, std::size_t count)
+	{
+		glm_f32vec8 Mat[16];
+		for(length_t c = 0; c < 4; ++c)
+		for(length_t r = 0; r < 4; ++r)
+			Mat[c * 4 + r] = _mm256_set1_ps(c == 3 ? m[c][r] * w : m[c][r]);
+
+		std::size_t i = first;
+		for(; i + 8 <= count; i += 8)
+		{
+			glm_f32vec8 Src[3], Dst[3];
+			glm_vec3x8_load(reinterpret_cast<float const*>(in + i), Src);
+			glm_mat4_mul_vec3x8(Mat, Src, Dst);
+			glm_vec3x8_store(Dst, reinterpret_cast<float*>(out + i));
+		}
+		return i;
+	}
+
+	template<qualifier Q>
+	GLM_FUNC_AVX2 std::size_t transform_vec3_soa_avx2(mat<4, 4, float, Q> const& m, float w, vec3_soa<float> const& in, vec3_soa<float> const& out, std::size_t first)
+	{
+		glm_f32vec8 Mat[16];
+		for(length_t c = 0; c < 4; ++c)
+		for(length_t r = 0; r < 4; ++r)
+			Mat[c * 4 + r] = _mm256_set1_ps(c == 3 ? m[c][r] * w : m[c][r]);
+
+		std::size_t i = first;
+		for(; i + 8 <= in.size; i += 8)
+		{
+			glm_f32vec8 Src[3], Dst[3];
+			Src[0] = _mm256_loadu_ps(in.x + i);
+			Src[1] = _mm256_loadu_ps(in.y + i);
+			Src[2] = _mm256_loadu_ps(in.z + i);
+			glm_mat4_mul_vec3x8(Mat, Src, Dst);
+			_mm256_storeu_ps(out.x + i, Dst[0]);
+			_mm256_storeu_ps(out.y + i, Dst[1]);
+			_mm256_storeu_ps(out.z + i, Dst[2]);
+		}
+		return i;
+	}
+
+	template<qualifier Q>
+	GLM_FUNC_AVX2 std::size_t mul_mat4_avx2(mat<4, 4, float, Q> const* a, mat<4, 4, float, Q> const* b, mat<4, 4, float, Q>* out, std::size_t first, std::size_t count)
+	{
+		for(std::size_t i = first; i < count; ++i)
+			glm_mat4_mul_avx2(reinterpret_cast<float const*>(a + i), reinterpret_cast<float const*>(b + i), reinterpret_cast<float*>(out + i));
+		return count;
+	}
+
+	GLM_FUNC_AVX2 std::size_t mul_mat4_soa_avx2(mat4_soa<float> const& a, mat4_soa<float> const& b, mat4_soa<float> const& out, std::size_t first)
+	{
+		std::size_t i = first;
+		for(; i + 8 <= a.size; i += 8)
+		{
+			glm_f32vec8 SrcA[16], SrcB[16], Dst[16];
+			for(length_t c = 0; c < 4; ++c)
+			for(length_t r = 0; r < 4; ++r)
+			{
+				SrcA[c * 4 + r] = _mm256_loadu_ps(a.data[c][r] + i);
+				SrcB[c * 4 + r] = _mm256_loadu_ps(b.data[c][r] + i);
+			}
+			glm_mat4x8_mul(SrcA, SrcB, Dst);
+			for(length_t c = 0; c < 4; ++c)
+			for(length_t r = 0; r < 4; ++r)
+				_mm256_storeu_ps(out.data[c][r] + i, Dst[c * 4 + r]);
+		}
+		return i;
+	}
+
+	template<qualifier Q>
+	GLM_FUNC_AVX2 std::size_t inverse_mat4_avx2(mat<4, 4, float, Q> const* in, mat<4, 4, float, Q>* out, std::size_t first, std::size_t count)
+	{
+		std::size_t i = first;
+		for(; i + 2 <= count; i += 2)
+		{
+			glm_f32vec8 Src[4], Dst[4];
+			glm_mat4_load_avx2(reinterpret_cast<float const*>(in + i), Src);
+			glm_mat4_inverse_avx2(Src, Dst);
+			glm_mat4_store_avx2(Dst, reinterpret_cast<float*>(out + i));
+		}
+		return i;
+	}
+
+	template<qualifier Q>
+	GLM_FUNC_AVX2 std::size_t determinant_mat4_avx2(mat<4, 4, float, Q> const* in, float* out, std::size_t first, std::size_t count)
+	{
+		std::size_t i = first;
+		for(; i + 2 <= count; i += 2)
+		{
+			glm_f32vec8 Src[4];
+			glm_mat4_load_avx2(reinterpret_cast<float const*>(in + i), Src);
+			glm_f32vec8 const Det = glm_mat4_determinant_avx2(Src);
+			out[i] = _mm_cvtss_f32(_mm256_castps256_ps128(Det));
+			out[i + 1] = _mm_cvtss_f32(_mm256_extractf128_ps(Det, 1));
+		}
+		return i;
+	}
+
+#	if (GLM_ARCH | GLM_ARCH_DISPATCH) & GLM_ARCH_AVX512_BIT
+		template<qualifier Q>
+		GLM_FUNC_AVX512 std::size_t transform_vec3_avx512(mat<4, 4, float, Q> const& m, float w, vec<3, float, Q> const* in, vec<3, float, Q>* out, std::size_t first, std::size_t count)
+		{
+			glm_f32vec16 Mat[16];
+			for(length_t c = 0; c < 4; ++c)
+			for(length_t r = 0; r < 4; ++r)
+				Mat[c * 4 + r] = _mm512_set1_ps(c == 3 ? m[c][r] * w : m[c][r]);
+
+			std::size_t i = first;
+			for(; i + 16 <= count; i += 16)
+			{
+				glm_f32vec16 Src[3], Dst[3];
+				glm_vec3x16_load(reinterpret_cast<float const*>(in + i), Src);
+				glm_mat4_mul_vec3x16(Mat, Src, Dst);
+				glm_vec3x16_store(Dst, reinterpret_cast<float*>(out + i));
+			}
+			return i;
+		}
+
+		template<qualifier Q>
+		GLM_FUNC_AVX512 std::size_t transform_vec3_soa_avx512(mat<4, 4, float, Q> const& m, float w, vec3_soa<float> const& in, vec3_soa<float> const& out, std::size_t first)
+		{
+			glm_f32vec16 Mat[16];
+			for(length_t c = 0; c < 4; ++c)
+			for(length_t r = 0; r < 4; ++r)
+				Mat[c * 4 + r] = _mm512_set1_ps(c == 3 ? m[c][r] * w : m[c][r]);
+
+			std::size_t i = first;
+			for(; i + 16 <= in.size; i += 16)
+			{
+				glm_f32vec16 Src[3], Dst[3];
+				Src[0] = _mm512_loadu_ps(in.x + i);
+				Src[1] = _mm512_loadu_ps(in.y + i);
+				Src[2] = _mm512_loadu_ps(in.z + i);
+				glm_mat4_mul_vec3x16(Mat, Src, Dst);
+				_mm512_storeu_ps(out.x + i, Dst[0]);
+				_mm512_storeu_ps(out.y + i, Dst[1]);
+				_mm512_storeu_ps(out.z + i, Dst[2]);
+			}
+			return i;
+		}
+
+		template<qualifier Q>
+		GLM_FUNC_AVX512 std::size_t mul_mat4_avx512(mat<4, 4, float, Q> const* a, mat<4, 4, float, Q> const* b, mat<4, 4, float, Q>* out, std::size_t first, std::size_t count)
+		{
+			for(std::size_t i = first; i < count; ++i)
+				glm_mat4_mul_avx512(reinterpret_cast<float const*>(a + i), reinterpret_cast<float const*>(b + i), reinterpret_cast<float*>(out + i));
+			return count;
+		}
+
+		GLM_FUNC_AVX512 std::size_t mul_mat4_soa_avx512(mat4_soa<float> const& a, mat4_soa<float> const& b, mat4_soa<float> const& out, std::size_t first)
+		{
+			std::size_t i = first;
+			for(; i + 16 <= a.size; i += 16)
+			{
+				glm_f32vec16 SrcA[16], SrcB[16], Dst[16];
+				for(length_t c = 0; c < 4; ++c)
+				for(length_t r = 0; r < 4; ++r)
+				{
+					SrcA[c * 4 + r] = _mm512_loadu_ps(a.data[c][r] + i);
+					SrcB[c * 4 + r] = _mm512_loadu_ps(b.data[c][r] + i);
+				}
+				glm_mat4x16_mul(SrcA, SrcB, Dst);
+				for(length_t c = 0; c < 4; ++c)
+				for(length_t r = 0; r < 4; ++r)
+					_mm512_storeu_ps(out.data[c][r] + i, Dst[c * 4 + r]);
+			}
+			return i;
+		}
+
+		template<qualifier Q>
+		GLM_FUNC_AVX512 std::size_t inverse_mat4_avx512(mat<4, 4, float, Q> const* in, mat<4, 4, float, Q>* out, std::size_t first, std::size_t count)
+		{
+			std::size_t i = first;
+			for(; i + 4 <= count; i += 4)
+			{
+				glm_f32vec16 Src[4], Dst[4];
+				glm_mat4_load_avx512(reinterpret_cast<float const*>(in + i), Src);
+				glm_mat4_inverse_avx512(Src, Dst);
+				glm_mat4_store_avx512(Dst, reinterpret_cast<float*>(out + i));
+			}
+			return i;
+		}
+
+		template<qualifier Q>
+		GLM_FUNC_AVX512 std::size_t determinant_mat4_avx512(mat<4, 4, float, Q> const* in, float* out, std::size_t first, std::size_t count)
+		{
+			std::size_t i = first;
+			for(; i + 4 <= count; i += 4)
+			{
+				glm_f32vec16 Src[4];
+				glm_mat4_load_avx512(reinterpret_cast<float const*>(in + i), Src);
+				_mm_storeu_ps(out + i, glm_mat4_determinant_avx512(Src));
+			}
+			return i;
+		}
+#	endif//(GLM_ARCH | GLM_ARCH_DISPATCH) & GLM_ARCH_AVX512_BIT
+
+	// The compute structs run the widest kernels glm_arch_runtime reports, then the scalar path for the remaining elements
+
+	template<qualifier Q>
+	struct compute_transform_vec3<float, Q, false>
+	{
+		GLM_FUNC_QUALIFIER static void call(mat<4, 4, float, Q> const& m, float w, vec<3, float, Q> const* in, vec<3, float, Q>* out, std::size_t count)
+		{
+			unsigned int const Arch = glm_arch_runtime();
+			std::size_t i = 0;
+
+#			if (GLM_ARCH | GLM_ARCH_DISPATCH) & GLM_ARCH_AVX512_BIT
+				if(Arch & GLM_ARCH_AVX512_BIT)
+					i = transform_vec3_avx512(m, w, in, out, i, count);
+#			endif
+			if(Arch & GLM_ARCH_AVX2_BIT)
+				i = transform_vec3_avx2(m, w, in, out, i, count);
+
+			transform_vec3_scalar(m, w, in, out, i, count);
+		}
+	};
+
+	template<qualifier Q>
+	struct compute_transform_vec3_soa<float, Q>
+	{
+		GLM_FUNC_QUALIFIER static void call(mat<4, 4, float, Q> const& m, float w, vec3_soa<float> const& in, vec3_soa<float> const& out)
+		{
+			unsigned int const Arch = glm_arch_runtime();
+			std::size_t i = 0;
+
+#			if (GLM_ARCH | GLM_ARCH_DISPATCH) & GLM_ARCH_AVX512_BIT
+				if(Arch & GLM_ARCH_AVX512_BIT)
+					i = transform_vec3_soa_avx512(m, w, in, out, i);
+#			endif
+			if(Arch & GLM_ARCH_AVX2_BIT)
+				i = transform_vec3_soa_avx2(m, w, in, out, i);
+
+			transform_vec3_soa_scalar(m, w, in, out, i);
+		}
+	};
+
+	template<qualifier Q, bool Aligned>
+	struct compute_mat4_mul_batch<float, Q, Aligned>
+	{
+		GLM_FUNC_QUALIFIER static void call(mat<4, 4, float, Q> const* a, mat<4, 4, float, Q> const* b, mat<4, 4, float, Q>* out, std::size_t count)
+		{
+			unsigned int const Arch = glm_arch_runtime();
+			std::size_t i = 0;
+
+#			if (GLM_ARCH | GLM_ARCH_DISPATCH) & GLM_ARCH_AVX512_BIT
+				if(Arch & GLM_ARCH_AVX512_BIT)
+					i = mul_mat4_avx512(a, b, out, i, count);
+#			endif
+			if(Arch & GLM_ARCH_AVX2_BIT)
+				i = mul_mat4_avx2(a, b, out, i, count);
+
+			mul_mat4_scalar(a, b, out, i, count);
+		}
+	};
+
+	template<>
+	struct compute_mat4_mul_soa<float>
+	{
+		GLM_FUNC_QUALIFIER static void call(mat4_soa<float> const& a, mat4_soa<float> const& b, mat4_soa<float> const& out)
+		{
+			unsigned int const Arch = glm_arch_runtime();
+			std::size_t i = 0;
+
+#			if (GLM_ARCH | GLM_ARCH_DISPATCH) & GLM_ARCH_AVX512_BIT
+				if(Arch & GLM_ARCH_AVX512_BIT)
+					i = mul_mat4_soa_avx512(a, b, out, i);
+#			endif
+			if(Arch & GLM_ARCH_AVX2_BIT)
+				i = mul_mat4_soa_avx2(a, b, out, i);
+
+			mul_mat4_soa_scalar(a, b, out, i);
+		}
+	};
+
+	template<qualifier Q, bool Aligned>
+	struct compute_mat4_inverse_batch<float, Q, Aligned>
+	{
+		GLM_FUNC_QUALIFIER static void call(mat<4, 4, float, Q> const* in, mat<4, 4, float, Q>* out, std::size_t count)
+		{
+			unsigned int const Arch = glm_arch_runtime();
+			std::size_t i = 0;
+
+#			if (GLM_ARCH | GLM_ARCH_DISPATCH) & GLM_ARCH_AVX512_BIT
+				if(Arch & GLM_ARCH_AVX512_BIT)
+					i = inverse_mat4_avx512(in, out, i, count);
+#			endif
+			if(Arch & GLM_ARCH_AVX2_BIT)
+				i = inverse_mat4_avx2(in, out, i, count);
+
+			inverse_mat4_scalar(in, out, i, count);
+		}
+	};
+
+	template<qualifier Q, bool Aligned>
+	struct compute_mat4_determinant_batch<float, Q, Aligned>
+	{
+		GLM_FUNC_QUALIFIER static void call(mat<4, 4, float, Q> const* in, float* out, std::size_t count)
+		{
+			unsigned int const Arch = glm_arch_runtime();
+			std::size_t i = 0;
+
+#			if (GLM_ARCH | GLM_ARCH_DISPATCH) & GLM_ARCH_AVX512_BIT
+				if(Arch & GLM_ARCH_AVX512_BIT)
+					i = determinant_mat4_avx512(in, out, i, count);
+#			endif
+			if(Arch & GLM_ARCH_AVX2_BIT)
+				i = determinant_mat4_avx2(in, out, i, count);
+
+			determinant_mat4_scalar(in, out, i, count);
+		}
+	};
+}//namespace detail
+}//namespace glm
+
+#endif//(GLM_ARCH | GLM_ARCH_DISPATCH) & GLM_ARCH_AVX2_BIT
@@ -540,6 +540,51 @@ namespace glm
 	template<typename floatType, length_t L, typename intType, qualifier Q>
 	GLM_FUNC_DECL vec<L, floatType, Q> unpackSnorm(vec<L, intType, Q> const& v);
 
+	/// Converts the components of count vectors to half, the same as packHalf on each vector.
+	/// Uses SIMD instructions for float components when GLM_FORCE_INTRINSICS is defined.
+	///
+	/// @see gtc_packing
+	/// @see vec<L, uint16, Q> packHalf(vec<L, float, Q> const& v)
+	template<length_t L, qualifier Q>
+	GLM_FUNC_DECL void packHalf(vec<L, float, Q> const* v, vec<L, uint16, Q>* p, std::size_t count);
+
+	/// Converts count vectors of halfs to float, the same as unpackHalf on each vector.
+	///
+	/// @see gtc_packing
+	/// @see vec<L, float, Q> unpackHalf(vec<L, uint16, Q> const& p)
+	template<length_t L, qualifier Q>
+	GLM_FUNC_DECL void unpackHalf(vec<L, uint16, Q> const* p, vec<L, float, Q>* v, std::size_t count);
+
+	/// Converts the components of count normalized vectors to unsigned integers, the same as packUnorm on each packed vector.
+	/// Uses SIMD instructions for float to uint8 and uint16 when GLM_FORCE_INTRINSICS is defined.
+	///
+	/// @see gtc_packing
+	/// @see vec<L, uintType, Q> packUnorm(vec<L, floatType, Q> const& v)
+	template<typename uintType, length_t L, typename floatType, qualifier Q>
+	GLM_FUNC_DECL void packUnorm(vec<L, floatType, Q> const* v, vec<L, uintType, Q>* p, std::size_t count);
+
+	/// Converts count vectors of unsigned integers to normalized floating-point vectors, the same as unpackUnorm on each vector.
+	///
+	/// @see gtc_packing
+	/// @see vec<L, floatType, Q> unpackUnorm(vec<L, uintType, Q> const& v)
+	template<typename floatType, length_t L, typename uintType, qualifier Q>
+	GLM_FUNC_DECL void unpackUnorm(vec<L, uintType, Q> const* p, vec<L, floatType, Q>* v, std::size_t count);
+
+	/// Converts the components of count normalized vectors to signed integers, the same as packSnorm on each packed vector.
+	/// Uses SIMD instructions for float to int8 and int16 when GLM_FORCE_INTRINSICS is defined.
+	///
+	/// @see gtc_packing
+	/// @see vec<L, intType, Q> packSnorm(vec<L, floatType, Q> const& v)
+	template<typename intType, length_t L, typename floatType, qualifier Q>
+	GLM_FUNC_DECL void packSnorm(vec<L, floatType, Q> const* v, vec<L, intType, Q>* p, std::size_t count);
+
+	/// Converts count vectors of signed integers to normalized floating-point vectors, the same as unpackSnorm on each vector.
+	///
+	/// @see gtc_packing
+	/// @see vec<L, floatType, Q> unpackSnorm(vec<L, intType, Q> const& v)
+	template<typename floatType, length_t L, typename intType, qualifier Q>
+	GLM_FUNC_DECL void unpackSnorm(vec<L, intType, Q> const* p, vec<L, floatType, Q>* v, std::size_t count);
+
 	/// Convert each component of the normalized floating-point vector into unsigned integer values.
 	///
 	/// @see gtc_packing
@@ -7,6 +7,7 @@
 #include "../vec3.hpp"
 #include "../vec4.hpp"
 #include "../detail/type_half.hpp"
+#include "../packing.hpp"
 #include <cstring>
 #include <limits>
 
@@ -704,6 +705,80 @@ namespace detail
 		return clamp(vec<L, floatType, Q>(v) * (static_cast<floatType>(1) / static_cast<floatType>(std::numeric_limits<intType>::max())), static_cast<floatType>(-1), static_cast<floatType>(1));
 	}
 
+	// The bulk functions convert all the components at once when the vectors have no padding, one vector at a time otherwise
+
+	template<length_t L, qualifier Q>
+	GLM_FUNC_QUALIFIER void packHalf(vec<L, float, Q> const* v, vec<L, uint16, Q>* p, std::size_t count)
+	{
+		if(sizeof(vec<L, float, Q>) == sizeof(float) * L && sizeof(vec<L, uint16, Q>) == sizeof(uint16) * L)
+			detail::compute_half_batch<float>::pack(reinterpret_cast<float const*>(v), reinterpret_cast<uint16*>(p), count * L);
+		else
+			for(std::size_t i = 0; i < count; ++i)
+				detail::compute_half_batch<float>::pack(&v[i].x, &p[i].x, L);
+	}
+
+	template<length_t L, qualifier Q>
+	GLM_FUNC_QUALIFIER void unpackHalf(vec<L, uint16, Q> const* p, vec<L, float, Q>* v, std::size_t count)
+	{
+		if(sizeof(vec<L, float, Q>) == sizeof(float) * L && sizeof(vec<L, uint16, Q>) == sizeof(uint16) * L)
+			detail::compute_half_batch<float>::unpack(reinterpret_cast<uint16 const*>(p), reinterpret_cast<float*>(v), count * L);
+		else
+			for(std::size_t i = 0; i < count; ++i)
+				detail::compute_half_batch<float>::unpack(&p[i].x, &v[i].x, L);
+	}
+
+	template<typename uintType, length_t L, typename floatType, qualifier Q>
+	GLM_FUNC_QUALIFIER void packUnorm(vec<L, floatType, Q> const* v, vec<L, uintType, Q>* p, std::size_t count)
+	{
+		GLM_STATIC_ASSERT(std::numeric_limits<uintType>::is_integer, "uintType must be an integer type");
+		GLM_STATIC_ASSERT(std::numeric_limits<floatType>::is_iec559, "floatType must be a floating point type");
+
+		if(sizeof(vec<L, floatType, Q>) == sizeof(floatType) * L && sizeof(vec<L, uintType, Q>) == sizeof(uintType) * L)
+			detail::compute_unorm_batch<uintType, floatType>::pack(reinterpret_cast<floatType const*>(v), reinterpret_cast<uintType*>(p), count * L);
+		else
+			for(std::size_t i = 0; i < count; ++i)
+				detail::compute_unorm_batch<uintType, floatType>::pack(&v[i].x, &p[i].x, L);
+	}
+
+	template<typename floatType, length_t L, typename uintType, qualifier Q>
+	GLM_FUNC_QUALIFIER void unpackUnorm(vec<L, uintType, Q> const* p, vec<L, floatType, Q>* v, std::size_t count)
+	{
+		GLM_STATIC_ASSERT(std::numeric_limits<uintType>::is_integer, "uintType must be an integer type");
+		GLM_STATIC_ASSERT(std::numeric_limits<floatType>::is_iec559, "floatType must be a floating point type");
+
+		if(sizeof(vec<L, floatType, Q>) == sizeof(floatType) * L && sizeof(vec<L, uintType, Q>) == sizeof(uintType) * L)
+			detail::compute_unorm_batch<uintType, floatType>::unpack(reinterpret_cast<uintType const*>(p), reinterpret_cast<floatType*>(v), count * L);
+		else
+			for(std::size_t i = 0; i < count; ++i)
+				detail::compute_unorm_batch<uintType, floatType>::unpack(&p[i].x, &v[i].x, L);
+	}
+
+	template<typename intType, length_t L, typename floatType, qualifier Q>
+	GLM_FUNC_QUALIFIER void packSnorm(vec<L, floatType, Q> const* v, vec<L, intType, Q>* p, std::size_t count)
+	{
+		GLM_STATIC_ASSERT(std::numeric_limits<intType>::is_integer, "intType must be an integer type");
+		GLM_STATIC_ASSERT(std::numeric_limits<floatType>::is_iec559, "floatType must be a floating point type");
+
+		if(sizeof(vec<L, floatType, Q>) == sizeof(floatType) * L && sizeof(vec<L, intType, Q>) == sizeof(intType) * L)
+			detail::compute_snorm_batch<intType, floatType>::pack(reinterpret_cast<floatType const*>(v), reinterpret_cast<intType*>(p), count * L);
+		else
+			for(std::size_t i = 0; i < count; ++i)
+				detail::compute_snorm_batch<intType, floatType>::pack(&v[i].x, &p[i].x, L);
+	}
+
+	template<typename floatType, length_t L, typename intType, qualifier Q>
+	GLM_FUNC_QUALIFIER void unpackSnorm(vec<L, intType, Q> const* p, vec<L, floatType, Q>* v, std::size_t count)
+	{
+		GLM_STATIC_ASSERT(std::numeric_limits<intType>::is_integer, "intType must be an integer type");
+		GLM_STATIC_ASSERT(std::numeric_limits<floatType>::is_iec559, "floatType must be a floating point type");
+
+		if(sizeof(vec<L, floatType, Q>) == sizeof(floatType) * L && sizeof(vec<L, intType, Q>) == sizeof(intType) * L)
+			detail::compute_snorm_batch<intType, floatType>::unpack(reinterpret_cast<intType const*>(p), reinterpret_cast<floatType*>(v), count * L);
+		else
+			for(std::size_t i = 0; i < count; ++i)
+				detail::compute_snorm_batch<intType, floatType>::unpack(&p[i].x, &v[i].x, L);
+	}
+
 	GLM_FUNC_QUALIFIER uint8 packUnorm2x4(vec2 const& v)
 	{
 		u32vec2 const Unpack(round(clamp(v, 0.0f, 1.0f) * 15.0f));
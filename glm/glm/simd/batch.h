@@ -0,0 +1,393 @@
+/// @ref simd
+/// @file glm/simd/batch.h
+
+#pragma once
+
+#include "dispatch.h"
+
+#if (GLM_ARCH | GLM_ARCH_DISPATCH) & GLM_ARCH_AVX2_BIT
+
+// Splits 8 packed xyz triplets into one register of x, one of y and one of z
+GLM_FUNC_AVX2 void glm_vec3x8_load(float const* in, glm_f32vec8 out[3])
+{
+	glm_f32vec8 const a = _mm256_loadu_ps(in);
+	glm_f32vec8 const b = _mm256_loadu_ps(in + 8);
+	glm_f32vec8 const c = _mm256_loadu_ps(in + 16);
+
+	// Each component sits at distinct lanes of a, b and c, so two blends gather it and a permute sorts it
+	glm_f32vec8 const x = _mm256_blend_ps(_mm256_blend_ps(a, b, 0x92), c, 0x24);
+	glm_f32vec8 const y = _mm256_blend_ps(_mm256_blend_ps(a, b, 0x24), c, 0x49);
+	glm_f32vec8 const z = _mm256_blend_ps(_mm256_blend_ps(a, b, 0x49), c, 0x92);
+
+	out[0] = _mm256_permutevar8x32_ps(x, _mm256_setr_epi32(0, 3, 6, 1, 4, 7, 2, 5));
+	out[1] = _mm256_permutevar8x32_ps(y, _mm256_setr_epi32(1, 4, 7, 2, 5, 0, 3, 6));
+	out[2] = _mm256_permutevar8x32_ps(z, _mm256_setr_epi32(2, 5, 0, 3, 6, 1, 4, 7));
+}
+
+// Inverse of glm_vec3x8_load
+GLM_FUNC_AVX2 void glm_vec3x8_store(glm_f32vec8 const in[3], float* out)
+{
+	glm_f32vec8 const x = _mm256_permutevar8x32_ps(in[0], _mm256_setr_epi32(0, 3, 6, 1, 4, 7, 2, 5));
+	glm_f32vec8 const y = _mm256_permutevar8x32_ps(in[1], _mm256_setr_epi32(5, 0, 3, 6, 1, 4, 7, 2));
+	glm_f32vec8 const z = _mm256_permutevar8x32_ps(in[2], _mm256_setr_epi32(2, 5, 0, 3, 6, 1, 4, 7));
+
+	_mm256_storeu_ps(out, _mm256_blend_ps(_mm256_blend_ps(x, y, 0x92), z, 0x24));
+	_mm256_storeu_ps(out + 8, _mm256_blend_ps(_mm256_blend_ps(x, y, 0x24), z, 0x49));
+	_mm256_storeu_ps(out + 16, _mm256_blend_ps(_mm256_blend_ps(x, y, 0x49), z, 0x92));
+}
+
+// m holds the 16 matrix components broadcast, column major, with the last column already scaled by w.
+// Sums in the order of the scalar mat4 * vec4 operator.
+GLM_FUNC_AVX2 void glm_mat4_mul_vec3x8(glm_f32vec8 const m[16], glm_f32vec8 const in[3], glm_f32vec8 out[3])
+{
+	for(int i = 0; i < 3; ++i)
+	{
+		glm_f32vec8 const add0 = _mm256_add_ps(_mm256_mul_ps(m[i], in[0]), _mm256_mul_ps(m[4 + i], in[1]));
+		glm_f32vec8 const add1 = _mm256_add_ps(_mm256_mul_ps(m[8 + i], in[2]), m[12 + i]);
+		out[i] = _mm256_add_ps(add0, add1);
+	}
+}
+
+// Lane-wise product of 8 pairs of matrices, each component in a register of its own, column major.
+// Sums in the order of the scalar mat4 * mat4 operator, like glm_mat4_mul_avx2 and glm_mat4_mul_avx512.
+GLM_FUNC_AVX2 void glm_mat4x8_mul(glm_f32vec8 const in1[16], glm_f32vec8 const in2[16], glm_f32vec8 out[16])
+{
+	for(int c = 0; c < 4; ++c)
+	for(int r = 0; r < 4; ++r)
+	{
+		glm_f32vec8 const add0 = _mm256_add_ps(_mm256_mul_ps(in1[r], in2[c * 4]), _mm256_mul_ps(in1[4 + r], in2[c * 4 + 1]));
+		glm_f32vec8 const add1 = _mm256_add_ps(add0, _mm256_mul_ps(in1[8 + r], in2[c * 4 + 2]));
+		out[c * 4 + r] = _mm256_add_ps(add1, _mm256_mul_ps(in1[12 + r], in2[c * 4 + 3]));
+	}
+}
+
+// Product of two column major matrices, two columns per register
+GLM_FUNC_AVX2 void glm_mat4_mul_avx2(float const in1[16], float const in2[16], float out[16])
+{
+	glm_f32vec8 const a0 = _mm256_broadcast_ps(reinterpret_cast<__m128 const*>(in1));
+	glm_f32vec8 const a1 = _mm256_broadcast_ps(reinterpret_cast<__m128 const*>(in1 + 4));
+	glm_f32vec8 const a2 = _mm256_broadcast_ps(reinterpret_cast<__m128 const*>(in1 + 8));
+	glm_f32vec8 const a3 = _mm256_broadcast_ps(reinterpret_cast<__m128 const*>(in1 + 12));
+
+	for(int i = 0; i < 16; i += 8)
+	{
+		glm_f32vec8 const b = _mm256_loadu_ps(in2 + i);
+		glm_f32vec8 const add0 = _mm256_add_ps(
+			_mm256_mul_ps(a0, _mm256_permute_ps(b, _MM_SHUFFLE(0, 0, 0, 0))),
+			_mm256_mul_ps(a1, _mm256_permute_ps(b, _MM_SHUFFLE(1, 1, 1, 1))));
+		glm_f32vec8 const add1 = _mm256_add_ps(add0, _mm256_mul_ps(a2, _mm256_permute_ps(b, _MM_SHUFFLE(2, 2, 2, 2))));
+		_mm256_storeu_ps(out + i, _mm256_add_ps(add1, _mm256_mul_ps(a3, _mm256_permute_ps(b, _MM_SHUFFLE(3, 3, 3, 3)))));
+	}
+}
+
+// Loads two consecutive column major matrices: column i of the first in the low half of out[i], of the second in the high half
+GLM_FUNC_AVX2 void glm_mat4_load_avx2(float const in[32], glm_f32vec8 out[4])
+{
+	glm_f32vec8 const a = _mm256_loadu_ps(in);
+	glm_f32vec8 const b = _mm256_loadu_ps(in + 8);
+	glm_f32vec8 const c = _mm256_loadu_ps(in + 16);
+	glm_f32vec8 const d = _mm256_loadu_ps(in + 24);
+
+	out[0] = _mm256_permute2f128_ps(a, c, 0x20);
+	out[1] = _mm256_permute2f128_ps(a, c, 0x31);
+	out[2] = _mm256_permute2f128_ps(b, d, 0x20);
+	out[3] = _mm256_permute2f128_ps(b, d, 0x31);
+}
+
+// Inverse of glm_mat4_load_avx2
+GLM_FUNC_AVX2 void glm_mat4_store_avx2(glm_f32vec8 const in[4], float out[32])
+{
+	_mm256_storeu_ps(out, _mm256_permute2f128_ps(in[0], in[1], 0x20));
+	_mm256_storeu_ps(out + 8, _mm256_permute2f128_ps(in[2], in[3], 0x20));
+	_mm256_storeu_ps(out + 16, _mm256_permute2f128_ps(in[0], in[1], 0x31));
+	_mm256_storeu_ps(out + 24, _mm256_permute2f128_ps(in[2], in[3], 0x31));
+}
+
+// SubFactor products of the rows i and j of the last three columns, as Fac0 to Fac5 in glm_mat4_inverse
+template<int i, int j>
+GLM_FUNC_AVX2 glm_f32vec8 glm_mat4_subfactor_avx2(glm_f32vec8 const in[4])
+{
+	glm_f32vec8 const Swp0a = _mm256_shuffle_ps(in[3], in[2], _MM_SHUFFLE(j, j, j, j));
+	glm_f32vec8 const Swp0b = _mm256_shuffle_ps(in[3], in[2], _MM_SHUFFLE(i, i, i, i));
+
+	glm_f32vec8 const Swp00 = _mm256_shuffle_ps(in[2], in[1], _MM_SHUFFLE(i, i, i, i));
+	glm_f32vec8 const Swp01 = _mm256_shuffle_ps(Swp0a, Swp0a, _MM_SHUFFLE(2, 0, 0, 0));
+	glm_f32vec8 const Swp02 = _mm256_shuffle_ps(Swp0b, Swp0b, _MM_SHUFFLE(2, 0, 0, 0));
+	glm_f32vec8 const Swp03 = _mm256_shuffle_ps(in[2], in[1], _MM_SHUFFLE(j, j, j, j));
+
+	return _mm256_sub_ps(_mm256_mul_ps(Swp00, Swp01), _mm256_mul_ps(Swp02, Swp03));
+}
+
+// (m[1][k], m[0][k], m[0][k], m[0][k]), as Vec0 to Vec3 in glm_mat4_inverse
+template<int k>
+GLM_FUNC_AVX2 glm_f32vec8 glm_mat4_cofactor_row_avx2(glm_f32vec8 const in[4])
+{
+	glm_f32vec8 const Temp = _mm256_shuffle_ps(in[1], in[0], _MM_SHUFFLE(k, k, k, k));
+	return _mm256_shuffle_ps(Temp, Temp, _MM_SHUFFLE(2, 2, 2, 0));
+}
+
+// Adjugates of the two matrices laid out by glm_mat4_load_avx2, computed as the scalar mat4 inverse computes them
+GLM_FUNC_AVX2 void glm_mat4_adjugate_avx2(glm_f32vec8 const in[4], glm_f32vec8 out[4])
+{
+	glm_f32vec8 const Fac0 = glm_mat4_subfactor_avx2<2, 3>(in);
+	glm_f32vec8 const Fac1 = glm_mat4_subfactor_avx2<1, 3>(in);
+	glm_f32vec8 const Fac2 = glm_mat4_subfactor_avx2<1, 2>(in);
+	glm_f32vec8 const Fac3 = glm_mat4_subfactor_avx2<0, 3>(in);
+	glm_f32vec8 const Fac4 = glm_mat4_subfactor_avx2<0, 2>(in);
+	glm_f32vec8 const Fac5 = glm_mat4_subfactor_avx2<0, 1>(in);
+
+	glm_f32vec8 const Vec0 = glm_mat4_cofactor_row_avx2<0>(in);
+	glm_f32vec8 const Vec1 = glm_mat4_cofactor_row_avx2<1>(in);
+	glm_f32vec8 const Vec2 = glm_mat4_cofactor_row_avx2<2>(in);
+	glm_f32vec8 const Vec3 = glm_mat4_cofactor_row_avx2<3>(in);
+
+	glm_f32vec8 const SignA = _mm256_setr_ps(1.0f,-1.0f, 1.0f,-1.0f, 1.0f,-1.0f, 1.0f,-1.0f);
+	glm_f32vec8 const SignB = _mm256_setr_ps(-1.0f, 1.0f,-1.0f, 1.0f,-1.0f, 1.0f,-1.0f, 1.0f);
+
+	out[0] = _mm256_mul_ps(SignA, _mm256_add_ps(_mm256_sub_ps(_mm256_mul_ps(Vec1, Fac0), _mm256_mul_ps(Vec2, Fac1)), _mm256_mul_ps(Vec3, Fac2)));
+	out[1] = _mm256_mul_ps(SignB, _mm256_add_ps(_mm256_sub_ps(_mm256_mul_ps(Vec0, Fac0), _mm256_mul_ps(Vec2, Fac3)), _mm256_mul_ps(Vec3, Fac4)));
+	out[2] = _mm256_mul_ps(SignA, _mm256_add_ps(_mm256_sub_ps(_mm256_mul_ps(Vec0, Fac1), _mm256_mul_ps(Vec1, Fac3)), _mm256_mul_ps(Vec3, Fac5)));
+	out[3] = _mm256_mul_ps(SignB, _mm256_add_ps(_mm256_sub_ps(_mm256_mul_ps(Vec0, Fac2), _mm256_mul_ps(Vec1, Fac4)), _mm256_mul_ps(Vec2, Fac5)));
+}
+
+// Products of the first column of the matrices and the first row of their adjugates, whose sum is the determinant
+GLM_FUNC_AVX2 glm_f32vec8 glm_mat4_cofactor_products_avx2(glm_f32vec8 const in[4], glm_f32vec8 const adjugate[4])
+{
+	glm_f32vec8 const Row0 = _mm256_shuffle_ps(adjugate[0], adjugate[1], _MM_SHUFFLE(0, 0, 0, 0));
+	glm_f32vec8 const Row1 = _mm256_shuffle_ps(adjugate[2], adjugate[3], _MM_SHUFFLE(0, 0, 0, 0));
+	return _mm256_mul_ps(in[0], _mm256_shuffle_ps(Row0, Row1, _MM_SHUFFLE(2, 0, 2, 0)));
+}
+
+// Determinants of the two matrices laid out by glm_mat4_load_avx2, broadcast in their half.
+// Sums in the order of the scalar mat4 determinant.
+GLM_FUNC_AVX2 glm_f32vec8 glm_mat4_determinant_avx2(glm_f32vec8 const in[4])
+{
+	glm_f32vec8 Adjugate[4];
+	glm_mat4_adjugate_avx2(in, Adjugate);
+	glm_f32vec8 const Mul = glm_mat4_cofactor_products_avx2(in, Adjugate);
+
+	glm_f32vec8 const Add0 = _mm256_add_ps(_mm256_shuffle_ps(Mul, Mul, _MM_SHUFFLE(0, 0, 0, 0)), _mm256_shuffle_ps(Mul, Mul, _MM_SHUFFLE(1, 1, 1, 1)));
+	glm_f32vec8 const Add1 = _mm256_add_ps(Add0, _mm256_shuffle_ps(Mul, Mul, _MM_SHUFFLE(2, 2, 2, 2)));
+	return _mm256_add_ps(Add1, _mm256_shuffle_ps(Mul, Mul, _MM_SHUFFLE(3, 3, 3, 3)));
+}
+
+// Inverses of the two matrices laid out by glm_mat4_load_avx2.
+// Sums in the order of the scalar mat4 inverse.
+GLM_FUNC_AVX2 void glm_mat4_inverse_avx2(glm_f32vec8 const in[4], glm_f32vec8 out[4])
+{
+	glm_f32vec8 Adjugate[4];
+	glm_mat4_adjugate_avx2(in, Adjugate);
+	glm_f32vec8 const Mul = glm_mat4_cofactor_products_avx2(in, Adjugate);
+
+	glm_f32vec8 const Add0 = _mm256_add_ps(Mul, _mm256_shuffle_ps(Mul, Mul, _MM_SHUFFLE(2, 3, 0, 1)));
+	glm_f32vec8 const Det = _mm256_add_ps(Add0, _mm256_shuffle_ps(Add0, Add0, _MM_SHUFFLE(0, 1, 2, 3)));
+	glm_f32vec8 const Rcp = _mm256_div_ps(_mm256_set1_ps(1.0f), Det);
+
+	for(int i = 0; i < 4; ++i)
+		out[i] = _mm256_mul_ps(Adjugate[i], Rcp);
+}
+
+#endif//(GLM_ARCH | GLM_ARCH_DISPATCH) & GLM_ARCH_AVX2_BIT
+
+#if (GLM_ARCH | GLM_ARCH_DISPATCH) & GLM_ARCH_AVX512_BIT
+
+// GCC 12 reports the _mm512_undefined_ps of its AVX-512 intrinsics as uninitialized once they are inlined in the kernels
+#if (GLM_COMPILER & GLM_COMPILER_GCC) && !(GLM_COMPILER & GLM_COMPILER_CLANG)
+#	pragma GCC diagnostic push
+#	pragma GCC diagnostic ignored "-Wuninitialized"
+#	pragma GCC diagnostic ignored "-Wmaybe-uninitialized"
+#endif
+
+// Splits 16 packed xyz triplets into one register of x, one of y and one of z
+GLM_FUNC_AVX512 void glm_vec3x16_load(float const* in, glm_f32vec16 out[3])
+{
+	glm_f32vec16 const a = _mm512_loadu_ps(in);
+	glm_f32vec16 const b = _mm512_loadu_ps(in + 16);
+	glm_f32vec16 const c = _mm512_loadu_ps(in + 32);
+
+	// Component k of lane i is float 3 * i + k: the first 32 floats come from a and b, the rest from c,
+	// where permutexvar only looks at the low 4 bits of the same index
+	__m512i const x = _mm512_setr_epi32(0, 3, 6, 9, 12, 15, 18, 21, 24, 27, 30, 33, 36, 39, 42, 45);
+	__m512i const y = _mm512_setr_epi32(1, 4, 7, 10, 13, 16, 19, 22, 25, 28, 31, 34, 37, 40, 43, 46);
+	__m512i const z = _mm512_setr_epi32(2, 5, 8, 11, 14, 17, 20, 23, 26, 29, 32, 35, 38, 41, 44, 47);
+
+	out[0] = _mm512_mask_permutexvar_ps(_mm512_permutex2var_ps(a, x, b), 0xF800, x, c);
+	out[1] = _mm512_mask_permutexvar_ps(_mm512_permutex2var_ps(a, y, b), 0xF800, y, c);
+	out[2] = _mm512_mask_permutexvar_ps(_mm512_permutex2var_ps(a, z, b), 0xFC00, z, c);
+}
+
+// Inverse of glm_vec3x16_load
+GLM_FUNC_AVX512 void glm_vec3x16_store(glm_f32vec16 const in[3], float* out)
+{
+	// x lanes are picked by indices below 16, y lanes by 16 and above, z lanes by the masked second permute
+	__m512i const a = _mm512_setr_epi32(0, 16, 0, 1, 17, 1, 2, 18, 2, 3, 19, 3, 4, 20, 4, 5);
+	__m512i const b = _mm512_setr_epi32(21, 5, 6, 22, 6, 7, 23, 7, 8, 24, 8, 9, 25, 9, 10, 26);
+	__m512i const c = _mm512_setr_epi32(10, 11, 27, 11, 12, 28, 12, 13, 29, 13, 14, 30, 14, 15, 31, 15);
+
+	_mm512_storeu_ps(out, _mm512_mask_permutexvar_ps(_mm512_permutex2var_ps(in[0], a, in[1]), 0x4924, a, in[2]));
+	_mm512_storeu_ps(out + 16, _mm512_mask_permutexvar_ps(_mm512_permutex2var_ps(in[0], b, in[1]), 0x2492, b, in[2]));
+	_mm512_storeu_ps(out + 32, _mm512_mask_permutexvar_ps(_mm512_permutex2var_ps(in[0], c, in[1]), 0x9249, c, in[2]));
+}
+
+// 16 lane version of glm_mat4_mul_vec3x8
+GLM_FUNC_AVX512 void glm_mat4_mul_vec3x16(glm_f32vec16 const m[16], glm_f32vec16 const in[3], glm_f32vec16 out[3])
+{
+	for(int i = 0; i < 3; ++i)
+	{
+		glm_f32vec16 const add0 = _mm512_add_ps(_mm512_mul_ps(m[i], in[0]), _mm512_mul_ps(m[4 + i], in[1]));
+		glm_f32vec16 const add1 = _mm512_add_ps(_mm512_mul_ps(m[8 + i], in[2]), m[12 + i]);
+		out[i] = _mm512_add_ps(add0, add1);
+	}
+}
+
+// 16 lane version of glm_mat4x8_mul
+GLM_FUNC_AVX512 void glm_mat4x16_mul(glm_f32vec16 const in1[16], glm_f32vec16 const in2[16], glm_f32vec16 out[16])
+{
+	for(int c = 0; c < 4; ++c)
+	for(int r = 0; r < 4; ++r)
+	{
+		glm_f32vec16 const add0 = _mm512_add_ps(_mm512_mul_ps(in1[r], in2[c * 4]), _mm512_mul_ps(in1[4 + r], in2[c * 4 + 1]));
+		glm_f32vec16 const add1 = _mm512_add_ps(add0, _mm512_mul_ps(in1[8 + r], in2[c * 4 + 2]));
+		out[c * 4 + r] = _mm512_add_ps(add1, _mm512_mul_ps(in1[12 + r], in2[c * 4 + 3]));
+	}
+}
+
+// Product of two column major matrices, the whole matrix in one register
+GLM_FUNC_AVX512 void glm_mat4_mul_avx512(float const in1[16], float const in2[16], float out[16])
+{
+	glm_f32vec16 const a0 = _mm512_broadcast_f32x4(_mm_loadu_ps(in1));
+	glm_f32vec16 const a1 = _mm512_broadcast_f32x4(_mm_loadu_ps(in1 + 4));
+	glm_f32vec16 const a2 = _mm512_broadcast_f32x4(_mm_loadu_ps(in1 + 8));
+	glm_f32vec16 const a3 = _mm512_broadcast_f32x4(_mm_loadu_ps(in1 + 12));
+	glm_f32vec16 const b = _mm512_loadu_ps(in2);
+
+	glm_f32vec16 const add0 = _mm512_add_ps(
+		_mm512_mul_ps(a0, _mm512_permute_ps(b, _MM_SHUFFLE(0, 0, 0, 0))),
+		_mm512_mul_ps(a1, _mm512_permute_ps(b, _MM_SHUFFLE(1, 1, 1, 1))));
+	glm_f32vec16 const add1 = _mm512_add_ps(add0, _mm512_mul_ps(a2, _mm512_permute_ps(b, _MM_SHUFFLE(2, 2, 2, 2))));
+	_mm512_storeu_ps(out, _mm512_add_ps(add1, _mm512_mul_ps(a3, _mm512_permute_ps(b, _MM_SHUFFLE(3, 3, 3, 3)))));
+}
+
+// Loads four consecutive column major matrices: column i of the matrix j in the 128 bit lane j of out[i]
+GLM_FUNC_AVX512 void glm_mat4_load_avx512(float const in[64], glm_f32vec16 out[4])
+{
+	glm_f32vec16 const a = _mm512_loadu_ps(in);
+	glm_f32vec16 const b = _mm512_loadu_ps(in + 16);
+	glm_f32vec16 const c = _mm512_loadu_ps(in + 32);
+	glm_f32vec16 const d = _mm512_loadu_ps(in + 48);
+
+	// Transposes the 4 by 4 blocks of columns
+	glm_f32vec16 const ab01 = _mm512_shuffle_f32x4(a, b, _MM_SHUFFLE(1, 0, 1, 0));
+	glm_f32vec16 const ab23 = _mm512_shuffle_f32x4(a, b, _MM_SHUFFLE(3, 2, 3, 2));
+	glm_f32vec16 const cd01 = _mm512_shuffle_f32x4(c, d, _MM_SHUFFLE(1, 0, 1, 0));
+	glm_f32vec16 const cd23 = _mm512_shuffle_f32x4(c, d, _MM_SHUFFLE(3, 2, 3, 2));
+
+	out[0] = _mm512_shuffle_f32x4(ab01, cd01, _MM_SHUFFLE(2, 0, 2, 0));
+	out[1] = _mm512_shuffle_f32x4(ab01, cd01, _MM_SHUFFLE(3, 1, 3, 1));
+	out[2] = _mm512_shuffle_f32x4(ab23, cd23, _MM_SHUFFLE(2, 0, 2, 0));
+	out[3] = _mm512_shuffle_f32x4(ab23, cd23, _MM_SHUFFLE(3, 1, 3, 1));
+}
+
+// Inverse of glm_mat4_load_avx512
+GLM_FUNC_AVX512 void glm_mat4_store_avx512(glm_f32vec16 const in[4], float out[64])
+{
+	glm_f32vec16 const c01 = _mm512_shuffle_f32x4(in[0], in[1], _MM_SHUFFLE(1, 0, 1, 0));
+	glm_f32vec16 const c23 = _mm512_shuffle_f32x4(in[2], in[3], _MM_SHUFFLE(1, 0, 1, 0));
+	glm_f32vec16 const d01 = _mm512_shuffle_f32x4(in[0], in[1], _MM_SHUFFLE(3, 2, 3, 2));
+	glm_f32vec16 const d23 = _mm512_shuffle_f32x4(in[2], in[3], _MM_SHUFFLE(3, 2, 3, 2));
+
+	_mm512_storeu_ps(out, _mm512_shuffle_f32x4(c01, c23, _MM_SHUFFLE(2, 0, 2, 0)));
+	_mm512_storeu_ps(out + 16, _mm512_shuffle_f32x4(c01, c23, _MM_SHUFFLE(3, 1, 3, 1)));
+	_mm512_storeu_ps(out + 32, _mm512_shuffle_f32x4(d01, d23, _MM_SHUFFLE(2, 0, 2, 0)));
+	_mm512_storeu_ps(out + 48, _mm512_shuffle_f32x4(d01, d23, _MM_SHUFFLE(3, 1, 3, 1)));
+}
+
+// 16 lane version of glm_mat4_subfactor_avx2
+template<int i, int j>
+GLM_FUNC_AVX512 glm_f32vec16 glm_mat4_subfactor_avx512(glm_f32vec16 const in[4])
+{
+	glm_f32vec16 const Swp0a = _mm512_shuffle_ps(in[3], in[2], _MM_SHUFFLE(j, j, j, j));
+	glm_f32vec16 const Swp0b = _mm512_shuffle_ps(in[3], in[2], _MM_SHUFFLE(i, i, i, i));
+
+	glm_f32vec16 const Swp00 = _mm512_shuffle_ps(in[2], in[1], _MM_SHUFFLE(i, i, i, i));
+	glm_f32vec16 const Swp01 = _mm512_shuffle_ps(Swp0a, Swp0a, _MM_SHUFFLE(2, 0, 0, 0));
+	glm_f32vec16 const Swp02 = _mm512_shuffle_ps(Swp0b, Swp0b, _MM_SHUFFLE(2, 0, 0, 0));
+	glm_f32vec16 const Swp03 = _mm512_shuffle_ps(in[2], in[1], _MM_SHUFFLE(j, j, j, j));
+
+	return _mm512_sub_ps(_mm512_mul_ps(Swp00, Swp01), _mm512_mul_ps(Swp02, Swp03));
+}
+
+// 16 lane version of glm_mat4_cofactor_row_avx2
+template<int k>
+GLM_FUNC_AVX512 glm_f32vec16 glm_mat4_cofactor_row_avx512(glm_f32vec16 const in[4])
+{
+	glm_f32vec16 const Temp = _mm512_shuffle_ps(in[1], in[0], _MM_SHUFFLE(k, k, k, k));
+	return _mm512_shuffle_ps(Temp, Temp, _MM_SHUFFLE(2, 2, 2, 0));
+}
+
+// 16 lane version of glm_mat4_adjugate_avx2, for the four matrices laid out by glm_mat4_load_avx512
+GLM_FUNC_AVX512 void glm_mat4_adjugate_avx512(glm_f32vec16 const in[4], glm_f32vec16 out[4])
+{
+	glm_f32vec16 const Fac0 = glm_mat4_subfactor_avx512<2, 3>(in);
+	glm_f32vec16 const Fac1 = glm_mat4_subfactor_avx512<1, 3>(in);
+	glm_f32vec16 const Fac2 = glm_mat4_subfactor_avx512<1, 2>(in);
+	glm_f32vec16 const Fac3 = glm_mat4_subfactor_avx512<0, 3>(in);
+	glm_f32vec16 const Fac4 = glm_mat4_subfactor_avx512<0, 2>(in);
+	glm_f32vec16 const Fac5 = glm_mat4_subfactor_avx512<0, 1>(in);
+
+	glm_f32vec16 const Vec0 = glm_mat4_cofactor_row_avx512<0>(in);
+	glm_f32vec16 const Vec1 = glm_mat4_cofactor_row_avx512<1>(in);
+	glm_f32vec16 const Vec2 = glm_mat4_cofactor_row_avx512<2>(in);
+	glm_f32vec16 const Vec3 = glm_mat4_cofactor_row_avx512<3>(in);
+
+	glm_f32vec16 const SignA = _mm512_broadcast_f32x4(_mm_setr_ps(1.0f,-1.0f, 1.0f,-1.0f));
+	glm_f32vec16 const SignB = _mm512_broadcast_f32x4(_mm_setr_ps(-1.0f, 1.0f,-1.0f, 1.0f));
+
+	out[0] = _mm512_mul_ps(SignA, _mm512_add_ps(_mm512_sub_ps(_mm512_mul_ps(Vec1, Fac0), _mm512_mul_ps(Vec2, Fac1)), _mm512_mul_ps(Vec3, Fac2)));
+	out[1] = _mm512_mul_ps(SignB, _mm512_add_ps(_mm512_sub_ps(_mm512_mul_ps(Vec0, Fac0), _mm512_mul_ps(Vec2, Fac3)), _mm512_mul_ps(Vec3, Fac4)));
+	out[2] = _mm512_mul_ps(SignA, _mm512_add_ps(_mm512_sub_ps(_mm512_mul_ps(Vec0, Fac1), _mm512_mul_ps(Vec1, Fac3)), _mm512_mul_ps(Vec3, Fac5)));
+	out[3] = _mm512_mul_ps(SignB, _mm512_add_ps(_mm512_sub_ps(_mm512_mul_ps(Vec0, Fac2), _mm512_mul_ps(Vec1, Fac4)), _mm512_mul_ps(Vec2, Fac5)));
+}
+
+// 16 lane version of glm_mat4_cofactor_products_avx2
+GLM_FUNC_AVX512 glm_f32vec16 glm_mat4_cofactor_products_avx512(glm_f32vec16 const in[4], glm_f32vec16 const adjugate[4])
+{
+	glm_f32vec16 const Row0 = _mm512_shuffle_ps(adjugate[0], adjugate[1], _MM_SHUFFLE(0, 0, 0, 0));
+	glm_f32vec16 const Row1 = _mm512_shuffle_ps(adjugate[2], adjugate[3], _MM_SHUFFLE(0, 0, 0, 0));
+	return _mm512_mul_ps(in[0], _mm512_shuffle_ps(Row0, Row1, _MM_SHUFFLE(2, 0, 2, 0)));
+}
+
+// Determinants of the four matrices laid out by glm_mat4_load_avx512.
+// Sums in the order of the scalar mat4 determinant.
+GLM_FUNC_AVX512 glm_vec4 glm_mat4_determinant_avx512(glm_f32vec16 const in[4])
+{
+	glm_f32vec16 Adjugate[4];
+	glm_mat4_adjugate_avx512(in, Adjugate);
+	glm_f32vec16 const Mul = glm_mat4_cofactor_products_avx512(in, Adjugate);
+
+	glm_f32vec16 const Add0 = _mm512_add_ps(_mm512_shuffle_ps(Mul, Mul, _MM_SHUFFLE(0, 0, 0, 0)), _mm512_shuffle_ps(Mul, Mul, _MM_SHUFFLE(1, 1, 1, 1)));
+	glm_f32vec16 const Add1 = _mm512_add_ps(Add0, _mm512_shuffle_ps(Mul, Mul, _MM_SHUFFLE(2, 2, 2, 2)));
+	glm_f32vec16 const Det = _mm512_add_ps(Add1, _mm512_shuffle_ps(Mul, Mul, _MM_SHUFFLE(3, 3, 3, 3)));
+	return _mm512_castps512_ps128(_mm512_permutexvar_ps(_mm512_setr_epi32(0, 4, 8, 12, 0, 4, 8, 12, 0, 4, 8, 12, 0, 4, 8, 12), Det));
+}
+
+// 16 lane version of glm_mat4_inverse_avx2
+GLM_FUNC_AVX512 void glm_mat4_inverse_avx512(glm_f32vec16 const in[4], glm_f32vec16 out[4])
+{
+	glm_f32vec16 Adjugate[4];
+	glm_mat4_adjugate_avx512(in, Adjugate);
+	glm_f32vec16 const Mul = glm_mat4_cofactor_products_avx512(in, Adjugate);
+
+	glm_f32vec16 const Add0 = _mm512_add_ps(Mul, _mm512_shuffle_ps(Mul, Mul, _MM_SHUFFLE(2, 3, 0, 1)));
+	glm_f32vec16 const Det = _mm512_add_ps(Add0, _mm512_shuffle_ps(Add0, Add0, _MM_SHUFFLE(0, 1, 2, 3)));
+	glm_f32vec16 const Rcp = _mm512_div_ps(_mm512_set1_ps(1.0f), Det);
+
+	for(int i = 0; i < 4; ++i)
+		out[i] = _mm512_mul_ps(Adjugate[i], Rcp);
+}
+
+#if (GLM_COMPILER & GLM_COMPILER_GCC) && !(GLM_COMPILER & GLM_COMPILER_CLANG)
+#	pragma GCC diagnostic pop
+#endif
+
+#endif//(GLM_ARCH | GLM_ARCH_DISPATCH) & GLM_ARCH_AVX512_BIT
@@ -0,0 +1,99 @@
+/// @ref simd
+/// @file glm/simd/dispatch.h
+
+#pragma once
+
+#include "platform.h"
+
+// Qualifiers of the kernels using instruction sets of GLM_ARCH_DISPATCH: the compiler generates them for these
+// instruction sets whatever the build target, and they may only run after glm_arch_runtime reported them.
+#if (GLM_ARCH_DISPATCH & GLM_ARCH_AVX2_BIT) && !(GLM_COMPILER & GLM_COMPILER_VC)
+#	define GLM_FUNC_AVX2 inline __attribute__((target("avx2")))
+#else
+#	define GLM_FUNC_AVX2 GLM_FUNC_QUALIFIER
+#endif
+
+#if (GLM_ARCH_DISPATCH & GLM_ARCH_AVX512_BIT) && !(GLM_COMPILER & GLM_COMPILER_VC)
+#	define GLM_FUNC_AVX512 inline __attribute__((target("avx2,avx512f")))
+#else
+#	define GLM_FUNC_AVX512 GLM_FUNC_QUALIFIER
+#endif
+
+#if GLM_ARCH_DISPATCH
+
+#if GLM_COMPILER & GLM_COMPILER_VC
+#	include <intrin.h>
+#else
+#	include <cpuid.h>
+#endif
+
+// GLM_ARCH with the instruction sets of GLM_ARCH_DISPATCH that the CPU and the operating system support
+GLM_FUNC_QUALIFIER unsigned int glm_arch_detect()
+{
+	unsigned int Leaf1[4] = {0, 0, 0, 0};
+	unsigned int Leaf7[4] = {0, 0, 0, 0};
+
+#	if GLM_COMPILER & GLM_COMPILER_VC
+		int Regs[4];
+		__cpuid(Regs, 0);
+		unsigned int const MaxLeaf = static_cast<unsigned int>(Regs[0]);
+		__cpuid(reinterpret_cast<int*>(Leaf1), 1);
+		if(MaxLeaf >= 7)
+			__cpuidex(reinterpret_cast<int*>(Leaf7), 7, 0);
+#	else
+		unsigned int const MaxLeaf = __get_cpuid_max(0, 0);
+		__cpuid(1, Leaf1[0], Leaf1[1], Leaf1[2], Leaf1[3]);
+		if(MaxLeaf >= 7)
+			__cpuid_count(7, 0, Leaf7[0], Leaf7[1], Leaf7[2], Leaf7[3]);
+#	endif
+
+	// The operating system must save the YMM, and for AVX-512 the ZMM and opmask, registers on context switches
+	unsigned int Xcr0 = 0;
+	if(Leaf1[2] & (1u << 27)) // OSXSAVE
+	{
+#		if GLM_COMPILER & GLM_COMPILER_VC
+			Xcr0 = static_cast<unsigned int>(_xgetbv(0));
+#		else
+			unsigned int High = 0;
+			__asm__ __volatile__("xgetbv" : "=a"(Xcr0), "=d"(High) : "c"(0));
+#		endif
+	}
+
+	bool const Avx2 = (Leaf1[2] & (1u << 28)) && (Leaf7[1] & (1u << 5)) && (Xcr0 & 0x06) == 0x06;
+	bool const Avx512 = Avx2 && (Leaf7[1] & (1u << 16)) && (Xcr0 & 0xe6) == 0xe6;
+
+	unsigned int Arch = GLM_ARCH;
+	if(Avx2)
+		Arch |= GLM_ARCH_AVX2 & GLM_ARCH_DISPATCH;
+	if(Avx512)
+		Arch |= GLM_ARCH_AVX512 & GLM_ARCH_DISPATCH;
+	return Arch;
+}
+
+#endif//GLM_ARCH_DISPATCH
+
+// The cap glm_arch_runtime_limit sets, no cap by default
+GLM_FUNC_QUALIFIER unsigned int& glm_arch_runtime_cap()
+{
+	static unsigned int Cap = ~0u;
+	return Cap;
+}
+
+// Restricts the kernels to the instruction sets of Arch, for instance GLM_ARCH_AVX2 to run the AVX2 kernels on an AVX-512
+// CPU, or 0 for the scalar code. It is not synchronized with functions running on other threads.
+GLM_FUNC_QUALIFIER void glm_arch_runtime_limit(unsigned int Arch)
+{
+	glm_arch_runtime_cap() = Arch;
+}
+
+// The instruction sets the kernels may use: GLM_ARCH, and with GLM_FORCE_SIMD_DISPATCH those the CPU supports, checked once,
+// within the glm_arch_runtime_limit cap
+GLM_FUNC_QUALIFIER unsigned int glm_arch_runtime()
+{
+#	if GLM_ARCH_DISPATCH
+		static unsigned int const Arch = glm_arch_detect();
+		return Arch & glm_arch_runtime_cap();
+#	else
+		return GLM_ARCH & glm_arch_runtime_cap();
+#	endif
+}
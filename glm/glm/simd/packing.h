@@ -5,4 +5,92 @@
 
 #if GLM_ARCH & GLM_ARCH_SSE2_BIT
 
+// The conversions below give the same bits as the scalar ones in detail/type_half.inl and gtc/packing.inl.
+// F16C rounds to nearest even and quiets NaNs where detail::toFloat16 rounds halfway cases up, so it is only used with GLM_FORCE_HALF_F16C.
+
+// Converts four floats to halfs held in the low 16 bits of each lane
+GLM_FUNC_QUALIFIER glm_ivec4 glm_vec4_pack_half(glm_vec4 v)
+{
+	glm_ivec4 const i = _mm_castps_si128(v);
+	glm_ivec4 const sign = _mm_and_si128(_mm_srli_epi32(i, 16), _mm_set1_epi32(0x8000));
+	glm_ivec4 const a = _mm_and_si128(i, _mm_set1_epi32(0x7fffffff));
+
+	// Normalized halfs: rebias the exponent, round the significand halfway up and saturate to infinity
+	glm_ivec4 normal = _mm_sub_epi32(_mm_srli_epi32(_mm_add_epi32(a, _mm_set1_epi32(0x1000)), 13), _mm_set1_epi32((127 - 15) << 10));
+	glm_ivec4 const overflow = _mm_cmpgt_epi32(normal, _mm_set1_epi32(0x7c00));
+	normal = _mm_or_si128(_mm_and_si128(overflow, _mm_set1_epi32(0x7c00)), _mm_andnot_si128(overflow, normal));
+
+	// Denormalized halfs: a times 2^24 rounded halfway up, the product and the fraction being exact
+	glm_vec4 const scaled = _mm_mul_ps(_mm_castsi128_ps(a), _mm_set1_ps(16777216.0f));
+	glm_ivec4 const whole = _mm_cvttps_epi32(scaled);
+	glm_vec4 const fraction = _mm_sub_ps(scaled, _mm_cvtepi32_ps(whole));
+	glm_ivec4 const denormal = _mm_sub_epi32(whole, _mm_castps_si128(_mm_cmpge_ps(fraction, _mm_set1_ps(0.5f))));
+
+	// Infinities, and NaNs keeping the 10 leftmost bits of their significand with at least one set
+	glm_ivec4 const payload = _mm_srli_epi32(_mm_and_si128(a, _mm_set1_epi32(0x007fffff)), 13);
+	glm_ivec4 const nan = _mm_cmpgt_epi32(a, _mm_set1_epi32(0x7f800000));
+	glm_ivec4 const quiet = _mm_and_si128(_mm_cmpeq_epi32(payload, _mm_setzero_si128()), _mm_set1_epi32(1));
+	glm_ivec4 const special = _mm_or_si128(_mm_set1_epi32(0x7c00), _mm_and_si128(nan, _mm_or_si128(payload, quiet)));
+
+	glm_ivec4 const isSpecial = _mm_cmpgt_epi32(a, _mm_set1_epi32(0x7f7fffff));
+	glm_ivec4 const isNormal = _mm_cmpgt_epi32(a, _mm_set1_epi32(0x387fffff));
+	glm_ivec4 const isDenormal = _mm_cmpgt_epi32(a, _mm_set1_epi32(0x32ffffff));
+
+	glm_ivec4 Result = _mm_and_si128(isDenormal, denormal);
+	Result = _mm_or_si128(_mm_and_si128(isNormal, normal), _mm_andnot_si128(isNormal, Result));
+	Result = _mm_or_si128(_mm_and_si128(isSpecial, special), _mm_andnot_si128(isSpecial, Result));
+	return _mm_or_si128(Result, sign);
+}
+
+// Converts the halfs held in the low 16 bits of each lane to floats
+GLM_FUNC_QUALIFIER glm_vec4 glm_vec4_unpack_half(glm_ivec4 h)
+{
+	glm_ivec4 const sign = _mm_slli_epi32(_mm_and_si128(h, _mm_set1_epi32(0x8000)), 16);
+	glm_ivec4 const a = _mm_and_si128(h, _mm_set1_epi32(0x7fff));
+
+	// Normalized halfs rebias the exponent, infinities and NaNs get the largest one
+	glm_ivec4 const isSpecial = _mm_cmpgt_epi32(a, _mm_set1_epi32(0x7bff));
+	glm_ivec4 const bias = _mm_add_epi32(_mm_set1_epi32((127 - 15) << 23), _mm_and_si128(isSpecial, _mm_set1_epi32((255 - 31 - (127 - 15)) << 23)));
+	glm_ivec4 const normal = _mm_add_epi32(_mm_slli_epi32(a, 13), bias);
+
+	// Denormalized halfs and zeros are exact as a times 2^-24
+	glm_ivec4 const denormal = _mm_castps_si128(_mm_mul_ps(_mm_cvtepi32_ps(a), _mm_set1_ps(5.9604644775390625e-8f)));
+
+	glm_ivec4 const isNormal = _mm_cmpgt_epi32(a, _mm_set1_epi32(0x03ff));
+	glm_ivec4 const Result = _mm_or_si128(_mm_and_si128(isNormal, normal), _mm_andnot_si128(isNormal, denormal));
+	return _mm_castsi128_ps(_mm_or_si128(Result, sign));
+}
+
+// Rounds halfway cases away from zero like std::round, for magnitudes below 2^23
+GLM_FUNC_QUALIFIER glm_ivec4 glm_vec4_pack_round(glm_vec4 x)
+{
+	glm_ivec4 const whole = _mm_cvttps_epi32(x);
+	glm_vec4 const fraction = _mm_sub_ps(x, _mm_cvtepi32_ps(whole));
+	glm_ivec4 const up = _mm_castps_si128(_mm_cmpge_ps(fraction, _mm_set1_ps(0.5f)));
+	glm_ivec4 const down = _mm_castps_si128(_mm_cmple_ps(fraction, _mm_set1_ps(-0.5f)));
+	return _mm_add_epi32(_mm_sub_epi32(whole, up), down);
+}
+
+// round(clamp(v, 0, 1) * scale)
+GLM_FUNC_QUALIFIER glm_ivec4 glm_vec4_pack_unorm(glm_vec4 v, glm_vec4 scale)
+{
+	glm_vec4 const clamped = _mm_min_ps(_mm_max_ps(v, _mm_setzero_ps()), _mm_set1_ps(1.0f));
+	return glm_vec4_pack_round(_mm_mul_ps(clamped, scale));
+}
+
+// round(clamp(v, -1, 1) * scale)
+GLM_FUNC_QUALIFIER glm_ivec4 glm_vec4_pack_snorm(glm_vec4 v, glm_vec4 scale)
+{
+	glm_vec4 const clamped = _mm_min_ps(_mm_max_ps(v, _mm_set1_ps(-1.0f)), _mm_set1_ps(1.0f));
+	return glm_vec4_pack_round(_mm_mul_ps(clamped, scale));
+}
+
+// Packs the low 16 bits of the lanes of a then b, without the signed saturation of _mm_packs_epi32
+GLM_FUNC_QUALIFIER glm_ivec4 glm_ivec4_pack_u16(glm_ivec4 a, glm_ivec4 b)
+{
+	a = _mm_srai_epi32(_mm_slli_epi32(a, 16), 16);
+	b = _mm_srai_epi32(_mm_slli_epi32(b, 16), 16);
+	return _mm_packs_epi32(a, b);
+}
+
 #endif//GLM_ARCH & GLM_ARCH_SSE2_BIT
@@ -3,7 +3,224 @@
 
 #pragma once
 
+#include "common.h"
+
+#include <cmath>
+
 #if GLM_ARCH & GLM_ARCH_SSE2_BIT
 
-#endif//GLM_ARCH & GLM_ARCH_SSE2_BIT
+// Polynomials from Cephes (sinf, cosf, tanf, atanf, asinf), evaluated on all four lanes at once.
+// Maximum errors against the correctly rounded result, over every float: sin, cos: 2 ULPs; tan: 4 ULPs;
+// atan, atan2: 3 ULPs; asin: 2 ULPs; acos: 1 ULP. test/core/core_func_trigonometric.cpp checks these bounds.
+
+// Beyond this magnitude, the quadrant times the first parts of pi/2 is no longer exact
+// and the lanes go to the C library instead
+#define GLM_SIMD_TRIGONOMETRIC_REDUCTION_MAX 32768.0f
+
+// Returns x minus the nearest multiple of pi/2, the multiple going to quadrant
+GLM_FUNC_QUALIFIER glm_vec4 glm_vec4_reduce_half_pi(glm_vec4 x, glm_ivec4* quadrant)
+{
+	*quadrant = _mm_cvtps_epi32(_mm_mul_ps(x, _mm_set1_ps(0.636619772367581343f)));
+	glm_vec4 const q = _mm_cvtepi32_ps(*quadrant);
+
+	// pi/2 split in four parts, the first three short enough for q times them to be exact
+	glm_vec4 r = glm_vec4_fma(q, _mm_set1_ps(-1.5703125f), x);
+	r = glm_vec4_fma(q, _mm_set1_ps(-4.8351287841796875e-4f), r);
+	r = glm_vec4_fma(q, _mm_set1_ps(-3.13855707645416259765625e-7f), r);
+	r = glm_vec4_fma(q, _mm_set1_ps(-6.077100628276710381e-11f), r);
+	return r;
+}
+
+// Sine and cosine of r in [-pi/4, pi/4]
+GLM_FUNC_QUALIFIER void glm_vec4_sincos_reduced(glm_vec4 r, glm_vec4* s, glm_vec4* c)
+{
+	glm_vec4 const z = _mm_mul_ps(r, r);
+
+	glm_vec4 ps = glm_vec4_fma(_mm_set1_ps(-1.9515295891e-4f), z, _mm_set1_ps(8.3321608736e-3f));
+	ps = glm_vec4_fma(ps, z, _mm_set1_ps(-1.6666654611e-1f));
+	*s = glm_vec4_fma(_mm_mul_ps(ps, z), r, r);
+
+	glm_vec4 pc = glm_vec4_fma(_mm_set1_ps(2.443315711809948e-5f), z, _mm_set1_ps(-1.388731625493765e-3f));
+	pc = glm_vec4_fma(pc, z, _mm_set1_ps(4.166664568298827e-2f));
+	pc = _mm_mul_ps(_mm_mul_ps(pc, z), z);
+	*c = _mm_add_ps(glm_vec4_fma(_mm_set1_ps(-0.5f), z, pc), _mm_set1_ps(1.0f));
+}
+
+// Replaces the lanes of result whose x is beyond GLM_SIMD_TRIGONOMETRIC_REDUCTION_MAX by func(x)
+GLM_FUNC_QUALIFIER glm_vec4 glm_vec4_trigonometric_large(glm_vec4 x, glm_vec4 result, float (*func)(float))
+{
+	int const large = _mm_movemask_ps(_mm_cmpgt_ps(glm_vec4_abs(x), _mm_set1_ps(GLM_SIMD_TRIGONOMETRIC_REDUCTION_MAX)));
+	if(large == 0)
+		return result;
+
+	float In[4], Out[4];
+	_mm_storeu_ps(In, x);
+	_mm_storeu_ps(Out, result);
+	for(int i = 0; i < 4; ++i)
+		if(large & (1 << i))
+			Out[i] = func(In[i]);
+	return _mm_loadu_ps(Out);
+}
+
+GLM_FUNC_QUALIFIER float glm_sin_large(float x)
+{
+	return std::sin(x);
+}
+
+GLM_FUNC_QUALIFIER float glm_cos_large(float x)
+{
+	return std::cos(x);
+}
+
+GLM_FUNC_QUALIFIER float glm_tan_large(float x)
+{
+	return std::tan(x);
+}
+
+GLM_FUNC_QUALIFIER void glm_vec4_sincos(glm_vec4 x, glm_vec4* s, glm_vec4* c)
+{
+	// Reduced from |x| so that sin(-0) stays -0, sine is odd and cosine even
+	glm_vec4 const sign = _mm_and_ps(x, _mm_castsi128_ps(_mm_set1_epi32(static_cast<int>(0x80000000))));
+	glm_ivec4 q;
+	glm_vec4 const r = glm_vec4_reduce_half_pi(glm_vec4_abs(x), &q);
+
+	glm_vec4 sr, cr;
+	glm_vec4_sincos_reduced(r, &sr, &cr);
+
+	// Odd quadrants swap sine and cosine; sine is negated in quadrants 2 and 3, cosine in 1 and 2
+	glm_vec4 const swap = _mm_castsi128_ps(_mm_cmpeq_epi32(_mm_and_si128(q, _mm_set1_epi32(1)), _mm_set1_epi32(1)));
+	glm_vec4 const sinSign = _mm_xor_ps(sign, _mm_castsi128_ps(_mm_slli_epi32(_mm_and_si128(q, _mm_set1_epi32(2)), 30)));
+	glm_vec4 const cosSign = _mm_castsi128_ps(_mm_slli_epi32(_mm_and_si128(_mm_add_epi32(q, _mm_set1_epi32(1)), _mm_set1_epi32(2)), 30));
+
+	glm_vec4 const sinResult = _mm_xor_ps(_mm_or_ps(_mm_and_ps(swap, cr), _mm_andnot_ps(swap, sr)), sinSign);
+	glm_vec4 const cosResult = _mm_xor_ps(_mm_or_ps(_mm_and_ps(swap, sr), _mm_andnot_ps(swap, cr)), cosSign);
+
+	*s = glm_vec4_trigonometric_large(x, sinResult, glm_sin_large);
+	*c = glm_vec4_trigonometric_large(x, cosResult, glm_cos_large);
+}
+
+GLM_FUNC_QUALIFIER glm_vec4 glm_vec4_sin(glm_vec4 x)
+{
+	glm_vec4 s, c;
+	glm_vec4_sincos(x, &s, &c);
+	return s;
+}
+
+GLM_FUNC_QUALIFIER glm_vec4 glm_vec4_cos(glm_vec4 x)
+{
+	glm_vec4 s, c;
+	glm_vec4_sincos(x, &s, &c);
+	return c;
+}
 
+GLM_FUNC_QUALIFIER glm_vec4 glm_vec4_tan(glm_vec4 x)
+{
+	glm_vec4 const sign = _mm_and_ps(x, _mm_castsi128_ps(_mm_set1_epi32(static_cast<int>(0x80000000))));
+	glm_ivec4 q;
+	glm_vec4 const r = glm_vec4_reduce_half_pi(glm_vec4_abs(x), &q);
+	glm_vec4 const z = _mm_mul_ps(r, r);
+
+	glm_vec4 p = glm_vec4_fma(_mm_set1_ps(9.38540185543e-3f), z, _mm_set1_ps(3.11992232697e-3f));
+	p = glm_vec4_fma(p, z, _mm_set1_ps(2.44301354525e-2f));
+	p = glm_vec4_fma(p, z, _mm_set1_ps(5.34112807005e-2f));
+	p = glm_vec4_fma(p, z, _mm_set1_ps(1.33387994085e-1f));
+	p = glm_vec4_fma(p, z, _mm_set1_ps(3.33331568548e-1f));
+	glm_vec4 const t = glm_vec4_fma(_mm_mul_ps(p, z), r, r);
+
+	// tan(r + pi/2) = -1 / tan(r)
+	glm_vec4 const odd = _mm_castsi128_ps(_mm_cmpeq_epi32(_mm_and_si128(q, _mm_set1_epi32(1)), _mm_set1_epi32(1)));
+	glm_vec4 const result = _mm_or_ps(_mm_and_ps(odd, _mm_div_ps(_mm_set1_ps(-1.0f), t)), _mm_andnot_ps(odd, t));
+
+	return glm_vec4_trigonometric_large(x, _mm_xor_ps(result, sign), glm_tan_large);
+}
+
+GLM_FUNC_QUALIFIER glm_vec4 glm_vec4_atan(glm_vec4 x)
+{
+	glm_vec4 const sign = _mm_and_ps(x, _mm_castsi128_ps(_mm_set1_epi32(static_cast<int>(0x80000000))));
+	glm_vec4 const a = glm_vec4_abs(x);
+
+	// Above tan(3pi/8), atan(a) = pi/2 + atan(-1/a); above tan(pi/8), atan(a) = pi/4 + atan((a - 1) / (a + 1))
+	glm_vec4 const big = _mm_cmpgt_ps(a, _mm_set1_ps(2.414213562373095f));
+	glm_vec4 const mid = _mm_andnot_ps(big, _mm_cmpgt_ps(a, _mm_set1_ps(0.4142135623730950f)));
+
+	glm_vec4 const one = _mm_set1_ps(1.0f);
+	glm_vec4 r = _mm_or_ps(_mm_and_ps(big, _mm_div_ps(_mm_set1_ps(-1.0f), a)), _mm_andnot_ps(big, a));
+	r = _mm_or_ps(_mm_and_ps(mid, _mm_div_ps(_mm_sub_ps(a, one), _mm_add_ps(a, one))), _mm_andnot_ps(mid, r));
+	glm_vec4 const offset = _mm_or_ps(_mm_and_ps(big, _mm_set1_ps(1.57079632679489661923f)), _mm_and_ps(mid, _mm_set1_ps(0.78539816339744830962f)));
+
+	glm_vec4 const z = _mm_mul_ps(r, r);
+	glm_vec4 p = glm_vec4_fma(_mm_set1_ps(8.05374449538e-2f), z, _mm_set1_ps(-1.38776856032e-1f));
+	p = glm_vec4_fma(p, z, _mm_set1_ps(1.99777106478e-1f));
+	p = glm_vec4_fma(p, z, _mm_set1_ps(-3.33329491539e-1f));
+	glm_vec4 const y = _mm_add_ps(offset, glm_vec4_fma(_mm_mul_ps(p, z), r, r));
+
+	return _mm_xor_ps(y, sign);
+}
+
+GLM_FUNC_QUALIFIER glm_vec4 glm_vec4_atan2(glm_vec4 y, glm_vec4 x)
+{
+	glm_vec4 const signMask = _mm_castsi128_ps(_mm_set1_epi32(static_cast<int>(0x80000000)));
+	glm_vec4 const ax = glm_vec4_abs(x);
+	glm_vec4 const ay = glm_vec4_abs(y);
+
+	// atan of the smaller over the larger magnitude, in [0, 1]; 0 / 0 gives 0 and inf / inf gives 1, as atan2 expects
+	glm_vec4 const swap = _mm_cmpgt_ps(ay, ax);
+	glm_vec4 const num = _mm_min_ps(ax, ay);
+	glm_vec4 const den = _mm_max_ps(ax, ay);
+	glm_vec4 const same = _mm_cmpeq_ps(ax, ay);
+	glm_vec4 t = _mm_or_ps(_mm_and_ps(same, _mm_set1_ps(1.0f)), _mm_andnot_ps(same, _mm_div_ps(num, den)));
+	t = _mm_andnot_ps(_mm_cmpeq_ps(den, _mm_setzero_ps()), t);
+	glm_vec4 a = glm_vec4_atan(t);
+
+	a = _mm_or_ps(_mm_and_ps(swap, _mm_sub_ps(_mm_set1_ps(1.57079632679489661923f), a)), _mm_andnot_ps(swap, a));
+	glm_vec4 const negative = _mm_castsi128_ps(_mm_srai_epi32(_mm_castps_si128(x), 31));
+	a = _mm_or_ps(_mm_and_ps(negative, _mm_sub_ps(_mm_set1_ps(3.14159265358979323846f), a)), _mm_andnot_ps(negative, a));
+	a = _mm_or_ps(a, _mm_and_ps(y, signMask));
+
+	// NaN in, NaN out
+	glm_vec4 const nan = _mm_cmpunord_ps(x, y);
+	return _mm_or_ps(_mm_and_ps(nan, _mm_add_ps(x, y)), _mm_andnot_ps(nan, a));
+}
+
+// asin of a in [0, 1]
+GLM_FUNC_QUALIFIER glm_vec4 glm_vec4_asin_positive(glm_vec4 a)
+{
+	// Above 0.5, asin(a) = pi/2 - 2 * asin(sqrt((1 - a) / 2))
+	glm_vec4 const big = _mm_cmpgt_ps(a, _mm_set1_ps(0.5f));
+	glm_vec4 const zBig = _mm_mul_ps(_mm_set1_ps(0.5f), _mm_sub_ps(_mm_set1_ps(1.0f), a));
+	glm_vec4 const z = _mm_or_ps(_mm_and_ps(big, zBig), _mm_andnot_ps(big, _mm_mul_ps(a, a)));
+	glm_vec4 const s = _mm_or_ps(_mm_and_ps(big, _mm_sqrt_ps(zBig)), _mm_andnot_ps(big, a));
+
+	glm_vec4 p = glm_vec4_fma(_mm_set1_ps(4.2163199048e-2f), z, _mm_set1_ps(2.4181311049e-2f));
+	p = glm_vec4_fma(p, z, _mm_set1_ps(4.5470025998e-2f));
+	p = glm_vec4_fma(p, z, _mm_set1_ps(7.4953002686e-2f));
+	p = glm_vec4_fma(p, z, _mm_set1_ps(1.6666752422e-1f));
+	glm_vec4 const r = glm_vec4_fma(_mm_mul_ps(p, z), s, s);
+
+	glm_vec4 const rBig = glm_vec4_fma(_mm_set1_ps(-2.0f), r, _mm_set1_ps(1.57079632679489661923f));
+	return _mm_or_ps(_mm_and_ps(big, rBig), _mm_andnot_ps(big, r));
+}
+
+GLM_FUNC_QUALIFIER glm_vec4 glm_vec4_asin(glm_vec4 x)
+{
+	glm_vec4 const sign = _mm_and_ps(x, _mm_castsi128_ps(_mm_set1_epi32(static_cast<int>(0x80000000))));
+	return _mm_xor_ps(glm_vec4_asin_positive(glm_vec4_abs(x)), sign);
+}
+
+GLM_FUNC_QUALIFIER glm_vec4 glm_vec4_acos(glm_vec4 x)
+{
+	// Above 0.5 in magnitude, acos(x) = 2 * asin(sqrt((1 - |x|) / 2)), subtracted from pi for negative x;
+	// in between, acos(x) = pi/2 - asin(x)
+	glm_vec4 const a = glm_vec4_abs(x);
+	glm_vec4 const big = _mm_cmpgt_ps(a, _mm_set1_ps(0.5f));
+	glm_vec4 const negative = _mm_cmplt_ps(x, _mm_setzero_ps());
+
+	glm_vec4 const s = glm_vec4_asin_positive(_mm_sqrt_ps(_mm_mul_ps(_mm_set1_ps(0.5f), _mm_sub_ps(_mm_set1_ps(1.0f), a))));
+	glm_vec4 const twice = _mm_add_ps(s, s);
+	glm_vec4 const resultBig = _mm_or_ps(_mm_and_ps(negative, _mm_sub_ps(_mm_set1_ps(3.14159265358979323846f), twice)), _mm_andnot_ps(negative, twice));
+	glm_vec4 const resultSmall = _mm_sub_ps(_mm_set1_ps(1.57079632679489661923f), glm_vec4_asin(x));
+
+	return _mm_or_ps(_mm_and_ps(big, resultBig), _mm_andnot_ps(big, resultSmall));
+}
+
+#endif//GLM_ARCH & GLM_ARCH_SSE2_BIT
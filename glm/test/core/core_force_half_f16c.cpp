@@ -0,0 +1,161 @@
+#ifndef GLM_FORCE_INTRINSICS
+#	define GLM_FORCE_INTRINSICS
+#endif
+#ifndef GLM_FORCE_HALF_F16C
+#	define GLM_FORCE_HALF_F16C
+#endif
+
+#include <glm/gtc/packing.hpp>
+#include <glm/ext/vector_float1.hpp>
+#include <glm/ext/vector_float4.hpp>
+#include <glm/ext/vector_uint1_sized.hpp>
+#include <glm/ext/vector_uint4_sized.hpp>
+#include <glm/common.hpp>
+#include <cmath>
+#include <cstring>
+#include <vector>
+
+#if GLM_CONFIG_HALF_F16C == GLM_ENABLE
+
+static float half_to_float(glm::uint16 h)
+{
+	return glm::unpackHalf1x16(h);
+}
+
+static float bits_to_float(glm::uint32 i)
+{
+	float f;
+	std::memcpy(&f, &i, sizeof(f));
+	return f;
+}
+
+static glm::uint32 float_to_bits(float f)
+{
+	glm::uint32 i;
+	std::memcpy(&i, &f, sizeof(i));
+	return i;
+}
+
+// packHalf1x16 rounds halfway cases up, away from zero; the expected F16C result rounds them to the even half
+static glm::uint16 pack_half_even(float f)
+{
+	glm::uint16 const Up = glm::packHalf1x16(f);
+	glm::uint16 const Magnitude = Up & 0x7fff;
+	if(Magnitude == 0 || Magnitude >= 0x7c00 || (Magnitude & 1) == 0)
+		return Up;
+
+	double const a = std::fabs(static_cast<double>(f));
+	double const High = static_cast<double>(half_to_float(Magnitude));
+	double const Low = static_cast<double>(half_to_float(static_cast<glm::uint16>(Magnitude - 1)));
+	return a - Low == High - a ? static_cast<glm::uint16>(Up - 1) : Up;
+}
+
+// Every finite half, the midpoints to the next one and the floats next to the midpoints, both signs
+static std::vector<float> samples()
+{
+	std::vector<float> Samples;
+	for(glm::uint16 h = 0; h < 0x7c00; ++h)
+	{
+		double const Low = static_cast<double>(half_to_float(h));
+		double const High = h == 0x7bff ? 65536.0 : static_cast<double>(half_to_float(static_cast<glm::uint16>(h + 1)));
+		float const Middle = static_cast<float>((Low + High) * 0.5);
+		float const Values[] = {static_cast<float>(Low), Middle, bits_to_float(float_to_bits(Middle) - 1), bits_to_float(float_to_bits(Middle) + 1)};
+		for(std::size_t i = 0; i < sizeof(Values) / sizeof(Values[0]); ++i)
+		{
+			Samples.push_back(Values[i]);
+			Samples.push_back(-Values[i]);
+		}
+	}
+	Samples.push_back(1e9f);
+	Samples.push_back(-1e9f);
+	Samples.push_back(bits_to_float(0x7f800000));
+	Samples.push_back(bits_to_float(0x7fc00000));
+	Samples.push_back(bits_to_float(0xffa00001));
+	// not a multiple of the 8 halfs per step, so the tail is converted too
+	Samples.push_back(3.0f);
+	return Samples;
+}
+
+static int test_pack()
+{
+	int Error = 0;
+
+	std::vector<float> const In = samples();
+	std::vector<glm::uint16> Out(In.size());
+	glm::packHalf(reinterpret_cast<glm::vec1 const*>(&In[0]), reinterpret_cast<glm::u16vec1*>(&Out[0]), In.size());
+
+	for(std::size_t i = 0; i < In.size(); ++i)
+	{
+		if(glm::isnan(In[i]))
+			Error += (Out[i] & 0x7fff) > 0x7c00 ? 0 : 1;
+		else
+			Error += Out[i] == pack_half_even(In[i]) ? 0 : 1;
+	}
+
+	return Error;
+}
+
+// Exact for every half but signaling NaNs, which come out quiet
+static int test_unpack()
+{
+	int Error = 0;
+
+	std::size_t const Count = 65536 + 5;
+	std::vector<glm::uint16> In(Count);
+	for(std::size_t i = 0; i < Count; ++i)
+		In[i] = static_cast<glm::uint16>(i);
+
+	std::vector<float> Out(Count);
+	glm::unpackHalf(reinterpret_cast<glm::u16vec1 const*>(&In[0]), reinterpret_cast<glm::vec1*>(&Out[0]), Count);
+
+	for(std::size_t i = 0; i < Count; ++i)
+	{
+		float const Expected = half_to_float(In[i]);
+		if(glm::isnan(Expected))
+			Error += glm::isnan(Out[i]) ? 0 : 1;
+		else
+			Error += std::memcmp(&Out[i], &Expected, sizeof(float)) == 0 ? 0 : 1;
+	}
+
+	return Error;
+}
+
+static int test_vec4()
+{
+	int Error = 0;
+
+	// 1 + 2^-11 is halfway between 1 and the next half, 1 + 3 * 2^-11 halfway between the next two
+	std::vector<glm::vec4> In(3, glm::vec4(1.0f + 1.0f / 2048.0f, 1.0f + 3.0f / 2048.0f, -2.5f, 0.0f));
+	std::vector<glm::u16vec4> Out(In.size());
+	glm::packHalf(&In[0], &Out[0], In.size());
+
+	for(std::size_t i = 0; i < In.size(); ++i)
+		Error += Out[i] == glm::u16vec4(0x3c00, 0x3c02, 0xc100, 0x0000) ? 0 : 1;
+
+	return Error;
+}
+
+int main()
+{
+	int Error = 0;
+
+#	if (GLM_COMPILER & (GLM_COMPILER_GCC | GLM_COMPILER_CLANG))
+		if(!__builtin_cpu_supports("f16c"))
+			return Error;
+#	endif
+
+	Error += test_pack();
+	Error += test_unpack();
+	Error += test_vec4();
+
+	return Error;
+}
+
+#else
+
+int main()
+{
+	return 0;
+}
+
+#endif//GLM_CONFIG_HALF_F16C == GLM_ENABLE
@@ -0,0 +1,88 @@
+#ifndef GLM_FORCE_INTRINSICS
+#	define GLM_FORCE_INTRINSICS
+#endif
+#ifndef GLM_FORCE_SIMD_DISPATCH
+#	define GLM_FORCE_SIMD_DISPATCH
+#endif
+
+#include <glm/glm.hpp>
+#include <glm/ext.hpp>
+#include <vector>
+
+static int test_inverse()
+{
+	int Error = 0;
+
+	std::size_t const Count = 37;
+
+	std::vector<glm::mat4> In(Count);
+	for(std::size_t i = 0; i < Count; ++i)
+		In[i] = glm::mat4(1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15, 16) * static_cast<float>(i) * 0.1f + glm::mat4(8.0f);
+
+	std::vector<glm::mat4> Inverse(Count);
+	std::vector<float> Determinant(Count);
+	glm::inverse(&In[0], &Inverse[0], Count);
+	glm::determinant(&In[0], &Determinant[0], Count);
+
+	for(std::size_t i = 0; i < Count; ++i)
+	{
+		float const Expected = glm::determinant(In[i]);
+		Error += glm::all(glm::equal(Inverse[i], glm::inverse(In[i]), 0.0001f)) ? 0 : 1;
+		Error += glm::equal(Determinant[i], Expected, glm::abs(Expected) * 0.0001f) ? 0 : 1;
+	}
+
+	return Error;
+}
+
+static int test_transform()
+{
+	int Error = 0;
+
+	std::size_t const Count = 37;
+	glm::mat4 const Transform(1, 2, 3, 0, 5, 6, 7, 0, 9, 10, 11, 0, 13, 14, 15, 1);
+
+	std::vector<glm::vec3> In(Count);
+	for(std::size_t i = 0; i < Count; ++i)
+		In[i] = glm::vec3(0.1f, 0.2f, 0.5f) * static_cast<float>(i);
+
+	std::vector<glm::vec3> Out(Count);
+	glm::transform_points(Transform, &In[0], &Out[0], Count);
+
+	std::vector<glm::mat4> Product(Count);
+	std::vector<glm::mat4> Left(Count, Transform);
+	std::vector<glm::mat4> Right(Count);
+	for(std::size_t i = 0; i < Count; ++i)
+		Right[i] = glm::translate(glm::mat4(1.0f), In[i]);
+	glm::mul(&Left[0], &Right[0], &Product[0], Count);
+
+	for(std::size_t i = 0; i < Count; ++i)
+	{
+		Error += glm::all(glm::equal(Out[i], glm::vec3(Transform * glm::vec4(In[i], 1.0f)), 0.001f)) ? 0 : 1;
+		Error += glm::all(glm::equal(Product[i], Transform * Right[i], 0.001f)) ? 0 : 1;
+	}
+
+	return Error;
+}
+
+int main()
+{
+	int Error = 0;
+
+#	if GLM_CONFIG_SIMD == GLM_ENABLE
+		// The widest kernels take all the elements they can, so the narrower ones only run once capped;
+		// 0 leaves the scalar code alone
+		unsigned int const Caps[] = {~0u, GLM_ARCH_AVX2, 0u};
+		for(std::size_t i = 0; i < sizeof(Caps) / sizeof(Caps[0]); ++i)
+		{
+			glm_arch_runtime_limit(Caps[i]);
+			Error += test_inverse();
+			Error += test_transform();
+		}
+		glm_arch_runtime_limit(~0u);
+#	else
+		Error += test_inverse();
+		Error += test_transform();
+#	endif
+
+	return Error;
+}
@@ -1,10 +1,161 @@
 #include <glm/trigonometric.hpp>
+#include <glm/common.hpp>
+#include <glm/gtc/constants.hpp>
+#include <glm/gtc/ulp.hpp>
+#include <glm/ext/vector_relational.hpp>
+#include <glm/ext/vector_float4.hpp>
+#include <limits>
+#include <cmath>
 
-int main()
+// Largest distance to the correctly rounded result, measured on every float of the tested ranges
+static int const SinCosULPs = 2;
+static int const TanULPs = 4;
+static int const InverseULPs = 3;
+
+template<glm::qualifier Q>
+static int ulps(glm::vec<4, float, Q> const& v, double (*func)(double), glm::vec<4, float, Q> const& x)
+{
+	int Result = 0;
+	for(glm::length_t i = 0; i < 4; ++i)
+	{
+		float const Expected = static_cast<float>(func(static_cast<double>(x[i])));
+		int const Distance = glm::float_distance(v[i], Expected);
+		Result = Distance > Result ? Distance : Result;
+	}
+	return Result;
+}
+
+// Sweeps [Min, Max] four values at a time
+template<glm::qualifier Q>
+static int test_range(float Min, float Max)
 {
+	typedef glm::vec<4, float, Q> vec4;
+
 	int Error = 0;
 
+	int const Samples = 20000;
+	for(int i = 0; i < Samples; i += 4)
+	{
+		vec4 X;
+		for(glm::length_t j = 0; j < 4; ++j)
+			X[j] = Min + (Max - Min) * static_cast<float>(i + j) / static_cast<float>(Samples);
+
+		Error += ulps(glm::sin(X), std::sin, X) <= SinCosULPs ? 0 : 1;
+		Error += ulps(glm::cos(X), std::cos, X) <= SinCosULPs ? 0 : 1;
+		Error += ulps(glm::tan(X), std::tan, X) <= TanULPs ? 0 : 1;
+		Error += ulps(glm::atan(X), std::atan, X) <= InverseULPs ? 0 : 1;
+
+		vec4 const Unit = glm::sin(X);
+		Error += ulps(glm::asin(Unit), std::asin, Unit) <= InverseULPs ? 0 : 1;
+		Error += ulps(glm::acos(Unit), std::acos, Unit) <= InverseULPs ? 0 : 1;
+	}
 
 	return Error;
 }
 
+template<glm::qualifier Q>
+static int test_atan2()
+{
+	typedef glm::vec<4, float, Q> vec4;
+
+	int Error = 0;
+
+	float const Values[] = {-1e30f, -3.5f, -1.0f, -0.25f, -1e-30f, -0.0f, 0.0f, 1e-30f, 0.25f, 1.0f, 3.5f, 1e30f};
+	std::size_t const Count = sizeof(Values) / sizeof(Values[0]);
+	for(std::size_t y = 0; y < Count; ++y)
+	for(std::size_t x = 0; x < Count; x += 4)
+	{
+		vec4 const Y(Values[y]);
+		vec4 const X(Values[x], Values[x + 1], Values[x + 2], Values[x + 3]);
+		vec4 const Result = glm::atan(Y, X);
+		for(glm::length_t i = 0; i < 4; ++i)
+		{
+			float const Expected = static_cast<float>(std::atan2(static_cast<double>(Y[i]), static_cast<double>(X[i])));
+			Error += glm::float_distance(Result[i], Expected) <= InverseULPs ? 0 : 1;
+		}
+	}
+
+	return Error;
+}
+
+template<glm::qualifier Q>
+static int test_special_values()
+{
+	typedef glm::vec<4, float, Q> vec4;
+
+	int Error = 0;
+
+	float const Inf = std::numeric_limits<float>::infinity();
+	float const NaN = std::numeric_limits<float>::quiet_NaN();
+	float const HalfPi = glm::half_pi<float>();
+	float const Pi = glm::pi<float>();
+
+	// Signed zeros are kept
+	vec4 const Zero(0.0f, -0.0f, 0.0f, -0.0f);
+	Error += glm::floatBitsToInt(glm::sin(Zero).y) < 0 && glm::floatBitsToInt(glm::sin(Zero).x) == 0 ? 0 : 1;
+	Error += glm::floatBitsToInt(glm::tan(Zero).y) < 0 && glm::floatBitsToInt(glm::tan(Zero).x) == 0 ? 0 : 1;
+	Error += glm::floatBitsToInt(glm::asin(Zero).y) < 0 && glm::floatBitsToInt(glm::asin(Zero).x) == 0 ? 0 : 1;
+	Error += glm::floatBitsToInt(glm::atan(Zero).y) < 0 && glm::floatBitsToInt(glm::atan(Zero).x) == 0 ? 0 : 1;
+	Error += glm::all(glm::equal(glm::cos(Zero), vec4(1.0f), 0.0f)) ? 0 : 1;
+
+	// Infinities and NaN give NaN, out of domain inputs too
+	vec4 const Invalid(Inf, -Inf, NaN, 2.0f);
+	Error += glm::all(glm::isnan(glm::sin(vec4(Inf, -Inf, NaN, NaN)))) ? 0 : 1;
+	Error += glm::all(glm::isnan(glm::cos(vec4(Inf, -Inf, NaN, NaN)))) ? 0 : 1;
+	Error += glm::all(glm::isnan(glm::tan(vec4(Inf, -Inf, NaN, NaN)))) ? 0 : 1;
+	Error += glm::all(glm::isnan(glm::asin(Invalid))) ? 0 : 1;
+	Error += glm::all(glm::isnan(glm::acos(Invalid))) ? 0 : 1;
+
+	// Large arguments
+	vec4 const Large(1e5f, -3e7f, 1e30f, 32769.0f);
+	Error += ulps(glm::sin(Large), std::sin, Large) <= SinCosULPs ? 0 : 1;
+	Error += ulps(glm::cos(Large), std::cos, Large) <= SinCosULPs ? 0 : 1;
+	Error += ulps(glm::tan(Large), std::tan, Large) <= TanULPs ? 0 : 1;
+
+	// Infinite arguments of the inverse functions
+	Error += glm::all(glm::equal(glm::atan(vec4(Inf, -Inf, Inf, -Inf)), vec4(HalfPi, -HalfPi, HalfPi, -HalfPi), 0.0f)) ? 0 : 1;
+	Error += glm::all(glm::equal(glm::atan(vec4(1.0f, -1.0f, 0.0f, -0.0f), vec4(Inf, Inf, -Inf, -Inf)), vec4(0.0f, -0.0f, Pi, -Pi), 0.0f)) ? 0 : 1;
+	Error += glm::all(glm::equal(glm::atan(vec4(Inf, -Inf, Inf, 1.0f), vec4(Inf, -Inf, 0.0f, 0.0f)), vec4(Pi / 4.0f, -3.0f * Pi / 4.0f, HalfPi, HalfPi), 0.000001f)) ? 0 : 1;
+	Error += glm::all(glm::isnan(glm::atan(vec4(NaN, 1.0f, NaN, Inf), vec4(1.0f, NaN, NaN, NaN)))) ? 0 : 1;
+
+	return Error;
+}
+
+// The packed types keep calling the C library
+static int test_packed()
+{
+	typedef glm::vec<4, float, glm::packed_highp> vec4;
+
+	int Error = 0;
+
+	vec4 const X(-7.5f, 0.25f, 1.0f, 1000.0f);
+	vec4 const Unit(-0.75f, 0.25f, 0.5f, 1.0f);
+	Error += ulps(glm::sin(X), std::sin, X) <= 1 ? 0 : 1;
+	Error += ulps(glm::cos(X), std::cos, X) <= 1 ? 0 : 1;
+	Error += ulps(glm::tan(X), std::tan, X) <= 1 ? 0 : 1;
+	Error += ulps(glm::atan(X), std::atan, X) <= 1 ? 0 : 1;
+	Error += ulps(glm::asin(Unit), std::asin, Unit) <= 1 ? 0 : 1;
+	Error += ulps(glm::acos(Unit), std::acos, Unit) <= 1 ? 0 : 1;
+
+	return Error;
+}
+
+int main()
+{
+	int Error = 0;
+
+	Error += test_packed();
+
+	Error += test_range<glm::defaultp>(-4.0f, 4.0f);
+	Error += test_atan2<glm::defaultp>();
+	Error += test_special_values<glm::defaultp>();
+
+#	if GLM_CONFIG_ALIGNED_GENTYPES == GLM_ENABLE
+		Error += test_range<glm::aligned_highp>(-4.0f, 4.0f);
+		Error += test_range<glm::aligned_highp>(-32768.0f, 32768.0f);
+		Error += test_atan2<glm::aligned_highp>();
+		Error += test_special_values<glm::aligned_highp>();
+#	endif
+
+	return Error;
+}
@@ -6,6 +6,9 @@
 #include <glm/mat4x4.hpp>
 #include <glm/vec4.hpp>
 #include <vector>
+#if GLM_CONFIG_ALIGNED_GENTYPES == GLM_ENABLE
+#	include <glm/gtc/type_aligned.hpp>
+#endif
 
 template <typename matType, typename vecType>
 static int test_operators()
@@ -171,6 +174,33 @@ static int test_size()
 	return Error;
 }
 
+#if GLM_CONFIG_ALIGNED_GENTYPES == GLM_ENABLE
+// aligned operators may take the SIMD paths, which must agree with the packed ones
+static int test_aligned_operators()
+{
+	int Error = 0;
+
+	glm::mat4 const A(1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15, 16);
+	glm::mat4 const B(0.5f, -1, 1.5f, -2, 2.5f, -3, 3.5f, -4, 4.5f, -5, 5.5f, -6, 6.5f, -7, 7.5f, -8);
+	glm::vec4 const V(1, -2, 3, -4);
+
+	glm::aligned_mat4 const AlignedA(A);
+	glm::aligned_mat4 const AlignedB(B);
+	glm::aligned_vec4 const AlignedV(V);
+
+	Error += glm::all(glm::equal(glm::mat4(AlignedA * AlignedB), A * B, 0.001f)) ? 0 : 1;
+	Error += glm::all(glm::equal(glm::mat4(AlignedA + AlignedB), A + B, 0.001f)) ? 0 : 1;
+	Error += glm::all(glm::equal(glm::vec4(AlignedA * AlignedV), A * V, 0.001f)) ? 0 : 1;
+	Error += glm::all(glm::equal(glm::vec4(AlignedV * AlignedA), V * A, 0.001f)) ? 0 : 1;
+
+	glm::aligned_mat4 Product(AlignedA);
+	Product *= AlignedB;
+	Error += glm::all(glm::equal(glm::mat4(Product), A * B, 0.001f)) ? 0 : 1;
+
+	return Error;
+}
+#endif
+
 static int test_constexpr()
 {
 #if GLM_HAS_CONSTEXPR
@@ -211,6 +241,10 @@ int main()
 	Error += test_inverse<glm::mediump_dmat4>();
 	Error += test_inverse<glm::highp_dmat4>();
 
+#	if GLM_CONFIG_ALIGNED_GENTYPES == GLM_ENABLE
+		Error += test_aligned_operators();
+#	endif
+
 	Error += test_size();
 	Error += test_constexpr();
 
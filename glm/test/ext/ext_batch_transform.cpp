@@ -0,0 +1,283 @@
+#include <glm/ext/batch_transform.hpp>
+#include <glm/ext/matrix_relational.hpp>
+#include <glm/ext/matrix_transform.hpp>
+#include <glm/ext/scalar_relational.hpp>
+#include <glm/ext/vector_relational.hpp>
+#include <glm/common.hpp>
+#include <glm/mat4x4.hpp>
+#include <glm/vec3.hpp>
+#include <vector>
+
+// Counts around the 8 and 16 lane blocks, so that both the SIMD loops and the scalar tails run
+static std::size_t const Counts[] = {0, 1, 7, 8, 9, 15, 16, 17, 31, 33, 100};
+
+template<typename vecType>
+static vecType make_vec3(std::size_t i)
+{
+	typedef typename vecType::value_type T;
+	return vecType(
+		static_cast<T>(i % 17) * static_cast<T>(0.5) - static_cast<T>(4),
+		static_cast<T>(i % 5) - static_cast<T>(2) + static_cast<T>(i) * static_cast<T>(0.01),
+		static_cast<T>(3) - static_cast<T>(i % 11) * static_cast<T>(0.25));
+}
+
+template<typename matType>
+static matType make_mat4(std::size_t i)
+{
+	typedef typename matType::value_type T;
+	matType Result;
+	for(glm::length_t c = 0; c < 4; ++c)
+	for(glm::length_t r = 0; r < 4; ++r)
+		Result[c][r] = static_cast<T>((i * 7 + static_cast<std::size_t>(c * 4 + r) * 3) % 13) * static_cast<T>(0.25) - static_cast<T>(1.5);
+	return Result;
+}
+
+template<typename T, glm::qualifier Q>
+static int test_transform_aos()
+{
+	typedef glm::vec<3, T, Q> vecType;
+	typedef glm::vec<4, T, Q> vec4Type;
+	typedef glm::mat<4, 4, T, Q> matType;
+
+	int Error = 0;
+
+	matType const M = glm::rotate(glm::translate(matType(1), vecType(1, -2, 3)), static_cast<T>(0.5), vecType(0, 1, 0)) * make_mat4<matType>(3);
+
+	for(std::size_t k = 0; k < sizeof(Counts) / sizeof(Counts[0]); ++k)
+	{
+		std::size_t const Count = Counts[k];
+
+		std::vector<vecType> In(Count + 1, vecType(0));
+		for(std::size_t i = 0; i < In.size(); ++i)
+			In[i] = make_vec3<vecType>(i);
+
+		std::vector<vecType> Points(Count + 1, vecType(42));
+		std::vector<vecType> Directions(Count + 1, vecType(42));
+		glm::transform_points(M, &In[0], &Points[0], Count);
+		glm::transform_directions(M, &In[0], &Directions[0], Count);
+
+		for(std::size_t i = 0; i < Count; ++i)
+		{
+			Error += glm::all(glm::equal(Points[i], vecType(M * vec4Type(In[i], 1)), static_cast<T>(0.0001))) ? 0 : 1;
+			Error += glm::all(glm::equal(Directions[i], vecType(M * vec4Type(In[i], 0)), static_cast<T>(0.0001))) ? 0 : 1;
+		}
+
+		// Nothing past count is written
+		Error += glm::all(glm::equal(Points[Count], vecType(42), static_cast<T>(0))) ? 0 : 1;
+		Error += glm::all(glm::equal(Directions[Count], vecType(42), static_cast<T>(0))) ? 0 : 1;
+
+		// In place
+		std::vector<vecType> InOut(In);
+		glm::transform_points(M, &InOut[0], &InOut[0], Count);
+		for(std::size_t i = 0; i < Count; ++i)
+			Error += glm::all(glm::equal(InOut[i], Points[i], static_cast<T>(0))) ? 0 : 1;
+	}
+
+	return Error;
+}
+
+template<typename T>
+static int test_transform_soa()
+{
+	typedef glm::vec<3, T, glm::defaultp> vecType;
+	typedef glm::mat<4, 4, T, glm::defaultp> matType;
+
+	int Error = 0;
+
+	matType const M = glm::translate(make_mat4<matType>(5), vecType(-1, 0.5, 2));
+
+	for(std::size_t k = 0; k < sizeof(Counts) / sizeof(Counts[0]); ++k)
+	{
+		std::size_t const Count = Counts[k];
+
+		std::vector<T> InData(Count * 3 + 1);
+		glm::vec3_soa<T> const In(&InData[0], Count);
+		for(std::size_t i = 0; i < Count; ++i)
+			In.set(i, make_vec3<vecType>(i));
+
+		std::vector<T> PointData(Count * 3 + 1);
+		std::vector<T> DirectionData(Count * 3 + 1);
+		glm::vec3_soa<T> const Points(&PointData[0], Count);
+		glm::vec3_soa<T> const Directions(&DirectionData[0], Count);
+		glm::transform_points(M, In, Points);
+		glm::transform_directions(M, In, Directions);
+
+		for(std::size_t i = 0; i < Count; ++i)
+		{
+			Error += glm::all(glm::equal(Points[i], vecType(M * glm::vec<4, T, glm::defaultp>(In[i], 1)), static_cast<T>(0.0001))) ? 0 : 1;
+			Error += glm::all(glm::equal(Directions[i], vecType(M * glm::vec<4, T, glm::defaultp>(In[i], 0)), static_cast<T>(0.0001))) ? 0 : 1;
+		}
+
+		// Same results as the array of structures path
+		std::vector<vecType> AoS(Count + 1, vecType(0));
+		for(std::size_t i = 0; i < Count; ++i)
+			AoS[i] = In[i];
+		glm::transform_points(M, &AoS[0], &AoS[0], Count);
+		for(std::size_t i = 0; i < Count; ++i)
+			Error += glm::all(glm::equal(AoS[i], Points[i], static_cast<T>(0.0001))) ? 0 : 1;
+
+		// In place
+		glm::transform_points(M, In, In);
+		for(std::size_t i = 0; i < Count; ++i)
+			Error += glm::all(glm::equal(In[i], Points[i], static_cast<T>(0))) ? 0 : 1;
+	}
+
+	return Error;
+}
+
+template<typename T, glm::qualifier Q>
+static int test_mul_aos()
+{
+	typedef glm::mat<4, 4, T, Q> matType;
+
+	int Error = 0;
+
+	for(std::size_t k = 0; k < sizeof(Counts) / sizeof(Counts[0]); ++k)
+	{
+		std::size_t const Count = Counts[k];
+
+		std::vector<matType> A(Count + 1, matType(1));
+		std::vector<matType> B(Count + 1, matType(1));
+		for(std::size_t i = 0; i < A.size(); ++i)
+		{
+			A[i] = make_mat4<matType>(i);
+			B[i] = make_mat4<matType>(i * 3 + 1);
+		}
+
+		std::vector<matType> Out(Count + 1, matType(42));
+		glm::mul(&A[0], &B[0], &Out[0], Count);
+		for(std::size_t i = 0; i < Count; ++i)
+			Error += glm::all(glm::equal(Out[i], A[i] * B[i], static_cast<T>(0.0001))) ? 0 : 1;
+		Error += glm::all(glm::equal(Out[Count], matType(42), static_cast<T>(0))) ? 0 : 1;
+
+		// In place
+		glm::mul(&A[0], &B[0], &A[0], Count);
+		for(std::size_t i = 0; i < Count; ++i)
+			Error += glm::all(glm::equal(A[i], Out[i], static_cast<T>(0))) ? 0 : 1;
+	}
+
+	return Error;
+}
+
+template<typename T, glm::qualifier Q>
+static int test_inverse_aos()
+{
+	typedef glm::mat<4, 4, T, Q> matType;
+
+	int Error = 0;
+
+	for(std::size_t k = 0; k < sizeof(Counts) / sizeof(Counts[0]); ++k)
+	{
+		std::size_t const Count = Counts[k];
+
+		// Diagonally dominant, so far from singular
+		std::vector<matType> In(Count + 1, matType(1));
+		for(std::size_t i = 0; i < In.size(); ++i)
+			In[i] = make_mat4<matType>(i) + matType(8);
+
+		std::vector<matType> Inverse(Count + 1, matType(42));
+		glm::inverse(&In[0], &Inverse[0], Count);
+		for(std::size_t i = 0; i < Count; ++i)
+			Error += glm::all(glm::equal(Inverse[i], glm::inverse(In[i]), static_cast<T>(0.0001))) ? 0 : 1;
+		Error += glm::all(glm::equal(Inverse[Count], matType(42), static_cast<T>(0))) ? 0 : 1;
+
+		std::vector<T> Determinant(Count + 1, static_cast<T>(42));
+		glm::determinant(&In[0], &Determinant[0], Count);
+		for(std::size_t i = 0; i < Count; ++i)
+		{
+			T const Expected = glm::determinant(In[i]);
+			Error += glm::abs(Determinant[i] - Expected) <= glm::abs(Expected) * static_cast<T>(0.0001) ? 0 : 1;
+		}
+		Error += glm::equal(Determinant[Count], static_cast<T>(42), static_cast<T>(0)) ? 0 : 1;
+
+		// In place
+		glm::inverse(&In[0], &In[0], Count);
+		for(std::size_t i = 0; i < Count; ++i)
+			Error += glm::all(glm::equal(In[i], Inverse[i], static_cast<T>(0))) ? 0 : 1;
+	}
+
+	return Error;
+}
+
+template<typename T>
+static int test_mul_soa()
+{
+	typedef glm::mat<4, 4, T, glm::defaultp> matType;
+
+	int Error = 0;
+
+	for(std::size_t k = 0; k < sizeof(Counts) / sizeof(Counts[0]); ++k)
+	{
+		std::size_t const Count = Counts[k];
+
+		std::vector<T> DataA(Count * 16 + 1);
+		std::vector<T> DataB(Count * 16 + 1);
+		std::vector<T> DataOut(Count * 16 + 1);
+		glm::mat4_soa<T> const A(&DataA[0], Count);
+		glm::mat4_soa<T> const B(&DataB[0], Count);
+		glm::mat4_soa<T> const Out(&DataOut[0], Count);
+		for(std::size_t i = 0; i < Count; ++i)
+		{
+			A.set(i, make_mat4<matType>(i));
+			B.set(i, make_mat4<matType>(i * 3 + 1));
+		}
+
+		glm::mul(A, B, Out);
+		for(std::size_t i = 0; i < Count; ++i)
+			Error += glm::all(glm::equal(Out[i], A[i] * B[i], static_cast<T>(0.0001))) ? 0 : 1;
+
+		// In place
+		glm::mul(A, B, B);
+		for(std::size_t i = 0; i < Count; ++i)
+			Error += glm::all(glm::equal(B[i], Out[i], static_cast<T>(0))) ? 0 : 1;
+	}
+
+	return Error;
+}
+
+static int test_soa_views()
+{
+	int Error = 0;
+
+	float X[2] = {1, 2};
+	float Y[2] = {3, 4};
+	float Z[2] = {5, 6};
+	glm::vec3_soa<float> const V(X, Y, Z, 2);
+	Error += glm::all(glm::equal(V[1], glm::vec3(2, 4, 6), 0.0f)) ? 0 : 1;
+	V.set(0, glm::vec3(7, 8, 9));
+	Error += X[0] == 7.0f && Y[0] == 8.0f && Z[0] == 9.0f ? 0 : 1;
+
+	float Data[16 * 2] = {0};
+	glm::mat4_soa<float> const M(Data, 2);
+	M.set(1, glm::mat4(2));
+	Error += Data[1] == 2.0f && Data[(1 * 4 + 1) * 2 + 1] == 2.0f && Data[(3 * 4 + 3) * 2 + 1] == 2.0f ? 0 : 1;
+	Error += glm::all(glm::equal(M[0], glm::mat4(0), 0.0f)) ? 0 : 1;
+	Error += glm::all(glm::equal(M[1], glm::mat4(2), 0.0f)) ? 0 : 1;
+
+	return Error;
+}
+
+int main()
+{
+	int Error = 0;
+
+	Error += test_transform_aos<float, glm::defaultp>();
+	Error += test_transform_aos<double, glm::defaultp>();
+	Error += test_transform_soa<float>();
+	Error += test_transform_soa<double>();
+	Error += test_mul_aos<float, glm::defaultp>();
+	Error += test_mul_aos<double, glm::defaultp>();
+	Error += test_mul_soa<float>();
+	Error += test_mul_soa<double>();
+	Error += test_inverse_aos<float, glm::defaultp>();
+	Error += test_inverse_aos<double, glm::defaultp>();
+	Error += test_soa_views();
+
+#	if GLM_CONFIG_ALIGNED_GENTYPES == GLM_ENABLE
+		Error += test_transform_aos<float, glm::aligned_highp>();
+		Error += test_mul_aos<float, glm::aligned_highp>();
+		Error += test_inverse_aos<float, glm::aligned_highp>();
+#	endif
+
+	return Error;
+}
@@ -4,6 +4,7 @@
 #include <glm/ext/vector_relational.hpp>
 #include <cstdio>
 #include <vector>
+#include <limits>
 
 void print_bits(float const& s)
 {
@@ -822,6 +823,114 @@ int test_packInt2x32()
 	return Error;
 }
 
+// Counts around the SIMD blocks of 8 and 16 components, so that both the SIMD loops and the scalar tails run
+static std::size_t const BulkCounts[] = {0, 1, 3, 4, 5, 8, 9, 17, 100};
+
+static float bulk_value(std::size_t i)
+{
+	// Halfway cases of the unorm and snorm scales, half denormals, overflows and signed zeros first
+	static float const Values[] = {0.5f, -0.5f, 1.0f, -1.0f, 0.0f, -0.0f, 2.0f, -3.0f, 65504.0f, 65520.0f, -1e6f, 1e-5f, -6e-8f, 1e-10f, 2049.0f, 1.0009765625f};
+	std::size_t const Count = sizeof(Values) / sizeof(Values[0]);
+	return i < Count ? Values[i] : -1.5f + 3.0f * static_cast<float>((i * 37) % 1001) / 1000.0f;
+}
+
+template<glm::length_t L, glm::qualifier Q>
+static int test_bulk_half()
+{
+	typedef glm::vec<L, float, Q> vecType;
+	typedef glm::vec<L, glm::uint16, Q> packType;
+
+	int Error = 0;
+
+	for(std::size_t k = 0; k < sizeof(BulkCounts) / sizeof(BulkCounts[0]); ++k)
+	{
+		std::size_t const Count = BulkCounts[k];
+
+		std::vector<vecType> In(Count + 1, vecType(0));
+		for(std::size_t i = 0; i < In.size(); ++i)
+		for(glm::length_t c = 0; c < L; ++c)
+			In[i][c] = bulk_value(i * static_cast<std::size_t>(L) + static_cast<std::size_t>(c));
+
+		std::vector<packType> Packed(Count + 1, packType(42));
+		glm::packHalf(&In[0], &Packed[0], Count);
+		for(std::size_t i = 0; i < Count; ++i)
+			Error += glm::all(glm::equal(Packed[i], glm::packHalf(In[i]))) ? 0 : 1;
+		Error += glm::all(glm::equal(Packed[Count], packType(42))) ? 0 : 1;
+
+		std::vector<vecType> Unpacked(Count + 1, vecType(42));
+		glm::unpackHalf(&Packed[0], &Unpacked[0], Count);
+		for(std::size_t i = 0; i < Count; ++i)
+			Error += glm::all(glm::equal(Unpacked[i], glm::unpackHalf(Packed[i]))) ? 0 : 1;
+		Error += glm::all(glm::equal(Unpacked[Count], vecType(42))) ? 0 : 1;
+	}
+
+	return Error;
+}
+
+// The bulk unorm and snorm functions give the same results as the functions on packed vectors
+template<typename intType, glm::length_t L, glm::qualifier Q>
+static int test_bulk_norm()
+{
+	typedef glm::vec<L, float, Q> vecType;
+	typedef glm::vec<L, intType, Q> packType;
+	typedef glm::vec<L, float, glm::packed_highp> packedVecType;
+	typedef glm::vec<L, intType, glm::packed_highp> packedPackType;
+
+	bool const Signed = std::numeric_limits<intType>::is_signed;
+
+	int Error = 0;
+
+	for(std::size_t k = 0; k < sizeof(BulkCounts) / sizeof(BulkCounts[0]); ++k)
+	{
+		std::size_t const Count = BulkCounts[k];
+
+		std::vector<vecType> In(Count + 1, vecType(0));
+		for(std::size_t i = 0; i < In.size(); ++i)
+		for(glm::length_t c = 0; c < L; ++c)
+			In[i][c] = bulk_value(i * static_cast<std::size_t>(L) + static_cast<std::size_t>(c));
+
+		std::vector<packType> Packed(Count + 1, packType(42));
+		if(Signed)
+			glm::packSnorm<intType>(&In[0], &Packed[0], Count);
+		else
+			glm::packUnorm<intType>(&In[0], &Packed[0], Count);
+		for(std::size_t i = 0; i < Count; ++i)
+		{
+			packedPackType const Expected = Signed ? glm::packSnorm<intType>(packedVecType(In[i])) : glm::packUnorm<intType>(packedVecType(In[i]));
+			Error += glm::all(glm::equal(packedPackType(Packed[i]), Expected)) ? 0 : 1;
+		}
+		Error += glm::all(glm::equal(Packed[Count], packType(42))) ? 0 : 1;
+
+		std::vector<vecType> Unpacked(Count + 1, vecType(42));
+		if(Signed)
+			glm::unpackSnorm<float>(&Packed[0], &Unpacked[0], Count);
+		else
+			glm::unpackUnorm<float>(&Packed[0], &Unpacked[0], Count);
+		for(std::size_t i = 0; i < Count; ++i)
+		{
+			packedVecType const Expected = Signed ? glm::unpackSnorm<float>(packedPackType(Packed[i])) : glm::unpackUnorm<float>(packedPackType(Packed[i]));
+			Error += glm::all(glm::equal(packedVecType(Unpacked[i]), Expected)) ? 0 : 1;
+		}
+		Error += glm::all(glm::equal(Unpacked[Count], vecType(42))) ? 0 : 1;
+	}
+
+	return Error;
+}
+
+template<glm::length_t L, glm::qualifier Q>
+static int test_bulk()
+{
+	int Error = 0;
+
+	Error += test_bulk_half<L, Q>();
+	Error += test_bulk_norm<glm::uint8, L, Q>();
+	Error += test_bulk_norm<glm::uint16, L, Q>();
+	Error += test_bulk_norm<glm::int8, L, Q>();
+	Error += test_bulk_norm<glm::int16, L, Q>();
+
+	return Error;
+}
+
 int main()
 {
 	int Error = 0;
@@ -874,5 +983,15 @@ int main()
 	Error += test_Half1x16();
 	Error += test_Half4x16();
 
+	Error += test_bulk<1, glm::defaultp>();
+	Error += test_bulk<2, glm::defaultp>();
+	Error += test_bulk<3, glm::defaultp>();
+	Error += test_bulk<4, glm::defaultp>();
+
+#	if GLM_CONFIG_ALIGNED_GENTYPES == GLM_ENABLE
+		Error += test_bulk<3, glm::aligned_highp>();
+		Error += test_bulk<4, glm::aligned_highp>();
+#	endif
+
 	return Error;
 }
@@ -0,0 +1,173 @@
+#define GLM_FORCE_INLINE
+#include <glm/ext/batch_transform.hpp>
+#include <glm/ext/matrix_float4x4.hpp>
+#include <glm/ext/matrix_relational.hpp>
+#include <glm/ext/scalar_relational.hpp>
+#include <glm/ext/vector_float3.hpp>
+#include <glm/ext/vector_float4.hpp>
+#include <glm/ext/vector_relational.hpp>
+#include <glm/common.hpp>
+#include <glm/matrix.hpp>
+#if GLM_CONFIG_SIMD == GLM_ENABLE
+#include <vector>
+#include <chrono>
+#include <cstdio>
+
+static int elapsed(std::chrono::high_resolution_clock::time_point t1)
+{
+	std::chrono::high_resolution_clock::time_point t2 = std::chrono::high_resolution_clock::now();
+	return static_cast<int>(std::chrono::duration_cast<std::chrono::microseconds>(t2 - t1).count());
+}
+
+static int comp_transform_points(std::size_t Samples)
+{
+	int Error = 0;
+
+	glm::mat4 const Transform(1, 2, 3, 0, 5, 6, 7, 0, 9, 10, 11, 0, 13, 14, 15, 1);
+
+	std::vector<glm::vec3> I(Samples);
+	for(std::size_t i = 0; i < Samples; ++i)
+		I[i] = glm::vec3(0.01f, 0.02f, 0.05f) * static_cast<float>(i % 1000);
+
+	std::vector<glm::vec3> SISD(Samples);
+	std::chrono::high_resolution_clock::time_point t1 = std::chrono::high_resolution_clock::now();
+	for(std::size_t i = 0; i < Samples; ++i)
+		SISD[i] = glm::vec3(Transform * glm::vec4(I[i], 1));
+	std::printf("- loop: %d us\n", elapsed(t1));
+
+	std::vector<glm::vec3> AoS(Samples);
+	t1 = std::chrono::high_resolution_clock::now();
+	glm::transform_points(Transform, &I[0], &AoS[0], Samples);
+	std::printf("- AoS batch: %d us\n", elapsed(t1));
+
+	std::vector<float> InData(Samples * 3);
+	std::vector<float> OutData(Samples * 3);
+	glm::vec3_soa<float> const In(&InData[0], Samples);
+	glm::vec3_soa<float> const Out(&OutData[0], Samples);
+	for(std::size_t i = 0; i < Samples; ++i)
+		In.set(i, I[i]);
+	t1 = std::chrono::high_resolution_clock::now();
+	glm::transform_points(Transform, In, Out);
+	std::printf("- SoA batch: %d us\n", elapsed(t1));
+
+	for(std::size_t i = 0; i < Samples; ++i)
+	{
+		Error += glm::all(glm::equal(SISD[i], AoS[i], 0.001f)) ? 0 : 1;
+		Error += glm::all(glm::equal(SISD[i], Out[i], 0.001f)) ? 0 : 1;
+	}
+
+	return Error;
+}
+
+static int comp_mul(std::size_t Samples)
+{
+	int Error = 0;
+
+	std::vector<glm::mat4> A(Samples);
+	std::vector<glm::mat4> B(Samples);
+	for(std::size_t i = 0; i < Samples; ++i)
+	{
+		A[i] = glm::mat4(static_cast<float>(i % 100) * 0.01f);
+		B[i] = glm::mat4(1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15, 16);
+	}
+
+	std::vector<glm::mat4> SISD(Samples);
+	std::chrono::high_resolution_clock::time_point t1 = std::chrono::high_resolution_clock::now();
+	for(std::size_t i = 0; i < Samples; ++i)
+		SISD[i] = A[i] * B[i];
+	std::printf("- loop: %d us\n", elapsed(t1));
+
+	std::vector<glm::mat4> AoS(Samples);
+	t1 = std::chrono::high_resolution_clock::now();
+	glm::mul(&A[0], &B[0], &AoS[0], Samples);
+	std::printf("- AoS batch: %d us\n", elapsed(t1));
+
+	std::vector<float> DataA(Samples * 16);
+	std::vector<float> DataB(Samples * 16);
+	std::vector<float> DataOut(Samples * 16);
+	glm::mat4_soa<float> const SoAA(&DataA[0], Samples);
+	glm::mat4_soa<float> const SoAB(&DataB[0], Samples);
+	glm::mat4_soa<float> const SoAOut(&DataOut[0], Samples);
+	for(std::size_t i = 0; i < Samples; ++i)
+	{
+		SoAA.set(i, A[i]);
+		SoAB.set(i, B[i]);
+	}
+	t1 = std::chrono::high_resolution_clock::now();
+	glm::mul(SoAA, SoAB, SoAOut);
+	std::printf("- SoA batch: %d us\n", elapsed(t1));
+
+	for(std::size_t i = 0; i < Samples; ++i)
+	{
+		Error += glm::all(glm::equal(SISD[i], AoS[i], 0.001f)) ? 0 : 1;
+		Error += glm::all(glm::equal(SISD[i], SoAOut[i], 0.001f)) ? 0 : 1;
+	}
+
+	return Error;
+}
+
+static int comp_inverse(std::size_t Samples)
+{
+	int Error = 0;
+
+	std::vector<glm::mat4> I(Samples);
+	for(std::size_t i = 0; i < Samples; ++i)
+		I[i] = glm::mat4(1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15, 16) * static_cast<float>(i % 100) * 0.01f + glm::mat4(8.0f);
+
+	std::vector<glm::mat4> SISD(Samples);
+	std::vector<float> SISDDet(Samples);
+	std::chrono::high_resolution_clock::time_point t1 = std::chrono::high_resolution_clock::now();
+	for(std::size_t i = 0; i < Samples; ++i)
+		SISD[i] = glm::inverse(I[i]);
+	std::printf("- inverse loop: %d us\n", elapsed(t1));
+
+	t1 = std::chrono::high_resolution_clock::now();
+	for(std::size_t i = 0; i < Samples; ++i)
+		SISDDet[i] = glm::determinant(I[i]);
+	std::printf("- determinant loop: %d us\n", elapsed(t1));
+
+	std::vector<glm::mat4> AoS(Samples);
+	t1 = std::chrono::high_resolution_clock::now();
+	glm::inverse(&I[0], &AoS[0], Samples);
+	std::printf("- inverse batch: %d us\n", elapsed(t1));
+
+	std::vector<float> AoSDet(Samples);
+	t1 = std::chrono::high_resolution_clock::now();
+	glm::determinant(&I[0], &AoSDet[0], Samples);
+	std::printf("- determinant batch: %d us\n", elapsed(t1));
+
+	for(std::size_t i = 0; i < Samples; ++i)
+	{
+		Error += glm::all(glm::equal(SISD[i], AoS[i], 0.0001f)) ? 0 : 1;
+		Error += glm::equal(SISDDet[i], AoSDet[i], glm::abs(SISDDet[i]) * 0.0001f) ? 0 : 1;
+	}
+
+	return Error;
+}
+
+int main()
+{
+	std::size_t const Samples = 100000;
+
+	int Error = 0;
+
+	std::printf("transform_points:\n");
+	Error += comp_transform_points(Samples);
+
+	std::printf("mul:\n");
+	Error += comp_mul(Samples);
+
+	std::printf("inverse:\n");
+	Error += comp_inverse(Samples);
+
+	return Error;
+}
+
+#else
+
+int main()
+{
+	return 0;
+}
+
+#endif
@@ -0,0 +1,120 @@
+#define GLM_FORCE_INLINE
+#include <glm/gtc/packing.hpp>
+#include <glm/ext/vector_float4.hpp>
+#include <glm/ext/vector_relational.hpp>
+#include <glm/ext/vector_int4_sized.hpp>
+#include <glm/ext/vector_uint4_sized.hpp>
+#if GLM_CONFIG_SIMD == GLM_ENABLE
+#include <vector>
+#include <chrono>
+#include <cstdio>
+
+static int elapsed(std::chrono::high_resolution_clock::time_point t1)
+{
+	std::chrono::high_resolution_clock::time_point t2 = std::chrono::high_resolution_clock::now();
+	return static_cast<int>(std::chrono::duration_cast<std::chrono::microseconds>(t2 - t1).count());
+}
+
+static std::vector<glm::vec4> samples(float Min, float Max, std::size_t Samples)
+{
+	std::vector<glm::vec4> I(Samples);
+	for(std::size_t i = 0; i < Samples; ++i)
+		I[i] = glm::vec4(0.0f, 0.25f, 0.5f, 0.75f) * (Max - Min) / static_cast<float>(Samples) + Min + (Max - Min) * static_cast<float>(i) / static_cast<float>(Samples);
+	return I;
+}
+
+static int comp_half(std::size_t Samples)
+{
+	int Error = 0;
+
+	std::vector<glm::vec4> const I = samples(-70000.0f, 70000.0f, Samples);
+
+	std::vector<glm::u16vec4> Loop(Samples);
+	std::chrono::high_resolution_clock::time_point t1 = std::chrono::high_resolution_clock::now();
+	for(std::size_t i = 0; i < Samples; ++i)
+		Loop[i] = glm::packHalf(I[i]);
+	std::printf("- loop: %d us\n", elapsed(t1));
+
+	std::vector<glm::u16vec4> Bulk(Samples);
+	t1 = std::chrono::high_resolution_clock::now();
+	glm::packHalf(&I[0], &Bulk[0], Samples);
+	std::printf("- bulk: %d us\n", elapsed(t1));
+
+	for(std::size_t i = 0; i < Samples; ++i)
+		Error += glm::all(glm::equal(Loop[i], Bulk[i])) ? 0 : 1;
+
+	return Error;
+}
+
+static int comp_snorm(std::size_t Samples)
+{
+	int Error = 0;
+
+	std::vector<glm::vec4> const I = samples(-1.2f, 1.2f, Samples);
+
+	std::vector<glm::i16vec4> Loop(Samples);
+	std::chrono::high_resolution_clock::time_point t1 = std::chrono::high_resolution_clock::now();
+	for(std::size_t i = 0; i < Samples; ++i)
+		Loop[i] = glm::packSnorm<glm::int16>(I[i]);
+	std::printf("- loop: %d us\n", elapsed(t1));
+
+	std::vector<glm::i16vec4> Bulk(Samples);
+	t1 = std::chrono::high_resolution_clock::now();
+	glm::packSnorm<glm::int16>(&I[0], &Bulk[0], Samples);
+	std::printf("- bulk: %d us\n", elapsed(t1));
+
+	for(std::size_t i = 0; i < Samples; ++i)
+		Error += glm::all(glm::equal(Loop[i], Bulk[i])) ? 0 : 1;
+
+	return Error;
+}
+
+static int comp_unorm(std::size_t Samples)
+{
+	int Error = 0;
+
+	std::vector<glm::vec4> const I = samples(-0.2f, 1.2f, Samples);
+
+	std::vector<glm::u8vec4> Loop(Samples);
+	std::chrono::high_resolution_clock::time_point t1 = std::chrono::high_resolution_clock::now();
+	for(std::size_t i = 0; i < Samples; ++i)
+		Loop[i] = glm::packUnorm<glm::uint8>(I[i]);
+	std::printf("- loop: %d us\n", elapsed(t1));
+
+	std::vector<glm::u8vec4> Bulk(Samples);
+	t1 = std::chrono::high_resolution_clock::now();
+	glm::packUnorm<glm::uint8>(&I[0], &Bulk[0], Samples);
+	std::printf("- bulk: %d us\n", elapsed(t1));
+
+	for(std::size_t i = 0; i < Samples; ++i)
+		Error += glm::all(glm::equal(Loop[i], Bulk[i])) ? 0 : 1;
+
+	return Error;
+}
+
+int main()
+{
+	std::size_t const Samples = 100000;
+
+	int Error = 0;
+
+	std::printf("packHalf:\n");
+	Error += comp_half(Samples);
+
+	std::printf("packSnorm<int16>:\n");
+	Error += comp_snorm(Samples);
+
+	std::printf("packUnorm<uint8>:\n");
+	Error += comp_unorm(Samples);
+
+	return Error;
+}
+
+#else
+
+int main()
+{
+	return 0;
+}
+
+#endif
@@ -0,0 +1,73 @@
+#define GLM_FORCE_INLINE
+#include <glm/trigonometric.hpp>
+#include <glm/ext/vector_float4.hpp>
+#include <glm/ext/vector_relational.hpp>
+#if GLM_CONFIG_SIMD == GLM_ENABLE
+#include <glm/gtc/type_aligned.hpp>
+#include <vector>
+#include <chrono>
+#include <cstdio>
+
+static int elapsed(std::chrono::high_resolution_clock::time_point t1)
+{
+	std::chrono::high_resolution_clock::time_point t2 = std::chrono::high_resolution_clock::now();
+	return static_cast<int>(std::chrono::duration_cast<std::chrono::microseconds>(t2 - t1).count());
+}
+
+template<typename packedVecType, typename alignedVecType>
+static int comp(char const* Name, packedVecType (*PackedFunc)(packedVecType const&), alignedVecType (*AlignedFunc)(alignedVecType const&), float Min, float Max, std::size_t Samples)
+{
+	int Error = 0;
+
+	std::vector<packedVecType> I(Samples);
+	std::vector<alignedVecType> AlignedI(Samples);
+	for(std::size_t i = 0; i < Samples; ++i)
+	{
+		I[i] = packedVecType(0.0f, 0.25f, 0.5f, 0.75f) * (Max - Min) / static_cast<float>(Samples) + Min + (Max - Min) * static_cast<float>(i) / static_cast<float>(Samples);
+		AlignedI[i] = alignedVecType(I[i]);
+	}
+
+	std::vector<packedVecType> SISD(Samples);
+	std::chrono::high_resolution_clock::time_point t1 = std::chrono::high_resolution_clock::now();
+	for(std::size_t i = 0; i < Samples; ++i)
+		SISD[i] = PackedFunc(I[i]);
+	int const TimeSISD = elapsed(t1);
+
+	std::vector<alignedVecType> SIMD(Samples);
+	t1 = std::chrono::high_resolution_clock::now();
+	for(std::size_t i = 0; i < Samples; ++i)
+		SIMD[i] = AlignedFunc(AlignedI[i]);
+	int const TimeSIMD = elapsed(t1);
+
+	std::printf("%s:\n- SISD: %d us\n- SIMD: %d us\n", Name, TimeSISD, TimeSIMD);
+
+	for(std::size_t i = 0; i < Samples; ++i)
+		Error += glm::all(glm::equal(SISD[i], packedVecType(SIMD[i]), 0.0001f)) ? 0 : 1;
+
+	return Error;
+}
+
+int main()
+{
+	std::size_t const Samples = 100000;
+
+	int Error = 0;
+
+	Error += comp<glm::vec4, glm::aligned_vec4>("sin", glm::sin, glm::sin, -10.0f, 10.0f, Samples);
+	Error += comp<glm::vec4, glm::aligned_vec4>("cos", glm::cos, glm::cos, -10.0f, 10.0f, Samples);
+	Error += comp<glm::vec4, glm::aligned_vec4>("tan", glm::tan, glm::tan, -1.5f, 1.5f, Samples);
+	Error += comp<glm::vec4, glm::aligned_vec4>("asin", glm::asin, glm::asin, -1.0f, 1.0f, Samples);
+	Error += comp<glm::vec4, glm::aligned_vec4>("acos", glm::acos, glm::acos, -1.0f, 1.0f, Samples);
+	Error += comp<glm::vec4, glm::aligned_vec4>("atan", glm::atan, glm::atan, -10.0f, 10.0f, Samples);
+
+	return Error;
+}
+
+#else
+
+int main()
+{
+	return 0;
+}
+
+#endif
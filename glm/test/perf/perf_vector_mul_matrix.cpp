@@ -7,6 +7,7 @@
 #include <glm/ext/matrix_double4x4.hpp>
 #include <glm/ext/matrix_transform.hpp>
 #include <glm/ext/matrix_relational.hpp>
+#include <glm/ext/vector_relational.hpp>
 #include <glm/ext/vector_float4.hpp>
 #if GLM_CONFIG_SIMD == GLM_ENABLE
 #include <glm/gtc/type_aligned.hpp>
@@ -94,8 +95,6 @@ static int comp_vec3_mul_mat3(std::size_t Samples)
 template <typename packedMatType, typename packedVecType, typename alignedMatType, typename alignedVecType>
 static int comp_vec4_mul_mat4(std::size_t Samples)
 {
-	typedef typename packedMatType::value_type T;
-	
 	int Error = 0;
 
 	packedMatType const Transform(1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15, 16);
@@ -111,7 +110,9 @@ static int comp_vec4_mul_mat4(std::size_t Samples)
 	{
 		packedVecType const A = SISD[i];
 		packedVecType const B = SIMD[i];
-		Error += glm::all(glm::equal(A, B, static_cast<T>(0.001))) ? 0 : 1;
+		// with FMA the SIMD path rounds once per multiply-add instead of
+		// twice; the results grow past where an absolute epsilon covers that
+		Error += glm::all(glm::equal(A, B, 4)) ? 0 : 1;
 	}
 	
 	return Error;
@@ -0,0 +1,202 @@
+#ifndef GL_STATE_H
+#define GL_STATE_H
+
+#include <glad/glad.h>
+
+#include <cassert>
+
+// shadows the bits of GL state the renderer changes every frame and drops
+// calls that would set a value that is already current. Anything that
+// changes this state behind its back must call invalidate().
+class GLStateCache
+{
+public:
+	static const unsigned int MAX_TEXTURE_UNITS = 16;
+
+	// calls issued to / skipped from the driver since beginFrame()
+	unsigned int issued = 0;
+	unsigned int skipped = 0;
+	// totals of the previous frame
+	unsigned int lastFrameIssued = 0;
+	unsigned int lastFrameSkipped = 0;
+
+	// ------------------------------------------------------------------------
+	GLStateCache()
+	{
+		invalidate();
+	}
+	// ------------------------------------------------------------------------
+	void beginFrame()
+	{
+		lastFrameIssued = issued;
+		lastFrameSkipped = skipped;
+		issued = 0;
+		skipped = 0;
+	}
+	// forget everything; the next call of each kind always reaches GL
+	// ------------------------------------------------------------------------
+	void invalidate()
+	{
+		program = UNKNOWN;
+		vertexArray = UNKNOWN;
+		activeUnit = UNKNOWN;
+		for (unsigned int unit = 0; unit < MAX_TEXTURE_UNITS; unit++)
+		{
+			for (unsigned int target = 0; target < NUM_TARGETS; target++)
+				textures[unit][target] = UNKNOWN;
+		}
+		depthFunc = UNKNOWN;
+		blendEnabled = UNKNOWN;
+		blendSrc = UNKNOWN;
+		blendDst = UNKNOWN;
+	}
+	// ------------------------------------------------------------------------
+	void useProgram(GLuint id)
+	{
+		if (changed(program, id))
+			glUseProgram(id);
+	}
+	// ------------------------------------------------------------------------
+	void bindVertexArray(GLuint id)
+	{
+		if (changed(vertexArray, id))
+			glBindVertexArray(id);
+	}
+	// binds a texture to a unit, only switching the active unit when needed
+	// ------------------------------------------------------------------------
+	void bindTexture(GLuint unit, GLenum target, GLuint id)
+	{
+		unsigned int index = targetIndex(target);
+		assert(unit < MAX_TEXTURE_UNITS && "texture unit beyond the shadowed ones");
+		assert(index < NUM_TARGETS && "texture target not shadowed by GLStateCache");
+		if (unit >= MAX_TEXTURE_UNITS || index >= NUM_TARGETS)
+		{
+			// not shadowed: always reaches GL, and the active unit is then unknown
+			activeUnit = UNKNOWN;
+			issued++;
+			glActiveTexture(GL_TEXTURE0 + unit);
+			glBindTexture(target, id);
+			return;
+		}
+		GLuint& bound = textures[unit][index];
+		if (bound == id)
+		{
+			skipped++;
+			return;
+		}
+		if (changed(activeUnit, unit))
+			glActiveTexture(GL_TEXTURE0 + unit);
+		bound = id;
+		issued++;
+		glBindTexture(target, id);
+	}
+	// GL unbinds a deleted texture from every unit; call after glDeleteTextures
+	// so a recycled name is not mistaken for one that is still bound
+	// ------------------------------------------------------------------------
+	void forgetTexture(GLuint id)
+	{
+		for (unsigned int unit = 0; unit < MAX_TEXTURE_UNITS; unit++)
+		{
+			for (unsigned int target = 0; target < NUM_TARGETS; target++)
+			{
+				if (textures[unit][target] == id)
+					textures[unit][target] = 0;
+			}
+		}
+	}
+	// ------------------------------------------------------------------------
+	void setDepthFunc(GLenum func)
+	{
+		if (changed(depthFunc, func))
+			glDepthFunc(func);
+	}
+	// ------------------------------------------------------------------------
+	void setBlend(bool enabled)
+	{
+		if (!changed(blendEnabled, enabled ? 1u : 0u))
+			return;
+		if (enabled)
+			glEnable(GL_BLEND);
+		else
+			glDisable(GL_BLEND);
+	}
+	// ------------------------------------------------------------------------
+	void setBlendFunc(GLenum src, GLenum dst)
+	{
+		if (blendSrc == src && blendDst == dst)
+		{
+			skipped++;
+			return;
+		}
+		blendSrc = src;
+		blendDst = dst;
+		issued++;
+		glBlendFunc(src, dst);
+	}
+
+private:
+	static const GLuint UNKNOWN = 0xFFFFFFFFu;
+	static const unsigned int NUM_TARGETS = 11;
+
+	GLuint program = UNKNOWN;
+	GLuint vertexArray = UNKNOWN;
+	GLuint activeUnit = UNKNOWN;
+	GLuint textures[MAX_TEXTURE_UNITS][NUM_TARGETS];
+	GLuint depthFunc = UNKNOWN;
+	GLuint blendEnabled = UNKNOWN;
+	GLuint blendSrc = UNKNOWN;
+	GLuint blendDst = UNKNOWN;
+
+	// updates the shadow value and counts whether the GL call is needed
+	bool changed(GLuint& current, GLuint value)
+	{
+		if (current == value)
+		{
+			skipped++;
+			return false;
+		}
+		current = value;
+		issued++;
+		return true;
+	}
+	// one shadow slot per texture target; NUM_TARGETS for anything else
+	static unsigned int targetIndex(GLenum target)
+	{
+		switch (target)
+		{
+		case GL_TEXTURE_2D:
+			return 0;
+		case GL_TEXTURE_CUBE_MAP:
+			return 1;
+		case GL_TEXTURE_2D_ARRAY:
+			return 2;
+		case GL_TEXTURE_1D:
+			return 3;
+		case GL_TEXTURE_1D_ARRAY:
+			return 4;
+		case GL_TEXTURE_3D:
+			return 5;
+		case GL_TEXTURE_RECTANGLE:
+			return 6;
+		case GL_TEXTURE_CUBE_MAP_ARRAY:
+			return 7;
+		case GL_TEXTURE_BUFFER:
+			return 8;
+		case GL_TEXTURE_2D_MULTISAMPLE:
+			return 9;
+		case GL_TEXTURE_2D_MULTISAMPLE_ARRAY:
+			return 10;
+		default:
+			return NUM_TARGETS;
+		}
+	}
+};
+
+// the one cache for the GL context; the engine is single-context
+// ------------------------------------------------------------------------
+inline GLStateCache& glState()
+{
+	static GLStateCache cache;
+	return cache;
+}
+#endif
@@ -0,0 +1,486 @@
+#ifndef HEADLESS_H
+#define HEADLESS_H
+
+#include <glad/glad.h>
+#include <glm/glm.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <string>
+#include <vector>
+
+// Linux perf agents often have no display server, so headless runs there
+// create their context through EGL without any window system. Elsewhere
+// they fall back to a hidden GLFW window.
+#if defined(__linux__)
+#define HEADLESS_EGL
+#define EGL_NO_X11
+#include <EGL/egl.h>
+#include <EGL/eglext.h>
+#endif
+
+// command line for automated perf runs:
+//   --headless                 render offscreen, no visible window
+//   --frames N                 frames to render before exiting (default 300)
+//   --tick-rate HZ             simulation ticks per second (default 60)
+//   --time-scale S             simulated seconds per real second (default 1;
+//                              0 pauses the simulation)
+//   --capture-dir DIR          write PNG readbacks into DIR
+//   --capture-every K          capture every K-th frame (default: last frame only)
+//   --context egl|glfw         how the headless context is created: egl
+//                              needs no display (default on Linux), glfw
+//                              opens a hidden window (default elsewhere)
+//   --trace FILE               write a Chrome trace of the profiler scopes
+//                              on exit (also works without --headless)
+//   --workers N                threads decoding textures at startup
+//                              (default: one per hardware thread)
+//   --compress bc1|bc3|bc4|bc5|bc7  block-compress the 2D textures on load
+//   --bc-report FILE           print PSNR and encode speed of FILE in each
+//                              block-compressed format, then exit
+//   --cook                     convert assets/ into assets/cooked (in the
+//                              --compress format, if given), then exit
+//   --mip-filter box|kaiser|lanczos  mip filter for --cook (default kaiser)
+//   --cull-bench [N]           check SIMD frustum culling against the scalar
+//                              path on N spheres (default 1000000), time
+//                              both, then exit
+//   --queue-bench [N]          check the render queue's sort on N packets
+//                              (default 100000), time submit and sort,
+//                              then exit
+//   --uniform-bench            time uniform updates by name and through
+//                              Uniform<T> handles once the shaders are built
+//   --decode-bench FILE        decode FILE with stb_image's SIMD kernels and
+//                              its generic code, check both give the same
+//                              pixels, time both, then exit; repeat the
+//                              option for more files
+// ------------------------------------------------------------------------
+struct HeadlessOptions
+{
+	bool enabled = false;
+	unsigned int frames = 300;
+	double tickRate = 60.0;
+	double timeScale = 1.0;
+	std::string captureDir;
+	unsigned int captureEvery = 0;
+#if defined(HEADLESS_EGL)
+	std::string context = "egl";
+#else
+	std::string context = "glfw";
+#endif
+	std::string traceFile;
+	unsigned int decodeWorkers = 0;
+	std::string compression;
+	std::string compressionReport;
+	bool cook = false;
+	std::string mipFilter;
+	bool uniformBenchmark = false;
+	size_t cullBenchmark = 0;
+	size_t queueBenchmark = 0;
+	std::vector<std::string> decodeBenchmark;
+
+	// true when the given 0-based frame should be read back
+	bool captures(unsigned int frame) const
+	{
+		if (captureDir.empty())
+			return false;
+		if (captureEvery == 0)
+			return frame + 1 == frames;
+		return frame % captureEvery == 0;
+	}
+};
+
+// ------------------------------------------------------------------------
+inline HeadlessOptions parseHeadlessOptions(int argc, char** argv)
+{
+	HeadlessOptions options;
+	for (int i = 1; i < argc; i++)
+	{
+		std::string arg = argv[i];
+		bool hasValue = i + 1 < argc;
+		if (arg == "--headless")
+			options.enabled = true;
+		else if (arg == "--frames" && hasValue)
+			options.frames = static_cast<unsigned int>(std::max(1, std::atoi(argv[++i])));
+		else if (arg == "--tick-rate" && hasValue)
+		{
+			double rate = std::atof(argv[++i]);
+			if (rate > 0.0)
+				options.tickRate = rate;
+			else
+				std::cout << "Ignoring --tick-rate, it must be above 0: " << argv[i] << std::endl;
+		}
+		else if (arg == "--time-scale" && hasValue)
+			options.timeScale = std::max(0.0, std::atof(argv[++i]));
+		else if (arg == "--capture-dir" && hasValue)
+			options.captureDir = argv[++i];
+		else if (arg == "--capture-every" && hasValue)
+			options.captureEvery = static_cast<unsigned int>(std::max(0, std::atoi(argv[++i])));
+		else if (arg == "--context" && hasValue)
+			options.context = argv[++i];
+		else if (arg == "--trace" && hasValue)
+			options.traceFile = argv[++i];
+		else if (arg == "--workers" && hasValue)
+			options.decodeWorkers = static_cast<unsigned int>(std::max(0, std::atoi(argv[++i])));
+		else if (arg == "--compress" && hasValue)
+			options.compression = argv[++i];
+		else if (arg == "--bc-report" && hasValue)
+			options.compressionReport = argv[++i];
+		else if (arg == "--cook")
+			options.cook = true;
+		else if (arg == "--mip-filter" && hasValue)
+			options.mipFilter = argv[++i];
+		else if (arg == "--cull-bench")
+		{
+			options.cullBenchmark = 1000000;
+			if (hasValue && std::atoi(argv[i + 1]) > 0)
+				options.cullBenchmark = static_cast<size_t>(std::atoi(argv[++i]));
+		}
+		else if (arg == "--queue-bench")
+		{
+			options.queueBenchmark = 100000;
+			if (hasValue && std::atoi(argv[i + 1]) > 0)
+				options.queueBenchmark = static_cast<size_t>(std::atoi(argv[++i]));
+		}
+		else if (arg == "--uniform-bench")
+			options.uniformBenchmark = true;
+		else if (arg == "--decode-bench" && hasValue)
+			options.decodeBenchmark.push_back(argv[++i]);
+		else
+			std::cout << "Ignoring unknown argument: " << arg << std::endl;
+	}
+	return options;
+}
+
+// an OpenGL core context made current without a window or display: the
+// Mesa surfaceless platform when present (llvmpipe needs no GPU either),
+// otherwise the default EGL display. Headless runs render into an
+// OffscreenTarget, so no surface is needed unless the driver lacks
+// EGL_KHR_surfaceless_context, in which case a 1x1 pbuffer is bound.
+// ------------------------------------------------------------------------
+class HeadlessContext
+{
+public:
+#if defined(HEADLESS_EGL)
+	EGLDisplay display = EGL_NO_DISPLAY;
+	EGLContext context = EGL_NO_CONTEXT;
+	EGLSurface surface = EGL_NO_SURFACE;
+
+	// ------------------------------------------------------------------------
+	bool init(int major, int minor)
+	{
+		const char* clientExtensions = eglQueryString(EGL_NO_DISPLAY, EGL_EXTENSIONS);
+		PFNEGLGETPLATFORMDISPLAYEXTPROC getPlatformDisplay = reinterpret_cast<PFNEGLGETPLATFORMDISPLAYEXTPROC>(eglGetProcAddress("eglGetPlatformDisplayEXT"));
+		if (getPlatformDisplay && hasExtension(clientExtensions, "EGL_MESA_platform_surfaceless"))
+			display = getPlatformDisplay(EGL_PLATFORM_SURFACELESS_MESA, EGL_DEFAULT_DISPLAY, nullptr);
+		if (display == EGL_NO_DISPLAY)
+			display = eglGetDisplay(EGL_DEFAULT_DISPLAY);
+		if (display == EGL_NO_DISPLAY || !eglInitialize(display, nullptr, nullptr))
+			return fail("no EGL display");
+		if (!eglBindAPI(EGL_OPENGL_API))
+			return fail("EGL has no desktop OpenGL");
+
+		const EGLint configAttributes[] =
+		{
+			EGL_SURFACE_TYPE, EGL_PBUFFER_BIT,
+			EGL_RENDERABLE_TYPE, EGL_OPENGL_BIT,
+			EGL_NONE
+		};
+		EGLConfig config = nullptr;
+		EGLint configCount = 0;
+		eglChooseConfig(display, configAttributes, &config, 1, &configCount);
+		bool surfaceless = hasExtension(eglQueryString(display, EGL_EXTENSIONS), "EGL_KHR_surfaceless_context");
+		if (configCount == 0 && !surfaceless)
+			return fail("no pbuffer config");
+
+		const EGLint contextAttributes[] =
+		{
+			EGL_CONTEXT_MAJOR_VERSION, major,
+			EGL_CONTEXT_MINOR_VERSION, minor,
+			EGL_CONTEXT_OPENGL_PROFILE_MASK, EGL_CONTEXT_OPENGL_CORE_PROFILE_BIT,
+			EGL_NONE
+		};
+		context = eglCreateContext(display, configCount > 0 ? config : EGL_NO_CONFIG_KHR, EGL_NO_CONTEXT, contextAttributes);
+		if (context == EGL_NO_CONTEXT)
+			return fail("no OpenGL core context of the requested version");
+		if (!surfaceless)
+		{
+			const EGLint surfaceAttributes[] = { EGL_WIDTH, 1, EGL_HEIGHT, 1, EGL_NONE };
+			surface = eglCreatePbufferSurface(display, config, surfaceAttributes);
+			if (surface == EGL_NO_SURFACE)
+				return fail("no pbuffer surface");
+		}
+		if (!eglMakeCurrent(display, surface, surface, context))
+			return fail("eglMakeCurrent failed");
+		return true;
+	}
+	// ------------------------------------------------------------------------
+	static void* procAddress(const char* name)
+	{
+		return reinterpret_cast<void*>(eglGetProcAddress(name));
+	}
+	// ------------------------------------------------------------------------
+	void release()
+	{
+		if (display == EGL_NO_DISPLAY)
+			return;
+		eglMakeCurrent(display, EGL_NO_SURFACE, EGL_NO_SURFACE, EGL_NO_CONTEXT);
+		if (surface != EGL_NO_SURFACE)
+			eglDestroySurface(display, surface);
+		if (context != EGL_NO_CONTEXT)
+			eglDestroyContext(display, context);
+		eglTerminate(display);
+		display = EGL_NO_DISPLAY;
+		context = EGL_NO_CONTEXT;
+		surface = EGL_NO_SURFACE;
+	}
+
+private:
+	static bool hasExtension(const char* extensions, const char* name)
+	{
+		if (!extensions)
+			return false;
+		size_t length = std::strlen(name);
+		for (const char* found = std::strstr(extensions, name); found; found = std::strstr(found + length, name))
+		{
+			if ((found == extensions || found[-1] == ' ') && (found[length] == ' ' || found[length] == '\0'))
+				return true;
+		}
+		return false;
+	}
+	bool fail(const char* reason)
+	{
+		std::cout << "Failed to create EGL context: " << reason << " (EGL error 0x" << std::hex << eglGetError() << std::dec << ")" << std::endl;
+		release();
+		return false;
+	}
+#else
+	bool init(int, int)
+	{
+		std::cout << "Headless EGL contexts are only built on Linux; use --context glfw" << std::endl;
+		return false;
+	}
+	static void* procAddress(const char*)
+	{
+		return nullptr;
+	}
+	void release()
+	{
+	}
+#endif
+};
+
+// color + depth framebuffer object the headless mode renders into
+// ------------------------------------------------------------------------
+class OffscreenTarget
+{
+public:
+	unsigned int FBO = 0;
+	unsigned int colorTexture = 0;
+	unsigned int depthRenderbuffer = 0;
+	int width = 0;
+	int height = 0;
+
+	// ------------------------------------------------------------------------
+	bool init(int targetWidth, int targetHeight)
+	{
+		width = targetWidth;
+		height = targetHeight;
+
+		glGenFramebuffers(1, &FBO);
+		glBindFramebuffer(GL_FRAMEBUFFER, FBO);
+
+		glGenTextures(1, &colorTexture);
+		glBindTexture(GL_TEXTURE_2D, colorTexture);
+		glTexStorage2D(GL_TEXTURE_2D, 1, GL_RGBA8, width, height);
+		glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, colorTexture, 0);
+
+		glGenRenderbuffers(1, &depthRenderbuffer);
+		glBindRenderbuffer(GL_RENDERBUFFER, depthRenderbuffer);
+		glRenderbufferStorage(GL_RENDERBUFFER, GL_DEPTH24_STENCIL8, width, height);
+		glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_DEPTH_STENCIL_ATTACHMENT, GL_RENDERBUFFER, depthRenderbuffer);
+
+		bool complete = glCheckFramebufferStatus(GL_FRAMEBUFFER) == GL_FRAMEBUFFER_COMPLETE;
+		if (!complete)
+			std::cout << "ERROR::FRAMEBUFFER:: offscreen target is not complete" << std::endl;
+		glViewport(0, 0, width, height);
+		return complete;
+	}
+	// reads the color attachment as tightly packed RGBA, bottom row first
+	// ------------------------------------------------------------------------
+	void readPixels(std::vector<unsigned char>& pixels) const
+	{
+		pixels.resize(static_cast<size_t>(width) * height * 4);
+		glBindFramebuffer(GL_READ_FRAMEBUFFER, FBO);
+		glPixelStorei(GL_PACK_ALIGNMENT, 1);
+		glReadPixels(0, 0, width, height, GL_RGBA, GL_UNSIGNED_BYTE, pixels.data());
+	}
+	// ------------------------------------------------------------------------
+	void release()
+	{
+		glDeleteFramebuffers(1, &FBO);
+		glDeleteTextures(1, &colorTexture);
+		glDeleteRenderbuffers(1, &depthRenderbuffer);
+	}
+};
+
+// frame time samples in milliseconds and their summary
+// ------------------------------------------------------------------------
+class FrameStats
+{
+public:
+	void add(double milliseconds)
+	{
+		samples.push_back(milliseconds);
+	}
+	// nearest-rank percentile, p in [0, 100]
+	double percentile(double p) const
+	{
+		if (samples.empty())
+			return 0.0;
+		std::vector<double> sorted(samples);
+		std::sort(sorted.begin(), sorted.end());
+		size_t rank = static_cast<size_t>(std::ceil(p / 100.0 * sorted.size()));
+		return sorted[std::min(sorted.size() - 1, rank > 0 ? rank - 1 : 0)];
+	}
+	void print(std::ostream& out) const
+	{
+		double total = 0.0;
+		for (double sample : samples)
+			total += sample;
+		double mean = samples.empty() ? 0.0 : total / samples.size();
+		out << "frames: " << samples.size()
+			<< " mean: " << mean << " ms"
+			<< " min: " << percentile(0.0) << " ms"
+			<< " p50: " << percentile(50.0) << " ms"
+			<< " p95: " << percentile(95.0) << " ms"
+			<< " p99: " << percentile(99.0) << " ms"
+			<< " max: " << percentile(100.0) << " ms" << std::endl;
+	}
+
+private:
+	std::vector<double> samples;
+};
+
+// deterministic camera path for perf runs: one orbit around the scene
+// over the run, looking at the origin. t goes from 0 to 1.
+// ------------------------------------------------------------------------
+inline void scriptedCamera(float t, glm::vec3& position, glm::vec3& front)
+{
+	const float radius = 3.0f;
+	float angle = t * 2.0f * 3.14159265f;
+	position = glm::vec3(radius * std::sin(angle), 0.5f * std::sin(2.0f * angle), radius * std::cos(angle));
+	front = glm::normalize(-position);
+}
+
+namespace png_detail
+{
+	inline std::uint32_t crc32(const unsigned char* data, size_t length, std::uint32_t crc = 0)
+	{
+		static std::uint32_t table[256];
+		static bool tableReady = false;
+		if (!tableReady)
+		{
+			for (std::uint32_t n = 0; n < 256; n++)
+			{
+				std::uint32_t c = n;
+				for (int k = 0; k < 8; k++)
+					c = (c & 1) ? 0xEDB88320u ^ (c >> 1) : c >> 1;
+				table[n] = c;
+			}
+			tableReady = true;
+		}
+		crc = ~crc;
+		for (size_t i = 0; i < length; i++)
+			crc = table[(crc ^ data[i]) & 0xFF] ^ (crc >> 8);
+		return ~crc;
+	}
+	inline void putBigEndian(std::vector<unsigned char>& out, std::uint32_t value)
+	{
+		out.push_back(static_cast<unsigned char>(value >> 24));
+		out.push_back(static_cast<unsigned char>(value >> 16));
+		out.push_back(static_cast<unsigned char>(value >> 8));
+		out.push_back(static_cast<unsigned char>(value));
+	}
+	inline void writeChunk(std::FILE* file, const char* type, const std::vector<unsigned char>& data)
+	{
+		std::vector<unsigned char> chunk;
+		putBigEndian(chunk, static_cast<std::uint32_t>(data.size()));
+		chunk.insert(chunk.end(), type, type + 4);
+		chunk.insert(chunk.end(), data.begin(), data.end());
+		putBigEndian(chunk, crc32(chunk.data() + 4, chunk.size() - 4));
+		std::fwrite(chunk.data(), 1, chunk.size(), file);
+	}
+}
+
+// writes an RGBA8 image given bottom row first (as glReadPixels returns
+// it) to a PNG. The zlib stream uses stored blocks: readbacks are for
+// diffing, not for size.
+// ------------------------------------------------------------------------
+inline bool writePNG(const std::string& path, int width, int height, const std::vector<unsigned char>& pixels)
+{
+	std::FILE* file = std::fopen(path.c_str(), "wb");
+	if (!file)
+	{
+		std::cout << "Failed to write capture: " << path << std::endl;
+		return false;
+	}
+
+	static const unsigned char signature[8] = { 0x89, 'P', 'N', 'G', '\r', '\n', 0x1A, '\n' };
+	std::fwrite(signature, 1, sizeof(signature), file);
+
+	std::vector<unsigned char> header;
+	png_detail::putBigEndian(header, static_cast<std::uint32_t>(width));
+	png_detail::putBigEndian(header, static_cast<std::uint32_t>(height));
+	header.push_back(8);	// bit depth
+	header.push_back(6);	// RGBA
+	header.push_back(0);
+	header.push_back(0);
+	header.push_back(0);
+	png_detail::writeChunk(file, "IHDR", header);
+
+	// filter type 0 per scanline, top row first
+	size_t rowBytes = static_cast<size_t>(width) * 4;
+	std::vector<unsigned char> raw;
+	raw.reserve((rowBytes + 1) * height);
+	for (int y = height - 1; y >= 0; y--)
+	{
+		raw.push_back(0);
+		const unsigned char* row = pixels.data() + rowBytes * y;
+		raw.insert(raw.end(), row, row + rowBytes);
+	}
+
+	std::vector<unsigned char> zlib;
+	zlib.push_back(0x78);
+	zlib.push_back(0x01);
+	size_t offset = 0;
+	do
+	{
+		size_t blockSize = std::min<size_t>(raw.size() - offset, 65535);
+		bool last = offset + blockSize == raw.size();
+		zlib.push_back(last ? 1 : 0);
+		zlib.push_back(static_cast<unsigned char>(blockSize));
+		zlib.push_back(static_cast<unsigned char>(blockSize >> 8));
+		zlib.push_back(static_cast<unsigned char>(~blockSize));
+		zlib.push_back(static_cast<unsigned char>(~blockSize >> 8));
+		zlib.insert(zlib.end(), raw.begin() + offset, raw.begin() + offset + blockSize);
+		offset += blockSize;
+	} while (offset < raw.size());
+
+	std::uint32_t a = 1, b = 0;
+	for (unsigned char byte : raw)
+	{
+		a = (a + byte) % 65521;
+		b = (b + a) % 65521;
+	}
+	png_detail::putBigEndian(zlib, (b << 16) | a);
+	png_detail::writeChunk(file, "IDAT", zlib);
+	png_detail::writeChunk(file, "IEND", std::vector<unsigned char>());
+
+	std::fclose(file);
+	return true;
+}
+#endif
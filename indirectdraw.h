@@ -0,0 +1,132 @@
+#ifndef INDIRECT_DRAW_H
+#define INDIRECT_DRAW_H
+
+#include <glad/glad.h>
+#include <glm/glm.hpp>
+
+#include <algorithm>
+#include <cstdint>
+#include <vector>
+
+// binding point of the DrawDataBuffer block in shader.vs
+const GLuint DRAW_DATA_BINDING = 1;
+
+// a range of the shared element buffer; firstIndex counts indices, not bytes
+// ------------------------------------------------------------------------
+struct SubMesh
+{
+	GLuint count = 0;
+	GLuint firstIndex = 0;
+	GLint baseVertex = 0;
+};
+
+// layout fixed by glMultiDrawElementsIndirect
+// ------------------------------------------------------------------------
+struct DrawElementsIndirectCommand
+{
+	GLuint count;
+	GLuint instanceCount;
+	GLuint firstIndex;
+	GLint baseVertex;
+	GLuint baseInstance;
+};
+
+// per-draw data read in the shader with gl_DrawIDARB, std430 layout
+// ------------------------------------------------------------------------
+struct DrawData
+{
+	glm::mat4 model;
+	std::uint32_t material;
+	std::uint32_t padding[3];
+};
+static_assert(sizeof(DrawData) == 80, "DrawData must match the std430 struct layout");
+
+// turns a list of visible sub-meshes of one VAO into indirect commands plus
+// a per-draw SSBO, so the whole list is drawn with one API call
+class IndirectDrawBuilder
+{
+public:
+	unsigned int commandBuffer = 0;
+	unsigned int drawDataBuffer = 0;
+
+	// ------------------------------------------------------------------------
+	void init()
+	{
+		glGenBuffers(1, &commandBuffer);
+		glGenBuffers(1, &drawDataBuffer);
+	}
+	// ------------------------------------------------------------------------
+	void clear()
+	{
+		commands.clear();
+		drawData.clear();
+	}
+	// instances of a draw are numbered from baseInstance for instanced attributes
+	// ------------------------------------------------------------------------
+	void add(const SubMesh& mesh, const glm::mat4& model, std::uint32_t material, GLuint instanceCount = 1, GLuint baseInstance = 0)
+	{
+		DrawElementsIndirectCommand command;
+		command.count = mesh.count;
+		command.instanceCount = instanceCount;
+		command.firstIndex = mesh.firstIndex;
+		command.baseVertex = mesh.baseVertex;
+		command.baseInstance = baseInstance;
+		commands.push_back(command);
+
+		DrawData data;
+		data.model = model;
+		data.material = material;
+		data.padding[0] = data.padding[1] = data.padding[2] = 0;
+		drawData.push_back(data);
+	}
+	// ------------------------------------------------------------------------
+	GLsizei size() const
+	{
+		return static_cast<GLsizei>(commands.size());
+	}
+	// uploads both buffers and leaves the command buffer bound to
+	// GL_DRAW_INDIRECT_BUFFER and the draw data at DRAW_DATA_BINDING
+	// ------------------------------------------------------------------------
+	void upload()
+	{
+		glBindBuffer(GL_DRAW_INDIRECT_BUFFER, commandBuffer);
+		write(GL_DRAW_INDIRECT_BUFFER, commandCapacity, commands.size() * sizeof(DrawElementsIndirectCommand), commands.data());
+
+		glBindBuffer(GL_SHADER_STORAGE_BUFFER, drawDataBuffer);
+		write(GL_SHADER_STORAGE_BUFFER, drawDataCapacity, drawData.size() * sizeof(DrawData), drawData.data());
+		glBindBufferBase(GL_SHADER_STORAGE_BUFFER, DRAW_DATA_BINDING, drawDataBuffer);
+	}
+	// draws every command; the VAO and program must already be bound
+	// ------------------------------------------------------------------------
+	void draw() const
+	{
+		glMultiDrawElementsIndirect(GL_TRIANGLES, GL_UNSIGNED_INT, (void*)0, size(), 0);
+	}
+	// ------------------------------------------------------------------------
+	void release()
+	{
+		glDeleteBuffers(1, &commandBuffer);
+		glDeleteBuffers(1, &drawDataBuffer);
+		commandCapacity = drawDataCapacity = 0;
+	}
+
+private:
+	std::vector<DrawElementsIndirectCommand> commands;
+	std::vector<DrawData> drawData;
+	size_t commandCapacity = 0;
+	size_t drawDataCapacity = 0;
+
+	// orphans the store when it has to grow, otherwise overwrites in place
+	static void write(GLenum target, size_t& capacity, size_t bytes, const void* data)
+	{
+		if (bytes == 0)
+			return;
+		if (bytes > capacity)
+		{
+			capacity = std::max(bytes, capacity * 2);
+			glBufferData(target, capacity, nullptr, GL_DYNAMIC_DRAW);
+		}
+		glBufferSubData(target, 0, bytes, data);
+	}
+};
+#endif
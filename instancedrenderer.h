@@ -0,0 +1,189 @@
+#ifndef INSTANCED_RENDERER_H
+#define INSTANCED_RENDERER_H
+
+#include <glad/glad.h>
+#include <glm/glm.hpp>
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "glstate.h"
+#include "indirectdraw.h"
+
+// per-instance data, laid out to match the instance attributes in shader.vs
+// ------------------------------------------------------------------------
+struct CubeInstance
+{
+	glm::mat4 model = glm::mat4(1.0f);
+	glm::vec3 blendColor = glm::vec3(0.0f);
+	int applyBlend = 0;
+	// TextureRegion indices of the base and blend textures
+	std::uint32_t texture = 0;
+	std::uint32_t blendTexture = 0;
+};
+
+// draws any number of copies of one sub-mesh of a VAO with a single
+// instanced call. Instances are kept on the CPU and only the range touched
+// since the last draw is re-uploaded, so submission cost does not grow with
+// the count.
+class InstancedRenderer
+{
+public:
+	unsigned int VAO = 0;
+	unsigned int instanceVBO = 0;
+	SubMesh mesh;
+
+	// adds the per-instance attributes at locations 3..10 to a VAO that
+	// already holds the mesh
+	// ------------------------------------------------------------------------
+	void init(unsigned int vao, const SubMesh& instancedMesh)
+	{
+		VAO = vao;
+		mesh = instancedMesh;
+		glGenBuffers(1, &instanceVBO);
+
+		glState().bindVertexArray(VAO);
+
+		// instance attributes: a mat4 takes four consecutive vec4 slots
+		glBindBuffer(GL_ARRAY_BUFFER, instanceVBO);
+		for (unsigned int column = 0; column < 4; column++)
+		{
+			glVertexAttribPointer(3 + column, 4, GL_FLOAT, GL_FALSE, sizeof(CubeInstance), (void*)(offsetof(CubeInstance, model) + sizeof(glm::vec4) * column));
+			glEnableVertexAttribArray(3 + column);
+			glVertexAttribDivisor(3 + column, 1);
+		}
+		glVertexAttribIPointer(7, 1, GL_INT, sizeof(CubeInstance), (void*)offsetof(CubeInstance, applyBlend));
+		glEnableVertexAttribArray(7);
+		glVertexAttribDivisor(7, 1);
+		glVertexAttribPointer(8, 3, GL_FLOAT, GL_FALSE, sizeof(CubeInstance), (void*)offsetof(CubeInstance, blendColor));
+		glEnableVertexAttribArray(8);
+		glVertexAttribDivisor(8, 1);
+		glVertexAttribIPointer(9, 1, GL_UNSIGNED_INT, sizeof(CubeInstance), (void*)offsetof(CubeInstance, texture));
+		glEnableVertexAttribArray(9);
+		glVertexAttribDivisor(9, 1);
+		glVertexAttribIPointer(10, 1, GL_UNSIGNED_INT, sizeof(CubeInstance), (void*)offsetof(CubeInstance, blendTexture));
+		glEnableVertexAttribArray(10);
+		glVertexAttribDivisor(10, 1);
+
+		glState().bindVertexArray(0);
+	}
+	// changes the number of instances; existing instances keep their data
+	// ------------------------------------------------------------------------
+	void resize(unsigned int count)
+	{
+		instances.resize(count);
+		markDirty(0, count);
+	}
+	// ------------------------------------------------------------------------
+	unsigned int size() const
+	{
+		return static_cast<unsigned int>(instances.size());
+	}
+	// write access to one instance; it is re-uploaded on the next draw
+	// ------------------------------------------------------------------------
+	CubeInstance& instance(unsigned int i)
+	{
+		markDirty(i, i + 1);
+		return instances[i];
+	}
+	// ------------------------------------------------------------------------
+	const CubeInstance& instance(unsigned int i) const
+	{
+		return instances[i];
+	}
+	// pushes instances written since the last upload to the instance buffer
+	// ------------------------------------------------------------------------
+	void upload()
+	{
+		if (instances.empty())
+			return;
+
+		glBindBuffer(GL_ARRAY_BUFFER, instanceVBO);
+		reserveBuffer();
+		if (holdsPacked)
+		{
+			// the buffer was last filled by uploadVisible()
+			markDirty(0, size());
+			holdsPacked = false;
+		}
+		dirtyEnd = std::min(dirtyEnd, size());
+		if (dirtyBegin < dirtyEnd)
+		{
+			glBufferSubData(GL_ARRAY_BUFFER, dirtyBegin * sizeof(CubeInstance), (dirtyEnd - dirtyBegin) * sizeof(CubeInstance), &instances[dirtyBegin]);
+			dirtyBegin = dirtyEnd = 0;
+		}
+	}
+	// uploads only the listed instances, packed to the front of the buffer,
+	// for draws that follow a culling pass. Returns the instance count to draw.
+	// ------------------------------------------------------------------------
+	unsigned int uploadVisible(const std::vector<std::uint32_t>& visible)
+	{
+		if (visible.empty())
+			return 0;
+
+		packed.resize(visible.size());
+		for (size_t i = 0; i < visible.size(); i++)
+			packed[i] = instances[visible[i]];
+
+		glBindBuffer(GL_ARRAY_BUFFER, instanceVBO);
+		reserveBuffer();
+		glBufferSubData(GL_ARRAY_BUFFER, 0, packed.size() * sizeof(CubeInstance), packed.data());
+		holdsPacked = true;
+		dirtyBegin = dirtyEnd = 0;
+		return static_cast<unsigned int>(packed.size());
+	}
+	// uploads pending changes and draws every instance in one call. The
+	// caller is expected to have the instancing shader bound.
+	// ------------------------------------------------------------------------
+	void draw()
+	{
+		if (instances.empty())
+			return;
+
+		upload();
+		glState().bindVertexArray(VAO);
+		glDrawElementsInstancedBaseVertex(GL_TRIANGLES, mesh.count, GL_UNSIGNED_INT, (void*)(sizeof(unsigned int) * mesh.firstIndex), size(), mesh.baseVertex);
+	}
+	// ------------------------------------------------------------------------
+	void release()
+	{
+		glDeleteBuffers(1, &instanceVBO);
+		instances.clear();
+		capacity = 0;
+	}
+
+private:
+	std::vector<CubeInstance> instances;
+	std::vector<CubeInstance> packed;
+	size_t capacity = 0;
+	bool holdsPacked = false;
+	unsigned int dirtyBegin = 0;
+	unsigned int dirtyEnd = 0;
+
+	// grows the bound instance buffer geometrically to fit every instance
+	void reserveBuffer()
+	{
+		if (instances.size() <= capacity)
+			return;
+		capacity = std::max<size_t>(instances.size(), capacity * 2);
+		glBufferData(GL_ARRAY_BUFFER, capacity * sizeof(CubeInstance), nullptr, GL_DYNAMIC_DRAW);
+		markDirty(0, size());
+	}
+	void markDirty(unsigned int begin, unsigned int end)
+	{
+		end = std::min(end, size());
+		if (begin >= end)
+			return;
+		if (dirtyBegin >= dirtyEnd)
+		{
+			dirtyBegin = begin;
+			dirtyEnd = end;
+			return;
+		}
+		dirtyBegin = std::min(dirtyBegin, begin);
+		dirtyEnd = std::max(dirtyEnd, end);
+	}
+};
+#endif
@@ -0,0 +1,524 @@
+#ifndef MIP_GENERATOR_H
+#define MIP_GENERATOR_H
+
+#include <algorithm>
+#include <climits>
+#include <cmath>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "assetloader.h"
+
+#if defined(__AVX__)
+#define MIP_GENERATOR_AVX
+#include <immintrin.h>
+#elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define MIP_GENERATOR_SSE2
+#include <emmintrin.h>
+#endif
+
+// reconstruction filters for the 2:1 reductions, widest last
+enum MipFilter
+{
+	MIP_FILTER_BOX = 0,		// 2x2 average, what glGenerateMipmap usually does
+	MIP_FILTER_KAISER,		// Kaiser-windowed sinc, radius 3, alpha 4
+	MIP_FILTER_LANCZOS,		// Lanczos-3
+};
+
+// "box", "kaiser" or "lanczos"; anything else is the default, Kaiser
+// ------------------------------------------------------------------------
+inline MipFilter parseMipFilter(const std::string& name)
+{
+	if (name == "box")
+		return MIP_FILTER_BOX;
+	if (name == "lanczos")
+		return MIP_FILTER_LANCZOS;
+	return MIP_FILTER_KAISER;
+}
+
+// ------------------------------------------------------------------------
+struct MipOptions
+{
+	MipFilter filter = MIP_FILTER_KAISER;
+	// color channels are sRGB encoded: filter them in linear space
+	bool srgb = true;
+	// sample across the edges as GL_REPEAT does, instead of clamping
+	bool wrap = false;
+	// when above 0, alpha is rescaled on every level so the share of texels
+	// passing an alpha test at this cutoff stays what it is on level 0
+	float alphaCutoff = 0.0f;
+};
+
+// ------------------------------------------------------------------------
+struct MipLevel
+{
+	int width;
+	int height;
+	std::vector<std::uint8_t> pixels;
+};
+
+namespace mip_detail
+{
+	const float PI = 3.14159265358979f;
+
+	inline float sinc(float x)
+	{
+		if (std::fabs(x) < 1e-5f)
+			return 1.0f;
+		x *= PI;
+		return std::sin(x) / x;
+	}
+	// modified Bessel function of the first kind, order 0
+	inline float besselI0(float x)
+	{
+		float sum = 1.0f, term = 1.0f;
+		for (int k = 1; k < 32 && term > sum * 1e-8f; k++)
+		{
+			float factor = x / (2.0f * k);
+			term *= factor * factor;
+			sum += term;
+		}
+		return sum;
+	}
+	// kernel radius in destination texels
+	inline float support(MipFilter filter)
+	{
+		return filter == MIP_FILTER_BOX ? 0.5f : 3.0f;
+	}
+	inline float evaluate(MipFilter filter, float t)
+	{
+		float radius = support(filter);
+		if (std::fabs(t) > radius)
+			return 0.0f;
+		switch (filter)
+		{
+		case MIP_FILTER_KAISER:
+		{
+			const float alpha = 4.0f;
+			float ratio = t / radius;
+			return sinc(t) * besselI0(alpha * std::sqrt(1.0f - ratio * ratio)) / besselI0(alpha);
+		}
+		case MIP_FILTER_LANCZOS:
+			return sinc(t) * sinc(t / radius);
+		default:
+			return 1.0f;
+		}
+	}
+
+	// source texels and weights for every destination texel along one axis;
+	// every destination texel has the same number of taps, padded with zero
+	// weights, so the inner loops need no bounds
+	struct Taps
+	{
+		int count = 0;
+		// unclamped position of each destination texel's first tap
+		std::vector<int> firsts;
+		std::vector<int> indices;
+		std::vector<float> weights;
+	};
+	inline Taps makeTaps(int sourceSize, int targetSize, MipFilter filter, bool wrap)
+	{
+		Taps taps;
+		float scale = static_cast<float>(sourceSize) / targetSize;
+		float radius = support(filter) * scale;
+		// the span of source texels with a nonzero weight, widest over all
+		// destination texels
+		auto span = [&](int i, int& first, int& last)
+		{
+			float center = (i + 0.5f) * scale - 0.5f;
+			first = static_cast<int>(std::ceil(center - radius));
+			last = static_cast<int>(std::floor(center + radius));
+			while (first < last && evaluate(filter, (first - center) / scale) == 0.0f)
+				first++;
+			while (last > first && evaluate(filter, (last - center) / scale) == 0.0f)
+				last--;
+		};
+		for (int i = 0; i < targetSize; i++)
+		{
+			int first, last;
+			span(i, first, last);
+			taps.count = std::max(taps.count, last - first + 1);
+		}
+		taps.indices.resize(static_cast<size_t>(targetSize) * taps.count);
+		taps.weights.resize(taps.indices.size());
+		taps.firsts.resize(targetSize);
+		for (int i = 0; i < targetSize; i++)
+		{
+			float center = (i + 0.5f) * scale - 0.5f;
+			int first, last;
+			span(i, first, last);
+			taps.firsts[i] = first;
+			float sum = 0.0f;
+			for (int k = 0; k < taps.count; k++)
+			{
+				int source = first + k;
+				float weight = source <= last ? evaluate(filter, (source - center) / scale) : 0.0f;
+				if (wrap)
+					source = ((source % sourceSize) + sourceSize) % sourceSize;
+				else
+					source = std::min(std::max(source, 0), sourceSize - 1);
+				taps.indices[i * taps.count + k] = source;
+				taps.weights[i * taps.count + k] = weight;
+				sum += weight;
+			}
+			for (int k = 0; k < taps.count; k++)
+				taps.weights[i * taps.count + k] = sum != 0.0f ? taps.weights[i * taps.count + k] / sum : (k == 0 ? 1.0f : 0.0f);
+		}
+		return taps;
+	}
+
+	// 8-bit -> float and float -> 8-bit conversions, sRGB and linear, as
+	// tables; the encode tables are fine enough to land within one code of
+	// the exact curve
+	struct ConversionTables
+	{
+		static const int ENCODE_SIZE = 16384;
+
+		float decodeSRGB[256];
+		float decodeLinear[256];
+		std::uint8_t encodeSRGB[ENCODE_SIZE];
+		std::uint8_t encodeLinear[ENCODE_SIZE];
+
+		ConversionTables()
+		{
+			for (int i = 0; i < 256; i++)
+			{
+				float value = i / 255.0f;
+				decodeSRGB[i] = value <= 0.04045f ? value / 12.92f : std::pow((value + 0.055f) / 1.055f, 2.4f);
+				decodeLinear[i] = value;
+			}
+			for (int i = 0; i < ENCODE_SIZE; i++)
+			{
+				float value = i / static_cast<float>(ENCODE_SIZE - 1);
+				float encoded = value <= 0.0031308f ? value * 12.92f : 1.055f * std::pow(value, 1.0f / 2.4f) - 0.055f;
+				encodeSRGB[i] = static_cast<std::uint8_t>(std::min(255.0f, encoded * 255.0f + 0.5f));
+				encodeLinear[i] = static_cast<std::uint8_t>(value * 255.0f + 0.5f);
+			}
+		}
+	};
+	inline const ConversionTables& conversionTables()
+	{
+		static const ConversionTables tables;
+		return tables;
+	}
+
+	// -1, or the channel holding alpha
+	inline int alphaChannel(int channels)
+	{
+		return channels == 2 ? 1 : channels == 4 ? 3 : -1;
+	}
+
+	// sum of weights[k] * rows[k][i] over a row of floats
+	inline void filterRows(const float* const* rows, const float* weights, int count, size_t length, float* out)
+	{
+		size_t i = 0;
+#if defined(MIP_GENERATOR_AVX)
+		for (; i + 8 <= length; i += 8)
+		{
+			__m256 sum = _mm256_mul_ps(_mm256_loadu_ps(rows[0] + i), _mm256_set1_ps(weights[0]));
+			for (int k = 1; k < count; k++)
+				sum = _mm256_add_ps(sum, _mm256_mul_ps(_mm256_loadu_ps(rows[k] + i), _mm256_set1_ps(weights[k])));
+			_mm256_storeu_ps(out + i, sum);
+		}
+#elif defined(MIP_GENERATOR_SSE2)
+		for (; i + 4 <= length; i += 4)
+		{
+			__m128 sum = _mm_mul_ps(_mm_loadu_ps(rows[0] + i), _mm_set1_ps(weights[0]));
+			for (int k = 1; k < count; k++)
+				sum = _mm_add_ps(sum, _mm_mul_ps(_mm_loadu_ps(rows[k] + i), _mm_set1_ps(weights[k])));
+			_mm_storeu_ps(out + i, sum);
+		}
+#endif
+		for (; i < length; i++)
+		{
+			float sum = rows[0][i] * weights[0];
+			for (int k = 1; k < count; k++)
+				sum += rows[k][i] * weights[k];
+			out[i] = sum;
+		}
+	}
+
+	// horizontal pass over one row of RGBA float texels
+	inline void filterColumns(const float* row, const Taps& taps, int width, float* out)
+	{
+		int x = 0;
+		const int* indices = taps.indices.data();
+		const float* weights = taps.weights.data();
+#if defined(MIP_GENERATOR_AVX)
+		// two destination texels per register
+		for (; x + 2 <= width; x += 2)
+		{
+			const int* left = indices + x * taps.count;
+			const int* right = left + taps.count;
+			const float* leftWeights = weights + x * taps.count;
+			const float* rightWeights = leftWeights + taps.count;
+			__m256 sum = _mm256_setzero_ps();
+			for (int k = 0; k < taps.count; k++)
+			{
+				__m256 texels = _mm256_insertf128_ps(_mm256_castps128_ps256(_mm_loadu_ps(row + left[k] * 4)), _mm_loadu_ps(row + right[k] * 4), 1);
+				__m256 weight = _mm256_insertf128_ps(_mm256_castps128_ps256(_mm_set1_ps(leftWeights[k])), _mm_set1_ps(rightWeights[k]), 1);
+				sum = _mm256_add_ps(sum, _mm256_mul_ps(texels, weight));
+			}
+			_mm256_storeu_ps(out + x * 4, sum);
+		}
+#endif
+#if defined(MIP_GENERATOR_AVX) || defined(MIP_GENERATOR_SSE2)
+		for (; x < width; x++)
+		{
+			__m128 sum = _mm_setzero_ps();
+			for (int k = 0; k < taps.count; k++)
+				sum = _mm_add_ps(sum, _mm_mul_ps(_mm_loadu_ps(row + indices[x * taps.count + k] * 4), _mm_set1_ps(weights[x * taps.count + k])));
+			_mm_storeu_ps(out + x * 4, sum);
+		}
+#else
+		for (; x < width; x++)
+		{
+			for (int c = 0; c < 4; c++)
+			{
+				float sum = 0.0f;
+				for (int k = 0; k < taps.count; k++)
+					sum += row[indices[x * taps.count + k] * 4 + c] * weights[x * taps.count + k];
+				out[x * 4 + c] = sum;
+			}
+		}
+#endif
+	}
+
+	// rows of the level being reduced as RGBA floats in linear space. Level 0
+	// is converted from 8 bits on demand into a small ring of rows per thread
+	// (consecutive destination rows share most source rows); later levels
+	// are already floats. The ring is keyed by unclamped tap position, which
+	// is distinct for every tap of one destination row even where clamping
+	// or wrapping maps two taps to the same source row.
+	class SourceRows
+	{
+	public:
+		SourceRows(const std::uint8_t* pixels8, const float* pixels32, int width, int channels, bool srgb, int ringSize)
+			: bytes(pixels8), floats(pixels32), width(width), channels(channels)
+		{
+			if (!floats)
+			{
+				// lanes past the image's channels stay 0
+				ring.assign(static_cast<size_t>(ringSize) * width * 4, 0.0f);
+				held.assign(ringSize, INT_MIN);
+			}
+			for (int c = 0; c < 4; c++)
+				decode[c] = srgb && c != alphaChannel(channels) ? conversionTables().decodeSRGB : conversionTables().decodeLinear;
+		}
+		const float* row(int position, int y)
+		{
+			if (floats)
+				return floats + static_cast<size_t>(y) * width * 4;
+			int size = static_cast<int>(held.size());
+			int slot = ((position % size) + size) % size;
+			float* target = &ring[static_cast<size_t>(slot) * width * 4];
+			if (held[slot] != position)
+			{
+				convert(bytes + static_cast<size_t>(y) * width * channels, target);
+				held[slot] = position;
+			}
+			return target;
+		}
+
+	private:
+		const std::uint8_t* bytes;
+		const float* floats;
+		int width;
+		int channels;
+		const float* decode[4];
+		std::vector<float> ring;
+		std::vector<int> held;
+
+		void convert(const std::uint8_t* source, float* target) const
+		{
+			if (channels == 4)
+			{
+				for (int x = 0; x < width; x++, source += 4, target += 4)
+				{
+					target[0] = decode[0][source[0]];
+					target[1] = decode[1][source[1]];
+					target[2] = decode[2][source[2]];
+					target[3] = decode[3][source[3]];
+				}
+				return;
+			}
+			for (int x = 0; x < width; x++, source += channels, target += 4)
+			{
+				for (int c = 0; c < channels; c++)
+					target[c] = decode[c][source[c]];
+			}
+		}
+	};
+
+	// RGBA float texels, times scale per lane, to 8 bits through the per-lane
+	// encode tables
+	inline void quantize(const float* texels, size_t count, int channels, const std::uint8_t* const encode[4], const float scale[4],
+		std::uint8_t* out)
+	{
+		const float top = static_cast<float>(ConversionTables::ENCODE_SIZE - 1);
+		for (size_t i = 0; i < count; i++, texels += 4, out += channels)
+		{
+			std::int32_t index[4];
+#if defined(MIP_GENERATOR_AVX) || defined(MIP_GENERATOR_SSE2)
+			__m128 value = _mm_mul_ps(_mm_loadu_ps(texels), _mm_loadu_ps(scale));
+			value = _mm_min_ps(_mm_max_ps(value, _mm_setzero_ps()), _mm_set1_ps(1.0f));
+			_mm_storeu_si128(reinterpret_cast<__m128i*>(index), _mm_cvttps_epi32(_mm_add_ps(_mm_mul_ps(value, _mm_set1_ps(top)), _mm_set1_ps(0.5f))));
+#else
+			for (int c = 0; c < 4; c++)
+				index[c] = static_cast<std::int32_t>(std::min(1.0f, std::max(0.0f, texels[c] * scale[c])) * top + 0.5f);
+#endif
+			for (int c = 0; c < channels; c++)
+				out[c] = encode[c][index[c]];
+		}
+	}
+
+	// the alpha value a texel of this level needs so that the same share of
+	// texels passes as on level 0, from a histogram of the level's alpha
+	inline float coverageThreshold(const float* texels, size_t count, int alpha, float coverage)
+	{
+		const int BINS = 4096;
+		std::vector<unsigned int> histogram(BINS, 0);
+		for (size_t i = 0; i < count; i++)
+		{
+			float value = std::min(1.0f, std::max(0.0f, texels[i * 4 + alpha]));
+			histogram[static_cast<int>(value * (BINS - 1) + 0.5f)]++;
+		}
+		size_t wanted = static_cast<size_t>(coverage * count + 0.5f);
+		size_t above = 0;
+		for (int bin = BINS - 1; bin > 0; bin--)
+		{
+			above += histogram[bin];
+			if (above >= wanted)
+				return static_cast<float>(bin) / (BINS - 1);
+		}
+		return 0.0f;
+	}
+}
+
+namespace mip_detail
+{
+	// filters a width x height level, 8-bit pixels or the RGBA floats of a
+	// level filtered before, to targetWidth x targetHeight RGBA floats in
+	// linear space. Destination rows are split over the pool in bands.
+	inline void filterLevel(const std::uint8_t* bytes, const float* floats, int width, int height, int channels, int targetWidth,
+		int targetHeight, const MipOptions& options, JobPool* pool, std::vector<float>& target)
+	{
+		Taps rows = makeTaps(height, targetHeight, options.filter, options.wrap);
+		Taps columns = makeTaps(width, targetWidth, options.filter, options.wrap);
+		target.resize(static_cast<size_t>(targetWidth) * targetHeight * 4);
+
+		// bands of rows, a few per thread so uneven bands even out
+		int bandCount = std::min(pool ? static_cast<int>(pool->size() + 1) * 4 : 1, targetHeight);
+		parallelFor(pool, bandCount, [&](int band)
+		{
+			int first = targetHeight * band / bandCount, last = targetHeight * (band + 1) / bandCount;
+			SourceRows sourceRows(bytes, floats, width, channels, options.srgb, rows.count);
+			std::vector<float> filtered(static_cast<size_t>(width) * 4);
+			std::vector<const float*> taps(rows.count);
+			for (int y = first; y < last; y++)
+			{
+				for (int k = 0; k < rows.count; k++)
+					taps[k] = sourceRows.row(rows.firsts[y] + k, rows.indices[y * rows.count + k]);
+				filterRows(taps.data(), &rows.weights[y * rows.count], rows.count, filtered.size(), filtered.data());
+				filterColumns(filtered.data(), columns, targetWidth, &target[static_cast<size_t>(y) * targetWidth * 4]);
+			}
+		});
+	}
+
+	// filtered RGBA floats back to 8 bits with the image's channel count;
+	// scale multiplies each lane first
+	inline MipLevel quantizeLevel(const std::vector<float>& texels, int width, int height, int channels, const MipOptions& options,
+		const float scale[4], JobPool* pool)
+	{
+		const ConversionTables& tables = conversionTables();
+		const std::uint8_t* encode[4];
+		for (int c = 0; c < 4; c++)
+			encode[c] = options.srgb && c != alphaChannel(channels) ? tables.encodeSRGB : tables.encodeLinear;
+		MipLevel level{ width, height, std::vector<std::uint8_t>(static_cast<size_t>(width) * height * channels) };
+		int bandCount = std::min(pool ? static_cast<int>(pool->size() + 1) * 4 : 1, height);
+		parallelFor(pool, bandCount, [&](int band)
+		{
+			size_t first = static_cast<size_t>(height * band / bandCount) * width;
+			size_t last = static_cast<size_t>(height * (band + 1) / bandCount) * width;
+			quantize(&texels[first * 4], last - first, channels, encode, scale, &level.pixels[first * channels]);
+		});
+		return level;
+	}
+}
+
+// the full mip chain of an 8-bit image, level 0 being a copy of it. Each
+// level is filtered from the one above it in floating point, so rounding
+// does not build up, and written back with the image's channel count.
+// Destination rows are split over the pool (see parallelFor).
+// ------------------------------------------------------------------------
+inline std::vector<MipLevel> generateMips(const std::uint8_t* pixels, int width, int height, int channels, const MipOptions& options,
+	JobPool* pool = nullptr)
+{
+	std::vector<MipLevel> levels;
+	levels.push_back(MipLevel{ width, height, std::vector<std::uint8_t>(pixels, pixels + static_cast<size_t>(width) * height * channels) });
+	int alpha = mip_detail::alphaChannel(channels);
+	bool preserveCoverage = options.alphaCutoff > 0.0f && alpha >= 0;
+	float coverage = 0.0f;
+	if (preserveCoverage)
+	{
+		size_t passing = 0, count = static_cast<size_t>(width) * height;
+		for (size_t i = 0; i < count; i++)
+			passing += pixels[i * channels + alpha] / 255.0f > options.alphaCutoff ? 1 : 0;
+		coverage = static_cast<float>(passing) / count;
+	}
+
+	std::vector<float> source, target;
+	while (width > 1 || height > 1)
+	{
+		int targetWidth = std::max(1, width / 2), targetHeight = std::max(1, height / 2);
+		const std::uint8_t* bytes = source.empty() ? pixels : nullptr;
+		const float* floats = source.empty() ? nullptr : source.data();
+		mip_detail::filterLevel(bytes, floats, width, height, channels, targetWidth, targetHeight, options, pool, target);
+
+		float scale[4] = { 1.0f, 1.0f, 1.0f, 1.0f };
+		if (preserveCoverage)
+		{
+			float threshold = mip_detail::coverageThreshold(target.data(), target.size() / 4, alpha, coverage);
+			scale[alpha] = threshold > 0.0f ? options.alphaCutoff / threshold : 1.0f;
+		}
+		levels.push_back(mip_detail::quantizeLevel(target, targetWidth, targetHeight, channels, options, scale, pool));
+
+		source.swap(target);
+		width = targetWidth;
+		height = targetHeight;
+	}
+	return levels;
+}
+
+// an 8-bit image scaled down to targetWidth x targetHeight in one pass of
+// the options' filter, stretched to cover as many source texels as the
+// ratio asks for
+// ------------------------------------------------------------------------
+inline MipLevel resizeImage(const std::uint8_t* pixels, int width, int height, int channels, int targetWidth, int targetHeight,
+	const MipOptions& options, JobPool* pool = nullptr)
+{
+	std::vector<float> target;
+	mip_detail::filterLevel(pixels, nullptr, width, height, channels, targetWidth, targetHeight, options, pool, target);
+	const float scale[4] = { 1.0f, 1.0f, 1.0f, 1.0f };
+	return mip_detail::quantizeLevel(target, targetWidth, targetHeight, channels, options, scale, pool);
+}
+
+// true for images whose alpha is mostly fully on or off, like sprites cut
+// out of a background; those want MipOptions::alphaCutoff
+// ------------------------------------------------------------------------
+inline bool isAlphaCutout(const std::uint8_t* pixels, int width, int height, int channels)
+{
+	int alpha = mip_detail::alphaChannel(channels);
+	if (alpha < 0)
+		return false;
+	size_t count = static_cast<size_t>(width) * height, extremes = 0, transparent = 0;
+	for (size_t i = 0; i < count; i++)
+	{
+		std::uint8_t value = pixels[i * channels + alpha];
+		extremes += value < 8 || value > 247 ? 1 : 0;
+		transparent += value < 8 ? 1 : 0;
+	}
+	return transparent > count / 100 && extremes >= count * 9 / 10;
+}
+#endif
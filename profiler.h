@@ -0,0 +1,378 @@
+#ifndef PROFILER_H
+#define PROFILER_H
+
+// frame profiler: CPU scopes, GPU timer queries, Chrome trace export and a
+// rolling p50/p95/p99 summary per scope.
+//
+//   PROFILE_SCOPE("name")      times the enclosing block on the CPU
+//   PROFILE_GPU_SCOPE("name")  also times the GL commands issued in it
+//   PROFILE_FRAME()            once per frame, after the swap
+//
+// Define DISABLE_PROFILER to compile every marker out. Names must be
+// string literals (or otherwise outlive the profiler); only the pointer
+// is recorded.
+
+#if !defined(DISABLE_PROFILER)
+#define PROFILER_ENABLED
+#endif
+
+#if defined(PROFILER_ENABLED)
+
+#include <glad/glad.h>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <iostream>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+// ------------------------------------------------------------------------
+struct ProfileEvent
+{
+	const char* name;
+	std::uint64_t start;	// nanoseconds since the profiler started
+	std::uint64_t duration;
+	std::uint32_t thread;
+	bool gpu;
+};
+
+// single-producer/single-consumer ring, one per recording thread. The owning
+// thread pushes, Profiler::endFrame drains; neither side takes a lock.
+// ------------------------------------------------------------------------
+class ProfileRing
+{
+public:
+	static const std::uint32_t CAPACITY = 4096;	// power of two
+
+	std::uint32_t thread;
+
+	explicit ProfileRing(std::uint32_t threadIndex) : thread(threadIndex)
+	{
+	}
+	// drops the event when the consumer has fallen a full ring behind
+	// ------------------------------------------------------------------------
+	void push(const ProfileEvent& event)
+	{
+		std::uint32_t head = writeIndex.load(std::memory_order_relaxed);
+		if (head - readIndex.load(std::memory_order_acquire) == CAPACITY)
+		{
+			dropped.fetch_add(1, std::memory_order_relaxed);
+			return;
+		}
+		events[head & (CAPACITY - 1)] = event;
+		writeIndex.store(head + 1, std::memory_order_release);
+	}
+	// ------------------------------------------------------------------------
+	template <typename Consumer>
+	void drain(Consumer&& consume)
+	{
+		std::uint32_t tail = readIndex.load(std::memory_order_relaxed);
+		std::uint32_t head = writeIndex.load(std::memory_order_acquire);
+		for (; tail != head; tail++)
+			consume(events[tail & (CAPACITY - 1)]);
+		readIndex.store(tail, std::memory_order_release);
+	}
+
+	std::atomic<std::uint32_t> dropped{ 0 };
+
+private:
+	ProfileEvent events[CAPACITY];
+	std::atomic<std::uint32_t> writeIndex{ 0 };
+	std::atomic<std::uint32_t> readIndex{ 0 };
+};
+
+// GL_TIME_ELAPSED queries over a ring of frames. Drivers queue two or
+// three frames, so results are polled every frame and collected as soon
+// as they are available; only a frame about to be reused waits for what
+// it still has pending, so no result is ever dropped. Time-elapsed
+// queries cannot nest, so a GPU scope opened inside another one is timed
+// on the CPU only.
+// ------------------------------------------------------------------------
+class GpuTimer
+{
+public:
+	static const unsigned int BUFFERS = 4;
+	static const unsigned int MAX_QUERIES = 32;
+
+	// ------------------------------------------------------------------------
+	void init()
+	{
+		for (Frame& frame : frames)
+			glGenQueries(MAX_QUERIES, frame.queries);
+		initialized = true;
+	}
+	// returns false when the scope cannot get a query this frame
+	// ------------------------------------------------------------------------
+	bool begin(const char* name, std::uint64_t cpuStart)
+	{
+		Frame& frame = frames[current];
+		if (!initialized || active || frame.count == MAX_QUERIES)
+			return false;
+		frame.names[frame.count] = name;
+		frame.starts[frame.count] = cpuStart;
+		glBeginQuery(GL_TIME_ELAPSED, frame.queries[frame.count]);
+		active = true;
+		return true;
+	}
+	// ------------------------------------------------------------------------
+	void end()
+	{
+		glEndQuery(GL_TIME_ELAPSED);
+		frames[current].count++;
+		active = false;
+	}
+	// collects every result that is ready, oldest frame first, and
+	// recycles the oldest frame's queries for the next one
+	// ------------------------------------------------------------------------
+	template <typename Consumer>
+	void endFrame(Consumer&& consume)
+	{
+		current = (current + 1) % BUFFERS;
+		// the frame about to be reused waits for its last results
+		collect(frames[current], true, consume);
+		frames[current].count = 0;
+		frames[current].collected = 0;
+		for (unsigned int age = 1; age < BUFFERS; age++)
+			collect(frames[(current + age) % BUFFERS], false, consume);
+	}
+	// ------------------------------------------------------------------------
+	void release()
+	{
+		if (!initialized)
+			return;
+		for (Frame& frame : frames)
+		{
+			glDeleteQueries(MAX_QUERIES, frame.queries);
+			frame.count = 0;
+			frame.collected = 0;
+		}
+		initialized = false;
+	}
+
+private:
+	struct Frame
+	{
+		GLuint queries[MAX_QUERIES] = {};
+		const char* names[MAX_QUERIES] = {};
+		std::uint64_t starts[MAX_QUERIES] = {};
+		unsigned int count = 0;
+		// results already handed out; queries complete in issue order
+		unsigned int collected = 0;
+	};
+
+	template <typename Consumer>
+	void collect(Frame& frame, bool wait, Consumer& consume)
+	{
+		for (; frame.collected < frame.count; frame.collected++)
+		{
+			GLuint query = frame.queries[frame.collected];
+			if (!wait)
+			{
+				GLint available = 0;
+				glGetQueryObjectiv(query, GL_QUERY_RESULT_AVAILABLE, &available);
+				if (!available)
+					return;
+			}
+			GLuint64 elapsed = 0;
+			glGetQueryObjectui64v(query, GL_QUERY_RESULT, &elapsed);
+			consume(ProfileEvent{ frame.names[frame.collected], frame.starts[frame.collected], elapsed, 0, true });
+		}
+	}
+
+	Frame frames[BUFFERS];
+	unsigned int current = 0;
+	bool active = false;
+	bool initialized = false;
+};
+
+class Profiler
+{
+public:
+	// samples kept per scope for the rolling percentiles
+	static const size_t WINDOW = 240;
+	// cap on events kept for the trace, about a minute of frames
+	static const size_t MAX_TRACE_EVENTS = 1 << 20;
+
+	GpuTimer gpu;
+	// record events for writeChromeTrace; off by default to keep memory flat
+	bool capture = false;
+
+	// ------------------------------------------------------------------------
+	std::uint64_t now() const
+	{
+		return static_cast<std::uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+			std::chrono::steady_clock::now() - epoch).count());
+	}
+	// the calling thread's ring; registration locks once per thread
+	// ------------------------------------------------------------------------
+	ProfileRing& ring()
+	{
+		thread_local ProfileRing* local = nullptr;
+		if (!local)
+		{
+			std::lock_guard<std::mutex> lock(ringsMutex);
+			rings.emplace_back(new ProfileRing(static_cast<std::uint32_t>(rings.size()) + 1));
+			local = rings.back().get();
+		}
+		return *local;
+	}
+	// drains every thread's ring and the GPU results into the stats and the trace
+	// ------------------------------------------------------------------------
+	void endFrame()
+	{
+		auto consume = [this](const ProfileEvent& event) { record(event); };
+		gpu.endFrame(consume);
+		std::lock_guard<std::mutex> lock(ringsMutex);
+		for (std::unique_ptr<ProfileRing>& threadRing : rings)
+			threadRing->drain(consume);
+	}
+	// rolling percentiles over the last WINDOW samples of each scope
+	// ------------------------------------------------------------------------
+	void printSummary(std::ostream& out) const
+	{
+		char line[160];
+		std::snprintf(line, sizeof(line), "%-24s %4s %10s %10s %10s\n", "scope", "", "p50 ms", "p95 ms", "p99 ms");
+		out << line;
+		std::vector<double> sorted;
+		for (const auto& entry : stats)
+		{
+			const ScopeStats& scope = entry.second;
+			sorted.assign(scope.samples.begin(), scope.samples.end());
+			std::sort(sorted.begin(), sorted.end());
+			std::snprintf(line, sizeof(line), "%-24s %4s %10.3f %10.3f %10.3f\n", entry.first.second, entry.first.first ? "gpu" : "cpu",
+				percentile(sorted, 50.0), percentile(sorted, 95.0), percentile(sorted, 99.0));
+			out << line;
+		}
+		std::uint32_t dropped = 0;
+		std::lock_guard<std::mutex> lock(ringsMutex);
+		for (const std::unique_ptr<ProfileRing>& threadRing : rings)
+			dropped += threadRing->dropped.load(std::memory_order_relaxed);
+		if (dropped)
+			out << "dropped events: " << dropped << std::endl;
+	}
+	// Chrome trace event format; open in chrome://tracing or Perfetto.
+	// GPU scopes go on their own track, placed at the CPU time they were
+	// issued since GL_TIME_ELAPSED only gives a duration.
+	// ------------------------------------------------------------------------
+	bool writeChromeTrace(const std::string& path) const
+	{
+		std::FILE* file = std::fopen(path.c_str(), "w");
+		if (!file)
+		{
+			std::cout << "Failed to write trace: " << path << std::endl;
+			return false;
+		}
+		std::fputs("{\"traceEvents\":[\n", file);
+		std::fputs("{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":0,\"tid\":0,\"args\":{\"name\":\"GPU\"}}", file);
+		for (const ProfileEvent& event : trace)
+		{
+			std::fprintf(file, ",\n{\"name\":\"%s\",\"cat\":\"%s\",\"ph\":\"X\",\"pid\":0,\"tid\":%u,\"ts\":%.3f,\"dur\":%.3f}",
+				event.name, event.gpu ? "gpu" : "cpu", event.thread, event.start / 1000.0, event.duration / 1000.0);
+		}
+		std::fputs("\n]}\n", file);
+		std::fclose(file);
+		return true;
+	}
+
+private:
+	struct ScopeStats
+	{
+		std::vector<double> samples;
+		size_t next = 0;
+	};
+
+	const std::chrono::steady_clock::time_point epoch = std::chrono::steady_clock::now();
+	mutable std::mutex ringsMutex;
+	std::vector<std::unique_ptr<ProfileRing>> rings;
+	// keyed by (gpu, name); names are literals so pointers identify scopes
+	std::map<std::pair<bool, const char*>, ScopeStats> stats;
+	std::vector<ProfileEvent> trace;
+
+	void record(const ProfileEvent& event)
+	{
+		ScopeStats& scope = stats[std::make_pair(event.gpu, event.name)];
+		double milliseconds = event.duration / 1000000.0;
+		if (scope.samples.size() < WINDOW)
+			scope.samples.push_back(milliseconds);
+		else
+			scope.samples[scope.next] = milliseconds;
+		scope.next = (scope.next + 1) % WINDOW;
+		if (capture && trace.size() < MAX_TRACE_EVENTS)
+			trace.push_back(event);
+	}
+	// nearest-rank percentile of sorted samples
+	static double percentile(const std::vector<double>& sorted, double p)
+	{
+		if (sorted.empty())
+			return 0.0;
+		size_t rank = static_cast<size_t>(std::ceil(p / 100.0 * sorted.size()));
+		return sorted[std::min(sorted.size() - 1, rank > 0 ? rank - 1 : 0)];
+	}
+};
+
+// ------------------------------------------------------------------------
+inline Profiler& profiler()
+{
+	static Profiler instance;
+	return instance;
+}
+
+// ------------------------------------------------------------------------
+class CpuScope
+{
+public:
+	explicit CpuScope(const char* scopeName) : name(scopeName), start(profiler().now())
+	{
+	}
+	~CpuScope()
+	{
+		ProfileRing& ring = profiler().ring();
+		ring.push(ProfileEvent{ name, start, profiler().now() - start, ring.thread, false });
+	}
+
+private:
+	const char* name;
+	std::uint64_t start;
+};
+
+// GPU scopes are for the thread that owns the GL context
+// ------------------------------------------------------------------------
+class GpuScope
+{
+public:
+	explicit GpuScope(const char* scopeName) : cpu(scopeName)
+	{
+		timing = profiler().gpu.begin(scopeName, profiler().now());
+	}
+	~GpuScope()
+	{
+		if (timing)
+			profiler().gpu.end();
+	}
+
+private:
+	CpuScope cpu;
+	bool timing;
+};
+
+#define PROFILE_CONCAT_INNER(a, b) a##b
+#define PROFILE_CONCAT(a, b) PROFILE_CONCAT_INNER(a, b)
+#define PROFILE_SCOPE(name) CpuScope PROFILE_CONCAT(profileScope, __LINE__)(name)
+#define PROFILE_GPU_SCOPE(name) GpuScope PROFILE_CONCAT(profileScope, __LINE__)(name)
+#define PROFILE_FRAME() profiler().endFrame()
+
+#else
+
+#define PROFILE_SCOPE(name) ((void)0)
+#define PROFILE_GPU_SCOPE(name) ((void)0)
+#define PROFILE_FRAME() ((void)0)
+
+#endif
+#endif
@@ -0,0 +1,317 @@
+#ifndef RENDER_QUEUE_H
+#define RENDER_QUEUE_H
+
+#include <glad/glad.h>
+#include <glm/glm.hpp>
+
+#include <algorithm>
+#include <cstdint>
+#include <functional>
+#include <utility>
+#include <vector>
+
+#include "glstate.h"
+#include "shaderinit.h"
+
+// passes in submission order. The skybox goes after all opaque geometry so
+// only pixels that survived the depth test pay for it; blended geometry
+// still has to come after it.
+enum RenderPass
+{
+	PASS_OPAQUE = 0,
+	PASS_SKYBOX = 1,
+	PASS_TRANSPARENT = 2,
+};
+
+// the pipeline state shared by every draw that uses it. apply() runs once
+// each time the queue switches to this material, for uniforms that are
+// per material rather than per draw.
+// ------------------------------------------------------------------------
+struct Material
+{
+	static const unsigned int MAX_TEXTURES = 2;
+
+	Shader* shader = nullptr;
+	GLenum textureTarget = GL_TEXTURE_2D;
+	GLuint textures[MAX_TEXTURES] = {};
+	GLenum depthFunc = GL_LESS;
+	Uniform<glm::mat4> model;
+	std::function<void()> apply;
+};
+
+// a draw range inside a VAO; indexed ranges start at a byte offset in the EBO.
+// Indirect ranges are count commands at byte offset first in the bound
+// GL_DRAW_INDIRECT_BUFFER (see IndirectDrawBuilder).
+// ------------------------------------------------------------------------
+struct MeshRange
+{
+	GLuint VAO = 0;
+	GLenum mode = GL_TRIANGLES;
+	GLsizei count = 0;
+	GLsizeiptr first = 0;
+	bool indexed = true;
+	bool indirect = false;
+	GLsizei instanceCount = 1;
+};
+
+// the model matrix is not copied: the queue keeps the pointer (identity
+// when null), so the matrix has to stay put until execute()
+// ------------------------------------------------------------------------
+struct DrawPacket
+{
+	MeshRange mesh;
+	unsigned int material = 0;
+	RenderPass pass = PASS_OPAQUE;
+	const glm::mat4* transform = nullptr;
+};
+
+// collects draw packets for a frame, orders them by pass and then by a
+// 32-bit sort key, and submits them with as few state changes as the order
+// allows. Each pass keeps its own keys, so the pass never costs a sort pass.
+//
+// the material field is the material's rank in (program, index) order, so
+// draws still group by program first, but the field is only as wide as the
+// material count needs. Key layout, most significant first:
+//   opaque/skybox:  material rank | depth:16 (front to back)
+//   transparent:    depth:16 (back to front) | material rank
+class RenderQueue
+{
+public:
+	std::vector<Material> materials;
+
+	// ------------------------------------------------------------------------
+	unsigned int addMaterial(const Material& material)
+	{
+		materials.push_back(material);
+		return static_cast<unsigned int>(materials.size() - 1);
+	}
+	// starts a frame; depth keys are measured along the camera's view axis
+	// ------------------------------------------------------------------------
+	void begin(const glm::mat4& view, float nearPlane, float farPlane)
+	{
+		packets.clear();
+		for (PassKeys& pass : passKeys)
+		{
+			pass.keys.clear();
+			pass.varyingBits = 0;
+		}
+		viewDepthRow = glm::vec4(view[0][2], view[1][2], view[2][2], view[3][2]);
+		depthNear = nearPlane;
+		depthScale = 1.0f / (farPlane - nearPlane);
+		// rank every material by program, looked up per packet
+		size_t materialCount = materials.size();
+		materialOrder.resize(materialCount);
+		for (size_t i = 0; i < materialCount; i++)
+			materialOrder[i] = static_cast<std::uint32_t>(i);
+		std::stable_sort(materialOrder.begin(), materialOrder.end(), [this](std::uint32_t a, std::uint32_t b) {
+			return program(materials[a]) < program(materials[b]);
+		});
+		materialKeys.resize(materialCount);
+		for (size_t rank = 0; rank < materialCount; rank++)
+			materialKeys[materialOrder[rank]] = static_cast<std::uint32_t>(rank);
+		materialBits = 0;
+		while (materialBits < MATERIAL_BITS && (size_t(1) << materialBits) < materialCount)
+			materialBits++;
+	}
+	// ------------------------------------------------------------------------
+	void submit(const DrawPacket& packet)
+	{
+		PassKeys& pass = passKeys[packet.pass];
+		std::uint32_t key = makeKey(packet);
+		if (pass.keys.empty())
+			pass.firstKey = key;
+		pass.varyingBits |= key ^ pass.firstKey;
+		pass.keys.push_back(SortEntry{ key, static_cast<std::uint32_t>(packets.size()) });
+		packets.push_back(packet);
+	}
+	// ------------------------------------------------------------------------
+	size_t size() const
+	{
+		return packets.size();
+	}
+	// the i-th packet in the current order, its sort key and its submission
+	// index
+	// ------------------------------------------------------------------------
+	const DrawPacket& packet(size_t i) const
+	{
+		return packets[entry(i).packet];
+	}
+	std::uint32_t sortKey(size_t i) const
+	{
+		return entry(i).key;
+	}
+	size_t packetIndex(size_t i) const
+	{
+		return entry(i).packet;
+	}
+	// LSD radix sort over each pass's keys, 11 bits per pass. A pass only
+	// starts at a bit where some keys differ, so depth bits every key shares
+	// cost nothing; a frame with up to 64 materials takes two passes.
+	// ------------------------------------------------------------------------
+	void sort()
+	{
+		for (PassKeys& pass : passKeys)
+			sort(pass);
+	}
+	// submits every packet in pass and key order
+	// ------------------------------------------------------------------------
+	void execute()
+	{
+		for (const PassKeys& pass : passKeys)
+			execute(pass.keys);
+	}
+	// submits only the packets of one pass
+	// ------------------------------------------------------------------------
+	void execute(RenderPass pass)
+	{
+		execute(passKeys[pass].keys);
+	}
+
+private:
+	static const unsigned int PASS_COUNT = 3;
+	static const unsigned int KEY_BITS = 32;
+	static const unsigned int DEPTH_BITS = 16;
+	static const unsigned int MATERIAL_BITS = KEY_BITS - DEPTH_BITS;
+	static const unsigned int DIGIT_BITS = 11;
+	static const unsigned int DIGIT_MASK = (1u << DIGIT_BITS) - 1;
+	static const unsigned int DIGITS = (KEY_BITS + DIGIT_BITS - 1) / DIGIT_BITS;
+
+	struct SortEntry
+	{
+		std::uint32_t key;
+		std::uint32_t packet;
+	};
+
+	struct PassKeys
+	{
+		std::vector<SortEntry> keys;
+		std::uint32_t firstKey = 0;
+		std::uint32_t varyingBits = 0;
+	};
+
+	std::vector<DrawPacket> packets;
+	PassKeys passKeys[PASS_COUNT];
+	std::vector<SortEntry> scratch;
+	std::vector<std::uint32_t> histograms;
+	std::vector<std::uint32_t> materialOrder;
+	std::vector<std::uint32_t> materialKeys;
+	unsigned int materialBits = 0;
+	glm::vec4 viewDepthRow = glm::vec4(0.0f, 0.0f, -1.0f, 0.0f);
+	float depthNear = 0.1f;
+	float depthScale = 0.01f;
+
+	const SortEntry& entry(size_t i) const
+	{
+		unsigned int pass = 0;
+		while (i >= passKeys[pass].keys.size())
+			i -= passKeys[pass++].keys.size();
+		return passKeys[pass].keys[i];
+	}
+
+	void sort(PassKeys& pass)
+	{
+		unsigned int shifts[DIGITS];
+		unsigned int digits = 0;
+		for (unsigned int bit = 0; bit < KEY_BITS; bit++)
+		{
+			if ((pass.varyingBits >> bit) & 1)
+			{
+				shifts[digits++] = bit;
+				bit += DIGIT_BITS - 1;
+			}
+		}
+		if (digits == 0)
+			return;
+
+		size_t count = pass.keys.size();
+		scratch.resize(count);
+		SortEntry* src = pass.keys.data();
+		SortEntry* dst = scratch.data();
+
+		histograms.assign(digits << DIGIT_BITS, 0);
+		std::uint32_t* counts = histograms.data();
+		for (size_t i = 0; i < count; i++)
+		{
+			std::uint32_t key = src[i].key;
+			for (unsigned int digit = 0; digit < digits; digit++)
+				counts[(digit << DIGIT_BITS) + ((key >> shifts[digit]) & DIGIT_MASK)]++;
+		}
+
+		for (unsigned int digit = 0; digit < digits; digit++)
+		{
+			std::uint32_t* histogram = counts + (digit << DIGIT_BITS);
+			std::uint32_t offset = 0;
+			for (unsigned int bucket = 0; bucket <= DIGIT_MASK; bucket++)
+			{
+				std::uint32_t bucketSize = histogram[bucket];
+				histogram[bucket] = offset;
+				offset += bucketSize;
+			}
+			const unsigned int shift = shifts[digit];
+			for (size_t i = 0; i < count; i++)
+			{
+				SortEntry sortEntry = src[i];
+				dst[histogram[(sortEntry.key >> shift) & DIGIT_MASK]++] = sortEntry;
+			}
+			std::swap(src, dst);
+		}
+
+		if (src != pass.keys.data())
+			pass.keys.swap(scratch);
+	}
+
+	static GLuint program(const Material& material)
+	{
+		return material.shader ? material.shader->ID : 0;
+	}
+
+	void execute(const std::vector<SortEntry>& keys)
+	{
+		unsigned int currentMaterial = ~0u;
+		for (const SortEntry& sortEntry : keys)
+		{
+			const DrawPacket& packet = packets[sortEntry.packet];
+			const Material& material = materials[packet.material];
+			if (packet.material != currentMaterial)
+			{
+				currentMaterial = packet.material;
+				material.shader->use();
+				for (unsigned int unit = 0; unit < Material::MAX_TEXTURES; unit++)
+				{
+					if (material.textures[unit])
+						glState().bindTexture(unit, material.textureTarget, material.textures[unit]);
+				}
+				glState().setDepthFunc(material.depthFunc);
+				if (material.apply)
+					material.apply();
+			}
+			if (material.model.valid())
+				material.shader->set(material.model, packet.transform ? *packet.transform : glm::mat4(1.0f));
+
+			const MeshRange& mesh = packet.mesh;
+			glState().bindVertexArray(mesh.VAO);
+			if (mesh.indirect)
+				glMultiDrawElementsIndirect(mesh.mode, GL_UNSIGNED_INT, (void*)mesh.first, mesh.count, 0);
+			else if (mesh.indexed)
+				glDrawElementsInstanced(mesh.mode, mesh.count, GL_UNSIGNED_INT, (void*)mesh.first, mesh.instanceCount);
+			else
+				glDrawArraysInstanced(mesh.mode, (GLint)mesh.first, mesh.count, mesh.instanceCount);
+		}
+	}
+
+	std::uint32_t makeKey(const DrawPacket& packet) const
+	{
+		// distance in front of the camera, mapped from [near, far] to 16 bits
+		const std::uint32_t maxDepth = (1u << DEPTH_BITS) - 1;
+		float viewZ = packet.transform ? -glm::dot(viewDepthRow, (*packet.transform)[3]) : -viewDepthRow.w;
+		float normalized = glm::clamp((viewZ - depthNear) * depthScale, 0.0f, 1.0f);
+		std::uint32_t depth = static_cast<std::uint32_t>(normalized * static_cast<float>(maxDepth));
+
+		std::uint32_t material = materialKeys[packet.material];
+
+		if (packet.pass == PASS_TRANSPARENT)
+			return ((maxDepth - depth) << materialBits) | material;
+		return (material << DEPTH_BITS) | depth;
+	}
+};
+#endif
@@ -2,23 +2,58 @@
 out vec4 FragColor;
 
 in vec2 TexCoord;
-uniform sampler2D texture1;
-uniform sampler2D texture2;
-uniform vec3 blendColor;
+flat in uint material;
+flat in int instanceApplyBlend;
+flat in vec3 instanceBlendColor;
+flat in uint instanceTexture;
+flat in uint instanceBlendTexture;
+// every material image, see TextureArrayBuilder in texturearray.h
+uniform sampler2DArray materialTextures;
+uniform vec3 planeColor;
 uniform float blendFactor;
-uniform int applyBlend; 
-uniform int isPlane; 
+
+// where each image sits in materialTextures, see TextureRegion
+struct TextureRegion
+{
+    vec4 rect;
+    uint layer;
+    float minLevel;
+    float maxLevel;
+};
+layout (std430, binding = 2) readonly buffer TextureRegions
+{
+    TextureRegion regions[];
+};
+
+// must match SceneMaterial in OpenGLTemplate.cpp
+const uint MATERIAL_PLANE = 0u;
+
+// the level of detail is worked out as texture() would, then kept to the
+// levels the region has: from its preview, if that is all that is in yet,
+// down to the last its padding covers; uvDx, uvDy are the derivatives of uv
+vec4 sampleRegion(uint index, vec2 uv, vec2 uvDx, vec2 uvDy)
+{
+    TextureRegion region = regions[index];
+    vec2 texels = region.rect.zw * vec2(textureSize(materialTextures, 0).xy);
+    vec2 dx = uvDx * texels;
+    vec2 dy = uvDy * texels;
+    float lod = 0.5 * log2(max(dot(dx, dx), dot(dy, dy)));
+    return textureLod(materialTextures, vec3(region.rect.xy + uv * region.rect.zw, float(region.layer)), clamp(lod, region.minLevel, region.maxLevel));
+}
 
 void main() {
-    if (isPlane == 1) {
-        FragColor = vec4(blendColor, 1.0); // plane
+    // outside the branches, where derivatives are still defined
+    vec2 uvDx = dFdx(TexCoord);
+    vec2 uvDy = dFdy(TexCoord);
+    if (material == MATERIAL_PLANE) {
+        FragColor = vec4(planeColor, 1.0); // plane
     } else {
-        vec4 texColor = texture(texture1, TexCoord); // Default texture
-        if (applyBlend == 1) {
-            vec4 texColor1 = texture(texture1, TexCoord);
-            vec4 texColor2 = texture(texture2, TexCoord);
+        vec4 texColor = sampleRegion(instanceTexture, TexCoord, uvDx, uvDy); // Default texture
+        if (instanceApplyBlend == 1) {
+            vec4 texColor1 = texColor;
+            vec4 texColor2 = sampleRegion(instanceBlendTexture, TexCoord, uvDx, uvDy);
             vec4 colorBlend = mix(texColor1, texColor2, blendFactor); // two textures
-            texColor = mix(colorBlend, vec4(blendColor, 1.0), blendFactor); //color
+            texColor = mix(colorBlend, vec4(instanceBlendColor, 1.0), blendFactor); //color
         }
         FragColor = texColor;
     }
@@ -1,18 +1,62 @@
 #version 430 core
+#extension GL_ARB_shader_draw_parameters : require
 layout (location = 0) in vec3 aPos;
 layout (location = 1) in vec3 aColor;
 layout (location = 2) in vec2 aTexCoord;
+// per-instance attributes, see CubeInstance in instancedrenderer.h
+layout (location = 3) in mat4 aInstanceModel;
+layout (location = 7) in int aApplyBlend;
+layout (location = 8) in vec3 aBlendColor;
+layout (location = 9) in uint aTexture;
+layout (location = 10) in uint aBlendTexture;
 
 out vec3 ourColor;
 out vec2 TexCoord;
+flat out uint material;
+flat out int instanceApplyBlend;
+flat out vec3 instanceBlendColor;
+flat out uint instanceTexture;
+flat out uint instanceBlendTexture;
 
-uniform mat4 model;
-uniform mat4 view;
-uniform mat4 projection;
+// per-frame constants, see FrameData in framedata.h
+layout (std140, binding = 0) uniform FrameData
+{
+    mat4 view;
+    mat4 projection;
+    mat4 viewProjection;
+    mat4 skyboxView;
+    vec3 cameraPos;
+    float time;
+};
+
+// per-draw data indexed by gl_DrawIDARB, see DrawData in indirectdraw.h
+struct DrawData
+{
+    mat4 model;
+    uint material;
+};
+layout (std430, binding = 1) readonly buffer DrawDataBuffer
+{
+    DrawData draws[];
+};
+
+// must match SceneMaterial in OpenGLTemplate.cpp
+const uint MATERIAL_PLANE = 0u;
+const uint MATERIAL_CUBE = 1u;
 
 void main()
 {
-    gl_Position = projection * view * model * vec4(aPos, 1.0);
+    DrawData draw = draws[gl_DrawIDARB];
+    // only the cubes are instanced; the plane ignores the instance attributes
+    mat4 world = draw.model;
+    if (draw.material == MATERIAL_CUBE)
+        world = world * aInstanceModel;
+    gl_Position = viewProjection * world * vec4(aPos, 1.0);
     ourColor = aColor;
     TexCoord = vec2(aTexCoord.x, aTexCoord.y);
+    material = draw.material;
+    instanceApplyBlend = aApplyBlend;
+    instanceBlendColor = aBlendColor;
+    instanceTexture = aTexture;
+    instanceBlendTexture = aBlendTexture;
 }
\ No newline at end of file
@@ -5,15 +5,120 @@
 #include <glad/glad.h>
 #include <glm/glm.hpp>
 
+#include <cstdint>
+#include <cstring>
 #include <fstream>
 #include <iostream>
 #include <sstream>
 #include <string>
+#include <vector>
+
+#include "glstate.h"
+
+// FNV-1a hash of a uniform name; constexpr so literal names hash at compile time
+// ------------------------------------------------------------------------
+constexpr std::uint32_t uniformHash(const char* name)
+{
+	std::uint32_t hash = 2166136261u;
+	while (*name)
+	{
+		hash = (hash ^ static_cast<std::uint8_t>(*name++)) * 16777619u;
+	}
+	return hash;
+}
+
+// a uniform location resolved once, typed by the value it accepts
+// ------------------------------------------------------------------------
+template<typename T>
+struct Uniform
+{
+	GLint location = -1;
+	bool valid() const { return location != -1; }
+};
+
+// the active uniform types a Uniform<T> can be set on; glUniform1i also
+// sets bools and samplers
+// ------------------------------------------------------------------------
+template<typename T>
+struct UniformType;
+template<>
+struct UniformType<bool>
+{
+	static bool accepts(GLenum type) { return type == GL_BOOL || type == GL_INT; }
+};
+template<>
+struct UniformType<int>
+{
+	static bool accepts(GLenum type)
+	{
+		switch (type)
+		{
+		case GL_FLOAT: case GL_FLOAT_VEC2: case GL_FLOAT_VEC3: case GL_FLOAT_VEC4:
+		case GL_DOUBLE: case GL_DOUBLE_VEC2: case GL_DOUBLE_VEC3: case GL_DOUBLE_VEC4:
+		case GL_INT_VEC2: case GL_INT_VEC3: case GL_INT_VEC4:
+		case GL_UNSIGNED_INT: case GL_UNSIGNED_INT_VEC2: case GL_UNSIGNED_INT_VEC3: case GL_UNSIGNED_INT_VEC4:
+		case GL_BOOL_VEC2: case GL_BOOL_VEC3: case GL_BOOL_VEC4:
+		case GL_FLOAT_MAT2: case GL_FLOAT_MAT3: case GL_FLOAT_MAT4:
+		case GL_FLOAT_MAT2x3: case GL_FLOAT_MAT2x4: case GL_FLOAT_MAT3x2:
+		case GL_FLOAT_MAT3x4: case GL_FLOAT_MAT4x2: case GL_FLOAT_MAT4x3:
+			return false;
+		default:
+			return true; // int, bool, samplers and images
+		}
+	}
+};
+template<>
+struct UniformType<float>
+{
+	static bool accepts(GLenum type) { return type == GL_FLOAT; }
+};
+template<>
+struct UniformType<glm::vec2>
+{
+	static bool accepts(GLenum type) { return type == GL_FLOAT_VEC2; }
+};
+template<>
+struct UniformType<glm::vec3>
+{
+	static bool accepts(GLenum type) { return type == GL_FLOAT_VEC3; }
+};
+template<>
+struct UniformType<glm::vec4>
+{
+	static bool accepts(GLenum type) { return type == GL_FLOAT_VEC4; }
+};
+template<>
+struct UniformType<glm::mat2>
+{
+	static bool accepts(GLenum type) { return type == GL_FLOAT_MAT2; }
+};
+template<>
+struct UniformType<glm::mat3>
+{
+	static bool accepts(GLenum type) { return type == GL_FLOAT_MAT3; }
+};
+template<>
+struct UniformType<glm::mat4>
+{
+	static bool accepts(GLenum type) { return type == GL_FLOAT_MAT4; }
+};
 
 class Shader
 {
 public:
 	unsigned int ID;
+	// active uniforms, listed once after link
+	struct UniformInfo
+	{
+		std::uint32_t hash;
+		GLint location;
+		GLenum type;
+		GLint size;
+		std::string name;
+	};
+	std::vector<UniformInfo> uniforms;
+	// two active uniforms share a name hash; names are then compared instead
+	bool hashCollision = false;
 	// constructor generates the shader on the fly
 	// ------------------------------------------------------------------------
 	Shader(const char* vertexPath, const char* fragmentPath, const char* geometryPath = nullptr)
@@ -96,73 +201,237 @@ public:
 		if (geometryPath != nullptr)
 			glDeleteShader(geometry);
 
+		cacheUniforms();
 	}
 	// activate the shader
 	// ------------------------------------------------------------------------
 	void use()
 	{
-		glUseProgram(ID);
+		glState().useProgram(ID);
+	}
+	// location of an active uniform from the cached table, -1 if the program
+	// does not use it. No driver round trip; hash literals at compile time.
+	// A hash shared by two uniforms resolves to the first; see hashCollision.
+	// Arrays are listed as "name" and "name[0]"; other elements are only
+	// found by name.
+	// ------------------------------------------------------------------------
+	GLint location(std::uint32_t hash) const
+	{
+		for (const UniformInfo& info : uniforms)
+		{
+			if (info.hash == hash)
+				return info.location;
+		}
+		return -1;
+	}
+	GLint location(const char* name) const
+	{
+		GLint element = 0;
+		const UniformInfo* info = find(name, element);
+		if (!info)
+			return -1;
+		// elements past the first are asked for once they are used; the
+		// spec does not promise they follow the first one
+		return element == 0 ? info->location : glGetUniformLocation(ID, name);
 	}
-	// utility uniform functions
+	// resolve a typed handle once, then set it every frame with set(); the
+	// handle stays invalid if T does not match the uniform's type
+	// ------------------------------------------------------------------------
+	template<typename T>
+	Uniform<T> uniform(const char* name) const
+	{
+		Uniform<T> handle;
+		GLint element = 0;
+		const UniformInfo* info = find(name, element);
+		if (info && !UniformType<T>::accepts(info->type))
+		{
+			std::cout << "ERROR::SHADER::UNIFORM_TYPE_MISMATCH: " << name << " is of GL type 0x" << std::hex << info->type
+				<< std::dec << std::endl;
+			return handle;
+		}
+		handle.location = location(name);
+		return handle;
+	}
+	// typed handle setters; these go straight to glUniform*
+	// ------------------------------------------------------------------------
+	void set(Uniform<bool> handle, bool value) const
+	{
+		glUniform1i(handle.location, (int)value);
+	}
+	void set(Uniform<int> handle, int value) const
+	{
+		glUniform1i(handle.location, value);
+	}
+	void set(Uniform<float> handle, float value) const
+	{
+		glUniform1f(handle.location, value);
+	}
+	void set(Uniform<glm::vec2> handle, const glm::vec2& value) const
+	{
+		glUniform2fv(handle.location, 1, &value[0]);
+	}
+	void set(Uniform<glm::vec3> handle, const glm::vec3& value) const
+	{
+		glUniform3fv(handle.location, 1, &value[0]);
+	}
+	void set(Uniform<glm::vec4> handle, const glm::vec4& value) const
+	{
+		glUniform4fv(handle.location, 1, &value[0]);
+	}
+	void set(Uniform<glm::mat2> handle, const glm::mat2& mat) const
+	{
+		glUniformMatrix2fv(handle.location, 1, GL_FALSE, &mat[0][0]);
+	}
+	void set(Uniform<glm::mat3> handle, const glm::mat3& mat) const
+	{
+		glUniformMatrix3fv(handle.location, 1, GL_FALSE, &mat[0][0]);
+	}
+	void set(Uniform<glm::mat4> handle, const glm::mat4& mat) const
+	{
+		glUniformMatrix4fv(handle.location, 1, GL_FALSE, &mat[0][0]);
+	}
+	// utility uniform functions, looked up by name in the cached table
 	// ------------------------------------------------------------------------
 	void setBool(const std::string& name, bool value) const
 	{
-		glUniform1i(glGetUniformLocation(ID, name.c_str()), (int)value);
+		glUniform1i(location(name.c_str()), (int)value);
 	}
 	// ------------------------------------------------------------------------
 	void setInt(const std::string& name, int value) const
 	{
-		glUniform1i(glGetUniformLocation(ID, name.c_str()), value);
+		glUniform1i(location(name.c_str()), value);
 	}
 	// ------------------------------------------------------------------------
 	void setFloat(const std::string& name, float value) const
 	{
-		glUniform1f(glGetUniformLocation(ID, name.c_str()), value);
+		glUniform1f(location(name.c_str()), value);
 	}
 	// ------------------------------------------------------------------------
 	void setVec2(const std::string& name, const glm::vec2& value) const
 	{
-		glUniform2fv(glGetUniformLocation(ID, name.c_str()), 1, &value[0]);
+		glUniform2fv(location(name.c_str()), 1, &value[0]);
 	}
 	void setVec2(const std::string& name, float x, float y) const
 	{
-		glUniform2f(glGetUniformLocation(ID, name.c_str()), x, y);
+		glUniform2f(location(name.c_str()), x, y);
 	}
 	// ------------------------------------------------------------------------
 	void setVec3(const std::string& name, const glm::vec3& value) const
 	{
-		glUniform3fv(glGetUniformLocation(ID, name.c_str()), 1, &value[0]);
+		glUniform3fv(location(name.c_str()), 1, &value[0]);
 	}
 	void setVec3(const std::string& name, float x, float y, float z) const
 	{
-		glUniform3f(glGetUniformLocation(ID, name.c_str()), x, y, z);
+		glUniform3f(location(name.c_str()), x, y, z);
 	}
 	// ------------------------------------------------------------------------
 	void setVec4(const std::string& name, const glm::vec4& value) const
 	{
-		glUniform4fv(glGetUniformLocation(ID, name.c_str()), 1, &value[0]);
+		glUniform4fv(location(name.c_str()), 1, &value[0]);
 	}
 	void setVec4(const std::string& name, float x, float y, float z, float w)
 	{
-		glUniform4f(glGetUniformLocation(ID, name.c_str()), x, y, z, w);
+		glUniform4f(location(name.c_str()), x, y, z, w);
 	}
 	// ------------------------------------------------------------------------
 	void setMat2(const std::string& name, const glm::mat2& mat) const
 	{
-		glUniformMatrix2fv(glGetUniformLocation(ID, name.c_str()), 1, GL_FALSE, &mat[0][0]);
+		glUniformMatrix2fv(location(name.c_str()), 1, GL_FALSE, &mat[0][0]);
 	}
 	// ------------------------------------------------------------------------
 	void setMat3(const std::string& name, const glm::mat3& mat) const
 	{
-		glUniformMatrix3fv(glGetUniformLocation(ID, name.c_str()), 1, GL_FALSE, &mat[0][0]);
+		glUniformMatrix3fv(location(name.c_str()), 1, GL_FALSE, &mat[0][0]);
 	}
 	// ------------------------------------------------------------------------
 	void setMat4(const std::string& name, const glm::mat4& mat) const
 	{
-		glUniformMatrix4fv(glGetUniformLocation(ID, name.c_str()), 1, GL_FALSE, &mat[0][0]);
+		glUniformMatrix4fv(location(name.c_str()), 1, GL_FALSE, &mat[0][0]);
 	}
 
 private:
+	// the table entry of name, or for "name[i]" with i inside the array
+	// the entry of the array with element set to i
+	// ------------------------------------------------------------------------
+	const UniformInfo* find(const char* name, GLint& element) const
+	{
+		element = 0;
+		std::uint32_t hash = uniformHash(name);
+		for (const UniformInfo& info : uniforms)
+		{
+			if (info.hash == hash && (!hashCollision || info.name == name))
+				return &info;
+		}
+		const char* open = std::strrchr(name, '[');
+		size_t length = std::strlen(name);
+		if (!open || open == name || name[length - 1] != ']' || open + 2 == name + length)
+			return nullptr;
+		GLint index = 0;
+		for (const char* digit = open + 1; digit != name + length - 1; digit++)
+		{
+			if (*digit < '0' || *digit > '9' || index > 100000)
+				return nullptr;
+			index = index * 10 + (*digit - '0');
+		}
+		std::string base(name, open);
+		for (const UniformInfo& info : uniforms)
+		{
+			if (info.name == base && index < info.size)
+			{
+				element = index;
+				return &info;
+			}
+		}
+		return nullptr;
+	}
+	// list every active uniform once with GL_ACTIVE_UNIFORMS
+	// ------------------------------------------------------------------------
+	void cacheUniforms()
+	{
+		GLint count = 0;
+		GLint maxLength = 0;
+		glGetProgramiv(ID, GL_ACTIVE_UNIFORMS, &count);
+		glGetProgramiv(ID, GL_ACTIVE_UNIFORM_MAX_LENGTH, &maxLength);
+
+		std::vector<GLchar> nameBuffer(maxLength > 0 ? maxLength : 1);
+		uniforms.clear();
+		uniforms.reserve(count);
+		for (GLint i = 0; i < count; i++)
+		{
+			GLsizei length = 0;
+			UniformInfo info;
+			glGetActiveUniform(ID, (GLuint)i, (GLsizei)nameBuffer.size(), &length, &info.size, &info.type, nameBuffer.data());
+			info.name.assign(nameBuffer.data(), length);
+			info.location = glGetUniformLocation(ID, info.name.c_str());
+			// uniforms inside blocks have no location and are set through the block
+			if (info.location == -1)
+				continue;
+			// arrays, even of one element, are reported as "name[0]"; register
+			// them under the bare name as well
+			if (info.name.size() > 3 && info.name.compare(info.name.size() - 3, 3, "[0]") == 0)
+			{
+				UniformInfo bare = info;
+				bare.name.resize(bare.name.size() - 3);
+				addUniform(bare);
+			}
+			addUniform(info);
+		}
+	}
+	// ------------------------------------------------------------------------
+	void addUniform(UniformInfo info)
+	{
+		info.hash = uniformHash(info.name.c_str());
+		for (const UniformInfo& other : uniforms)
+		{
+			if (other.hash == info.hash)
+			{
+				std::cout << "ERROR::SHADER::UNIFORM_HASH_COLLISION: " << other.name << " and " << info.name
+					<< "; lookups by name fall back to string compares" << std::endl;
+				hashCollision = true;
+			}
+		}
+		uniforms.push_back(info);
+	}
 	// utility function for checking shader compilation/linking errors.
 	// ------------------------------------------------------------------------
 	void checkCompileErrors(GLuint shader, std::string type)
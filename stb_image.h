@@ -264,14 +264,20 @@ RECENT REVISION HISTORY:
 // code.)
 //
 // On x86, SSE2 will automatically be used when available based on a run-time
-// test; if not, the generic C versions are used as a fall-back. On ARM targets,
+// test; if not, the generic C versions are used as a fall-back. On top of
+// that, AVX2 versions of the IDCT (two blocks at a time), the color
+// conversion and the 2x2 chroma upsampler are picked at run time on CPUs
+// that have AVX2; they give bit-identical results to the SSE2 path and the
+// generic C code. PNG unfiltering uses SSE2 as well, and AVX2 for the Up
+// filter. Define STBI_NO_AVX2 to leave the AVX2 code out. On ARM targets,
 // the typical path is to have separate builds for NEON and non-NEON devices
 // (at least this is true for iOS and Android). Therefore, the NEON support is
 // toggled by a build flag: define STBI_NEON to get NEON loops.
 //
 // If for some reason you do not want to use any of SIMD code, or if
 // you have issues compiling it, you can disable it entirely by
-// defining STBI_NO_SIMD.
+// defining STBI_NO_SIMD. stbi_set_reference_decode(1) skips it at run time
+// instead, so the SIMD results can be compared against the generic code.
 //
 // ===========================================================================
 //
@@ -422,6 +428,13 @@ typedef struct
 STBIDEF stbi_uc *stbi_load_from_memory   (stbi_uc           const *buffer, int len   , int *x, int *y, int *channels_in_file, int desired_channels);
 STBIDEF stbi_uc *stbi_load_from_callbacks(stbi_io_callbacks const *clbk  , void *user, int *x, int *y, int *channels_in_file, int desired_channels);
 
+// low-resolution preview of a progressive JPEG, built from the DC
+// coefficients alone: 1/8 the size (rounded up), and the stream is only
+// read up to the end of its DC scans, usually a small part of the file.
+// Fails for anything else, since baseline files store the DC values
+// spread across the whole file.
+STBIDEF stbi_uc *stbi_load_jpeg_preview_from_callbacks(stbi_io_callbacks const *clbk, void *user, int *x, int *y, int *channels_in_file, int desired_channels);
+
 #ifndef STBI_NO_STDIO
 STBIDEF stbi_uc *stbi_load            (char const *filename, int *x, int *y, int *channels_in_file, int desired_channels);
 STBIDEF stbi_uc *stbi_load_from_file  (FILE *f, int *x, int *y, int *channels_in_file, int desired_channels);
@@ -516,6 +529,10 @@ STBIDEF void stbi_convert_iphone_png_to_rgb(int flag_true_if_should_convert);
 // flip the image vertically, so the first pixel in the output array is the bottom left
 STBIDEF void stbi_set_flip_vertically_on_load(int flag_true_if_should_flip);
 
+// decode with the generic C code only, even where SIMD kernels are available;
+// this also makes zlib decode one symbol at a time
+STBIDEF void stbi_set_reference_decode(int flag_true_if_should_use_generic_code);
+
 // as above, but only applies to images loaded on the thread that calls the function
 // this function is only available if your compiler supports thread-local variables;
 // calling it will fail to link if your compiler doesn't
@@ -642,12 +659,14 @@ typedef unsigned short stbi__uint16;
 typedef   signed short stbi__int16;
 typedef unsigned int   stbi__uint32;
 typedef   signed int   stbi__int32;
+typedef unsigned __int64 stbi__uint64;
 #else
 #include <stdint.h>
 typedef uint16_t stbi__uint16;
 typedef int16_t  stbi__int16;
 typedef uint32_t stbi__uint32;
 typedef int32_t  stbi__int32;
+typedef uint64_t stbi__uint64;
 #endif
 
 // should produce compiler error if size is wrong
@@ -749,7 +768,7 @@ static int stbi__cpuid3(void)
 
 #define STBI_SIMD_ALIGN(type, name) __declspec(align(16)) type name
 
-#if !defined(STBI_NO_JPEG) && defined(STBI_SSE2)
+#if (!defined(STBI_NO_JPEG) || !defined(STBI_NO_PNG)) && defined(STBI_SSE2)
 static int stbi__sse2_available(void)
 {
    int info3 = stbi__cpuid3();
@@ -760,7 +779,7 @@ static int stbi__sse2_available(void)
 #else // assume GCC-style if not VC++
 #define STBI_SIMD_ALIGN(type, name) type name __attribute__((aligned(16)))
 
-#if !defined(STBI_NO_JPEG) && defined(STBI_SSE2)
+#if (!defined(STBI_NO_JPEG) || !defined(STBI_NO_PNG)) && defined(STBI_SSE2)
 static int stbi__sse2_available(void)
 {
    // If we're even attempting to compile this on GCC/Clang, that means
@@ -773,6 +792,38 @@ static int stbi__sse2_available(void)
 #endif
 #endif
 
+// AVX2 kernels for the JPEG and PNG decoders, used after a run-time check.
+// GCC and Clang compile just those functions for AVX2 through a target
+// attribute, so the rest of the file needs no -mavx2.
+#if defined(STBI_SSE2) && !defined(STBI_NO_AVX2) && (!defined(STBI_NO_JPEG) || !defined(STBI_NO_PNG)) && \
+   ((defined(_MSC_VER) && _MSC_VER >= 1800) || defined(__clang__) || (defined(__GNUC__) && __GNUC__ >= 5))
+#define STBI_AVX2
+#include <immintrin.h>
+
+#ifdef _MSC_VER
+#define STBI__AVX2_TARGET
+static int stbi__avx2_available(void)
+{
+   int info[4];
+   __cpuid(info, 0);
+   if (info[0] < 7)
+      return 0;
+   // the CPU has AVX and XSAVE, and the OS saves the YMM registers
+   __cpuid(info, 1);
+   if ((info[2] & 0x18000000) != 0x18000000 || (_xgetbv(0) & 6) != 6)
+      return 0;
+   __cpuidex(info, 7, 0);
+   return (info[1] >> 5) & 1;
+}
+#else
+#define STBI__AVX2_TARGET __attribute__((target("avx2")))
+static int stbi__avx2_available(void)
+{
+   return __builtin_cpu_supports("avx2");
+}
+#endif
+#endif
+
 // ARM NEON
 #if defined(STBI_NO_SIMD) && defined(STBI_NEON)
 #undef STBI_NEON
@@ -907,6 +958,7 @@ typedef struct
 #ifndef STBI_NO_JPEG
 static int      stbi__jpeg_test(stbi__context *s);
 static void    *stbi__jpeg_load(stbi__context *s, int *x, int *y, int *comp, int req_comp, stbi__result_info *ri);
+static stbi_uc *stbi__jpeg_load_preview(stbi__context *s, int *x, int *y, int *comp, int req_comp);
 static int      stbi__jpeg_info(stbi__context *s, int *x, int *y, int *comp);
 #endif
 
@@ -1133,6 +1185,13 @@ STBIDEF void stbi_set_flip_vertically_on_load_thread(int flag_true_if_should_fli
                                          : stbi__vertically_flip_on_load_global)
 #endif // STBI_THREAD_LOCAL
 
+static int stbi__reference_decode = 0;
+
+STBIDEF void stbi_set_reference_decode(int flag_true_if_should_use_generic_code)
+{
+   stbi__reference_decode = flag_true_if_should_use_generic_code;
+}
+
 static void *stbi__load_main(stbi__context *s, int *x, int *y, int *comp, int req_comp, stbi__result_info *ri, int bpc)
 {
    memset(ri, 0, sizeof(*ri)); // make sure it's initialized if we add new fields
@@ -1439,6 +1498,24 @@ STBIDEF stbi_uc *stbi_load_from_callbacks(stbi_io_callbacks const *clbk, void *u
    return stbi__load_and_postprocess_8bit(&s,x,y,comp,req_comp);
 }
 
+STBIDEF stbi_uc *stbi_load_jpeg_preview_from_callbacks(stbi_io_callbacks const *clbk, void *user, int *x, int *y, int *comp, int req_comp)
+{
+#ifndef STBI_NO_JPEG
+   stbi__context s;
+   stbi_uc *result;
+   stbi__start_callbacks(&s, (stbi_io_callbacks *) clbk, user);
+   result = stbi__jpeg_load_preview(&s, x, y, comp, req_comp);
+   if (result && stbi__vertically_flip_on_load) {
+      int channels = req_comp ? req_comp : *comp;
+      stbi__vertical_flip(result, *x, *y, channels * sizeof(stbi_uc));
+   }
+   return result;
+#else
+   STBI_NOTUSED(clbk); STBI_NOTUSED(user); STBI_NOTUSED(x); STBI_NOTUSED(y); STBI_NOTUSED(comp); STBI_NOTUSED(req_comp);
+   return stbi__errpuc("unknown image type", "Image not of any known type, or corrupt");
+#endif
+}
+
 #ifndef STBI_NO_GIF
 STBIDEF stbi_uc *stbi_load_gif_from_memory(stbi_uc const *buffer, int len, int **delays, int *x, int *y, int *z, int *comp, int req_comp)
 {
@@ -1981,6 +2058,8 @@ typedef struct
    int            nomore;      // flag if we saw a marker so must stop
 
    int            progressive;
+   int            dc_only;     // preview: stop once every component has its DC scan
+   int            dc_seen;     // bit per component whose first DC scan was read
    int            spec_start;
    int            spec_end;
    int            succ_high;
@@ -1995,6 +2074,8 @@ typedef struct
 
 // kernels
    void (*idct_block_kernel)(stbi_uc *out, int out_stride, short data[64]);
+   // two blocks per call; NULL when there is no such kernel
+   void (*idct_block2_kernel)(stbi_uc *out0, int out_stride0, short data0[64], stbi_uc *out1, int out_stride1, short data1[64]);
    void (*YCbCr_to_RGB_kernel)(stbi_uc *out, const stbi_uc *y, const stbi_uc *pcb, const stbi_uc *pcr, int count, int step);
    stbi_uc *(*resample_row_hv_2_kernel)(stbi_uc *out, stbi_uc *in_near, stbi_uc *in_far, int w, int hs);
 } stbi__jpeg;
@@ -2703,6 +2784,199 @@ static void stbi__idct_simd(stbi_uc *out, int out_stride, short data[64])
 
 #endif // STBI_SSE2
 
+#ifdef STBI_AVX2
+// avx2 integer IDCT of two blocks at once: the SSE2 version with block 0
+// in the low and block 1 in the high 128-bit lane of every register. All
+// the shuffles stay within a lane, so each block gets exactly the SSE2
+// (and so the generic C) result.
+STBI__AVX2_TARGET static void stbi__idct_avx2(stbi_uc *out0, int out_stride0, short data0[64], stbi_uc *out1, int out_stride1, short data1[64])
+{
+   __m256i row0, row1, row2, row3, row4, row5, row6, row7;
+   __m256i tmp;
+
+   // dot product constant: even elems=x, odd elems=y
+   #define dct_const(x,y)  _mm256_setr_epi16((x),(y),(x),(y),(x),(y),(x),(y),(x),(y),(x),(y),(x),(y),(x),(y))
+
+   // out(0) = c0[even]*x + c0[odd]*y   (c0, x, y 16-bit, out 32-bit)
+   // out(1) = c1[even]*x + c1[odd]*y
+   #define dct_rot(out0,out1, x,y,c0,c1) \
+      __m256i c0##lo = _mm256_unpacklo_epi16((x),(y)); \
+      __m256i c0##hi = _mm256_unpackhi_epi16((x),(y)); \
+      __m256i out0##_l = _mm256_madd_epi16(c0##lo, c0); \
+      __m256i out0##_h = _mm256_madd_epi16(c0##hi, c0); \
+      __m256i out1##_l = _mm256_madd_epi16(c0##lo, c1); \
+      __m256i out1##_h = _mm256_madd_epi16(c0##hi, c1)
+
+   // out = in << 12  (in 16-bit, out 32-bit)
+   #define dct_widen(out, in) \
+      __m256i out##_l = _mm256_srai_epi32(_mm256_unpacklo_epi16(_mm256_setzero_si256(), (in)), 4); \
+      __m256i out##_h = _mm256_srai_epi32(_mm256_unpackhi_epi16(_mm256_setzero_si256(), (in)), 4)
+
+   // wide add
+   #define dct_wadd(out, a, b) \
+      __m256i out##_l = _mm256_add_epi32(a##_l, b##_l); \
+      __m256i out##_h = _mm256_add_epi32(a##_h, b##_h)
+
+   // wide sub
+   #define dct_wsub(out, a, b) \
+      __m256i out##_l = _mm256_sub_epi32(a##_l, b##_l); \
+      __m256i out##_h = _mm256_sub_epi32(a##_h, b##_h)
+
+   // butterfly a/b, add bias, then shift by "s" and pack
+   #define dct_bfly32o(out0, out1, a,b,bias,s) \
+      { \
+         __m256i abiased_l = _mm256_add_epi32(a##_l, bias); \
+         __m256i abiased_h = _mm256_add_epi32(a##_h, bias); \
+         dct_wadd(sum, abiased, b); \
+         dct_wsub(dif, abiased, b); \
+         out0 = _mm256_packs_epi32(_mm256_srai_epi32(sum_l, s), _mm256_srai_epi32(sum_h, s)); \
+         out1 = _mm256_packs_epi32(_mm256_srai_epi32(dif_l, s), _mm256_srai_epi32(dif_h, s)); \
+      }
+
+   // 8-bit interleave step (for transposes)
+   #define dct_interleave8(a, b) \
+      tmp = a; \
+      a = _mm256_unpacklo_epi8(a, b); \
+      b = _mm256_unpackhi_epi8(tmp, b)
+
+   // 16-bit interleave step (for transposes)
+   #define dct_interleave16(a, b) \
+      tmp = a; \
+      a = _mm256_unpacklo_epi16(a, b); \
+      b = _mm256_unpackhi_epi16(tmp, b)
+
+   #define dct_pass(bias,shift) \
+      { \
+         /* even part */ \
+         dct_rot(t2e,t3e, row2,row6, rot0_0,rot0_1); \
+         __m256i sum04 = _mm256_add_epi16(row0, row4); \
+         __m256i dif04 = _mm256_sub_epi16(row0, row4); \
+         dct_widen(t0e, sum04); \
+         dct_widen(t1e, dif04); \
+         dct_wadd(x0, t0e, t3e); \
+         dct_wsub(x3, t0e, t3e); \
+         dct_wadd(x1, t1e, t2e); \
+         dct_wsub(x2, t1e, t2e); \
+         /* odd part */ \
+         dct_rot(y0o,y2o, row7,row3, rot2_0,rot2_1); \
+         dct_rot(y1o,y3o, row5,row1, rot3_0,rot3_1); \
+         __m256i sum17 = _mm256_add_epi16(row1, row7); \
+         __m256i sum35 = _mm256_add_epi16(row3, row5); \
+         dct_rot(y4o,y5o, sum17,sum35, rot1_0,rot1_1); \
+         dct_wadd(x4, y0o, y4o); \
+         dct_wadd(x5, y1o, y5o); \
+         dct_wadd(x6, y2o, y5o); \
+         dct_wadd(x7, y3o, y4o); \
+         dct_bfly32o(row0,row7, x0,x7,bias,shift); \
+         dct_bfly32o(row1,row6, x1,x6,bias,shift); \
+         dct_bfly32o(row2,row5, x2,x5,bias,shift); \
+         dct_bfly32o(row3,row4, x3,x4,bias,shift); \
+      }
+
+   // row k of block 0 in the low lane, of block 1 in the high lane
+   #define dct_load(k) \
+      _mm256_inserti128_si256(_mm256_castsi128_si256(_mm_load_si128((const __m128i *) (data0 + (k)*8))), \
+         _mm_load_si128((const __m128i *) (data1 + (k)*8)), 1)
+
+   // low 8 bytes of each lane to the two blocks, moving both on a row
+   #define dct_store(v) \
+      _mm_storel_epi64((__m128i *) out0, _mm256_castsi256_si128(v)); out0 += out_stride0; \
+      _mm_storel_epi64((__m128i *) out1, _mm256_extracti128_si256(v, 1)); out1 += out_stride1
+
+   __m256i rot0_0 = dct_const(stbi__f2f(0.5411961f), stbi__f2f(0.5411961f) + stbi__f2f(-1.847759065f));
+   __m256i rot0_1 = dct_const(stbi__f2f(0.5411961f) + stbi__f2f( 0.765366865f), stbi__f2f(0.5411961f));
+   __m256i rot1_0 = dct_const(stbi__f2f(1.175875602f) + stbi__f2f(-0.899976223f), stbi__f2f(1.175875602f));
+   __m256i rot1_1 = dct_const(stbi__f2f(1.175875602f), stbi__f2f(1.175875602f) + stbi__f2f(-2.562915447f));
+   __m256i rot2_0 = dct_const(stbi__f2f(-1.961570560f) + stbi__f2f( 0.298631336f), stbi__f2f(-1.961570560f));
+   __m256i rot2_1 = dct_const(stbi__f2f(-1.961570560f), stbi__f2f(-1.961570560f) + stbi__f2f( 3.072711026f));
+   __m256i rot3_0 = dct_const(stbi__f2f(-0.390180644f) + stbi__f2f( 2.053119869f), stbi__f2f(-0.390180644f));
+   __m256i rot3_1 = dct_const(stbi__f2f(-0.390180644f), stbi__f2f(-0.390180644f) + stbi__f2f( 1.501321110f));
+
+   // rounding biases in column/row passes, see stbi__idct_block for explanation.
+   __m256i bias_0 = _mm256_set1_epi32(512);
+   __m256i bias_1 = _mm256_set1_epi32(65536 + (128<<17));
+
+   // load
+   row0 = dct_load(0);
+   row1 = dct_load(1);
+   row2 = dct_load(2);
+   row3 = dct_load(3);
+   row4 = dct_load(4);
+   row5 = dct_load(5);
+   row6 = dct_load(6);
+   row7 = dct_load(7);
+
+   // column pass
+   dct_pass(bias_0, 10);
+
+   {
+      // 16bit 8x8 transpose pass 1
+      dct_interleave16(row0, row4);
+      dct_interleave16(row1, row5);
+      dct_interleave16(row2, row6);
+      dct_interleave16(row3, row7);
+
+      // transpose pass 2
+      dct_interleave16(row0, row2);
+      dct_interleave16(row1, row3);
+      dct_interleave16(row4, row6);
+      dct_interleave16(row5, row7);
+
+      // transpose pass 3
+      dct_interleave16(row0, row1);
+      dct_interleave16(row2, row3);
+      dct_interleave16(row4, row5);
+      dct_interleave16(row6, row7);
+   }
+
+   // row pass
+   dct_pass(bias_1, 17);
+
+   {
+      // pack
+      __m256i p0 = _mm256_packus_epi16(row0, row1); // a0a1a2a3...a7b0b1b2b3...b7
+      __m256i p1 = _mm256_packus_epi16(row2, row3);
+      __m256i p2 = _mm256_packus_epi16(row4, row5);
+      __m256i p3 = _mm256_packus_epi16(row6, row7);
+
+      // 8bit 8x8 transpose pass 1
+      dct_interleave8(p0, p2); // a0e0a1e1...
+      dct_interleave8(p1, p3); // c0g0c1g1...
+
+      // transpose pass 2
+      dct_interleave8(p0, p1); // a0c0e0g0...
+      dct_interleave8(p2, p3); // b0d0f0h0...
+
+      // transpose pass 3
+      dct_interleave8(p0, p2); // a0b0c0d0...
+      dct_interleave8(p1, p3); // a4b4c4d4...
+
+      // store
+      dct_store(p0);
+      dct_store(_mm256_shuffle_epi32(p0, 0x4e));
+      dct_store(p2);
+      dct_store(_mm256_shuffle_epi32(p2, 0x4e));
+      dct_store(p1);
+      dct_store(_mm256_shuffle_epi32(p1, 0x4e));
+      dct_store(p3);
+      dct_store(_mm256_shuffle_epi32(p3, 0x4e));
+   }
+
+#undef dct_const
+#undef dct_rot
+#undef dct_widen
+#undef dct_wadd
+#undef dct_wsub
+#undef dct_bfly32o
+#undef dct_interleave8
+#undef dct_interleave16
+#undef dct_pass
+#undef dct_load
+#undef dct_store
+}
+
+#endif // STBI_AVX2
+
 #ifdef STBI_NEON
 
 // NEON integer IDCT. should produce bit-identical
@@ -2945,14 +3219,55 @@ static void stbi__jpeg_reset(stbi__jpeg *j)
    // since we don't even allow 1<<30 pixels
 }
 
+// baseline blocks waiting for the IDCT, so a two-block kernel gets them in
+// pairs. Entropy decoding never reads the IDCT output, so a block can wait
+// for the next one; stbi__idct_batch_flush does the odd one out.
+typedef struct
+{
+   STBI_SIMD_ALIGN(short, data[2][64]);
+   stbi_uc *out[2];
+   int out_stride[2];
+   int count;
+} stbi__idct_batch;
+
+// the coefficients of the next block go here
+static short *stbi__idct_batch_next(stbi__idct_batch *b)
+{
+   return b->data[b->count];
+}
+
+// queues the block just decoded into stbi__idct_batch_next()
+static void stbi__idct_batch_add(stbi__jpeg *z, stbi__idct_batch *b, stbi_uc *out, int out_stride)
+{
+   if (!z->idct_block2_kernel) {
+      z->idct_block_kernel(out, out_stride, b->data[0]);
+      return;
+   }
+   b->out[b->count] = out;
+   b->out_stride[b->count] = out_stride;
+   if (++b->count == 2) {
+      z->idct_block2_kernel(b->out[0], b->out_stride[0], b->data[0], b->out[1], b->out_stride[1], b->data[1]);
+      b->count = 0;
+   }
+}
+
+static int stbi__idct_batch_flush(stbi__jpeg *z, stbi__idct_batch *b)
+{
+   if (b->count)
+      z->idct_block_kernel(b->out[0], b->out_stride[0], b->data[0]);
+   b->count = 0;
+   return 1;
+}
+
 static int stbi__parse_entropy_coded_data(stbi__jpeg *z)
 {
    stbi__jpeg_reset(z);
    if (!z->progressive) {
       if (z->scan_n == 1) {
          int i,j;
-         STBI_SIMD_ALIGN(short, data[64]);
+         stbi__idct_batch batch;
          int n = z->order[0];
+         batch.count = 0;
          // non-interleaved data, we just need to process one block at a time,
          // in trivial scanline order
          // number of blocks to do just depends on how many actual "pixels" this
@@ -2962,22 +3277,23 @@ static int stbi__parse_entropy_coded_data(stbi__jpeg *z)
          for (j=0; j < h; ++j) {
             for (i=0; i < w; ++i) {
                int ha = z->img_comp[n].ha;
-               if (!stbi__jpeg_decode_block(z, data, z->huff_dc+z->img_comp[n].hd, z->huff_ac+ha, z->fast_ac[ha], n, z->dequant[z->img_comp[n].tq])) return 0;
-               z->idct_block_kernel(z->img_comp[n].data+z->img_comp[n].w2*j*8+i*8, z->img_comp[n].w2, data);
+               if (!stbi__jpeg_decode_block(z, stbi__idct_batch_next(&batch), z->huff_dc+z->img_comp[n].hd, z->huff_ac+ha, z->fast_ac[ha], n, z->dequant[z->img_comp[n].tq])) return 0;
+               stbi__idct_batch_add(z, &batch, z->img_comp[n].data+z->img_comp[n].w2*j*8+i*8, z->img_comp[n].w2);
                // every data block is an MCU, so countdown the restart interval
                if (--z->todo <= 0) {
                   if (z->code_bits < 24) stbi__grow_buffer_unsafe(z);
                   // if it's NOT a restart, then just bail, so we get corrupt data
                   // rather than no data
-                  if (!STBI__RESTART(z->marker)) return 1;
+                  if (!STBI__RESTART(z->marker)) return stbi__idct_batch_flush(z, &batch);
                   stbi__jpeg_reset(z);
                }
             }
          }
-         return 1;
+         return stbi__idct_batch_flush(z, &batch);
       } else { // interleaved
          int i,j,k,x,y;
-         STBI_SIMD_ALIGN(short, data[64]);
+         stbi__idct_batch batch;
+         batch.count = 0;
          for (j=0; j < z->img_mcu_y; ++j) {
             for (i=0; i < z->img_mcu_x; ++i) {
                // scan an interleaved mcu... process scan_n components in order
@@ -2990,8 +3306,8 @@ static int stbi__parse_entropy_coded_data(stbi__jpeg *z)
                         int x2 = (i*z->img_comp[n].h + x)*8;
                         int y2 = (j*z->img_comp[n].v + y)*8;
                         int ha = z->img_comp[n].ha;
-                        if (!stbi__jpeg_decode_block(z, data, z->huff_dc+z->img_comp[n].hd, z->huff_ac+ha, z->fast_ac[ha], n, z->dequant[z->img_comp[n].tq])) return 0;
-                        z->idct_block_kernel(z->img_comp[n].data+z->img_comp[n].w2*y2+x2, z->img_comp[n].w2, data);
+                        if (!stbi__jpeg_decode_block(z, stbi__idct_batch_next(&batch), z->huff_dc+z->img_comp[n].hd, z->huff_ac+ha, z->fast_ac[ha], n, z->dequant[z->img_comp[n].tq])) return 0;
+                        stbi__idct_batch_add(z, &batch, z->img_comp[n].data+z->img_comp[n].w2*y2+x2, z->img_comp[n].w2);
                      }
                   }
                }
@@ -2999,12 +3315,12 @@ static int stbi__parse_entropy_coded_data(stbi__jpeg *z)
                // so now count down the restart interval
                if (--z->todo <= 0) {
                   if (z->code_bits < 24) stbi__grow_buffer_unsafe(z);
-                  if (!STBI__RESTART(z->marker)) return 1;
+                  if (!STBI__RESTART(z->marker)) return stbi__idct_batch_flush(z, &batch);
                   stbi__jpeg_reset(z);
                }
             }
          }
-         return 1;
+         return stbi__idct_batch_flush(z, &batch);
       }
    } else {
       if (z->scan_n == 1) {
@@ -3085,7 +3401,18 @@ static void stbi__jpeg_finish(stbi__jpeg *z)
          int w = (z->img_comp[n].x+7) >> 3;
          int h = (z->img_comp[n].y+7) >> 3;
          for (j=0; j < h; ++j) {
-            for (i=0; i < w; ++i) {
+            i = 0;
+            // side by side blocks in pairs when there is a two-block kernel
+            if (z->idct_block2_kernel) {
+               for (; i+1 < w; i += 2) {
+                  short *data = z->img_comp[n].coeff + 64 * (i + j * z->img_comp[n].coeff_w);
+                  stbi_uc *out = z->img_comp[n].data+z->img_comp[n].w2*j*8+i*8;
+                  stbi__jpeg_dequantize(data, z->dequant[z->img_comp[n].tq]);
+                  stbi__jpeg_dequantize(data + 64, z->dequant[z->img_comp[n].tq]);
+                  z->idct_block2_kernel(out, z->img_comp[n].w2, data, out + 8, z->img_comp[n].w2, data + 64);
+               }
+            }
+            for (; i < w; ++i) {
                short *data = z->img_comp[n].coeff + 64 * (i + j * z->img_comp[n].coeff_w);
                stbi__jpeg_dequantize(data, z->dequant[z->img_comp[n].tq]);
                z->idct_block_kernel(z->img_comp[n].data+z->img_comp[n].w2*j*8+i*8, z->img_comp[n].w2, data);
@@ -3095,6 +3422,33 @@ static void stbi__jpeg_finish(stbi__jpeg *z)
    }
 }
 
+// turns the DC coefficients of a progressive image into a 1/8 scale
+// image: one texel per block, the block's average. The sizes are scaled to
+// match, so the upsampling and color conversion run as usual.
+static void stbi__jpeg_finish_dc(stbi__jpeg *z)
+{
+   int i,j,n;
+   for (n=0; n < z->s->img_n; ++n) {
+      int w = (z->img_comp[n].x+7) >> 3;
+      int h = (z->img_comp[n].y+7) >> 3;
+      int w2 = z->img_comp[n].w2 >> 3;
+      int q = z->dequant[z->img_comp[n].tq][0];
+      for (j=0; j < h; ++j) {
+         for (i=0; i < w; ++i) {
+            short *data = z->img_comp[n].coeff + 64 * (i + j * z->img_comp[n].coeff_w);
+            // a block of just DC comes out of the idct as DC/8
+            z->img_comp[n].data[j*w2 + i] = stbi__clamp(((data[0] * q + 4) >> 3) + 128);
+         }
+      }
+      z->img_comp[n].x = w;
+      z->img_comp[n].y = h;
+      z->img_comp[n].w2 = w2;
+      z->img_comp[n].h2 >>= 3;
+   }
+   z->s->img_x = (z->s->img_x + 7) >> 3;
+   z->s->img_y = (z->s->img_y + 7) >> 3;
+}
+
 static int stbi__process_marker(stbi__jpeg *z, int m)
 {
    int L;
@@ -3416,12 +3770,26 @@ static int stbi__decode_jpeg_image(stbi__jpeg *j)
       j->img_comp[m].raw_coeff = NULL;
    }
    j->restart_interval = 0;
+   j->dc_seen = 0;
    if (!stbi__decode_jpeg_header(j, STBI__SCAN_load)) return 0;
+   if (j->dc_only && !j->progressive) return stbi__err("not progressive", "Preview needs a progressive JPEG");
    m = stbi__get_marker(j);
    while (!stbi__EOI(m)) {
       if (stbi__SOS(m)) {
          if (!stbi__process_scan_header(j)) return 0;
          if (!stbi__parse_entropy_coded_data(j)) return 0;
+         if (j->dc_only) {
+            // DC scans come before any AC scan of the same component
+            if (j->spec_start == 0 && j->succ_high == 0) {
+               int i;
+               for (i=0; i < j->scan_n; ++i)
+                  j->dc_seen |= 1 << j->order[i];
+            }
+            if (j->dc_seen == (1 << j->s->img_n) - 1) {
+               stbi__jpeg_finish_dc(j);
+               return 1;
+            }
+         }
          if (j->marker == STBI__MARKER_none ) {
          j->marker = stbi__skip_jpeg_junk_at_end(j);
             // if we reach eof without hitting a marker, stbi__get_marker() below will fail and we'll eventually return 0
@@ -3440,6 +3808,8 @@ static int stbi__decode_jpeg_image(stbi__jpeg *j)
          m = stbi__get_marker(j);
       }
    }
+   if (j->dc_only)
+      return stbi__err("no DC scan", "Corrupt JPEG");
    if (j->progressive)
       stbi__jpeg_finish(j);
    return 1;
@@ -3642,6 +4012,86 @@ static stbi_uc *stbi__resample_row_hv_2_simd(stbi_uc *out, stbi_uc *in_near, stb
 }
 #endif
 
+#ifdef STBI_AVX2
+// stbi__resample_row_hv_2_simd 16 pixels at a time
+STBI__AVX2_TARGET static stbi_uc *stbi__resample_row_hv_2_avx2(stbi_uc *out, stbi_uc *in_near, stbi_uc *in_far, int w, int hs)
+{
+   // need to generate 2x2 samples for every one in input
+   int i=0,t0,t1;
+
+   if (w == 1) {
+      out[0] = out[1] = stbi__div4(3*in_near[0] + in_far[0] + 2);
+      return out;
+   }
+
+   t1 = 3*in_near[0] + in_far[0];
+   // process groups of 16 pixels for as long as we can.
+   // note we can't handle the last pixel in a row in this loop
+   // because we need to handle the filter boundary conditions.
+   for (; i < ((w-1) & ~15); i += 16) {
+      // load and perform the vertical filtering pass
+      // this uses 3*x + y = 4*x + (y - x)
+      __m256i farw  = _mm256_cvtepu8_epi16(_mm_loadu_si128((__m128i *) (in_far + i)));
+      __m256i nearw = _mm256_cvtepu8_epi16(_mm_loadu_si128((__m128i *) (in_near + i)));
+      __m256i diff  = _mm256_sub_epi16(farw, nearw);
+      __m256i nears = _mm256_slli_epi16(nearw, 2);
+      __m256i curr  = _mm256_add_epi16(nears, diff); // current row
+
+      // "prev" is current row shifted right by 1 pixel with the previous
+      // pixel value (from t1) inserted, "next" is current row shifted left by
+      // 1 pixel with the first pixel of the next block of 16 added in. The
+      // shifts cross the 128-bit lanes, hence the lane swaps.
+      __m256i prv0 = _mm256_alignr_epi8(curr, _mm256_permute2x128_si256(curr, curr, 0x08), 14);
+      __m256i nxt0 = _mm256_alignr_epi8(_mm256_permute2x128_si256(curr, curr, 0x81), curr, 2);
+      __m256i prev = _mm256_insert_epi16(prv0, t1, 0);
+      __m256i next = _mm256_insert_epi16(nxt0, 3*in_near[i+16] + in_far[i+16], 15);
+
+      // horizontal filter, polyphase implementation since it's convenient:
+      // even pixels = 3*cur + prev = cur*4 + (prev - cur)
+      // odd  pixels = 3*cur + next = cur*4 + (next - cur)
+      // note the shared term.
+      __m256i bias  = _mm256_set1_epi16(8);
+      __m256i curs = _mm256_slli_epi16(curr, 2);
+      __m256i prvd = _mm256_sub_epi16(prev, curr);
+      __m256i nxtd = _mm256_sub_epi16(next, curr);
+      __m256i curb = _mm256_add_epi16(curs, bias);
+      __m256i even = _mm256_add_epi16(prvd, curb);
+      __m256i odd  = _mm256_add_epi16(nxtd, curb);
+
+      // interleave even and odd pixels, then undo scaling. Per lane this
+      // gives pixels 0-3 and 4-7 of that lane's 8, so the pack below comes
+      // out in order.
+      __m256i int0 = _mm256_unpacklo_epi16(even, odd);
+      __m256i int1 = _mm256_unpackhi_epi16(even, odd);
+      __m256i de0  = _mm256_srli_epi16(int0, 4);
+      __m256i de1  = _mm256_srli_epi16(int1, 4);
+
+      // pack and write output
+      __m256i outv = _mm256_packus_epi16(de0, de1);
+      _mm256_storeu_si256((__m256i *) (out + i*2), outv);
+
+      // "previous" value for next iter
+      t1 = 3*in_near[i+15] + in_far[i+15];
+   }
+
+   t0 = t1;
+   t1 = 3*in_near[i] + in_far[i];
+   out[i*2] = stbi__div16(3*t1 + t0 + 8);
+
+   for (++i; i < w; ++i) {
+      t0 = t1;
+      t1 = 3*in_near[i]+in_far[i];
+      out[i*2-1] = stbi__div16(3*t0 + t1 + 8);
+      out[i*2  ] = stbi__div16(3*t1 + t0 + 8);
+   }
+   out[w*2-1] = stbi__div4(t1+2);
+
+   STBI_NOTUSED(hs);
+
+   return out;
+}
+#endif
+
 static stbi_uc *stbi__resample_row_generic(stbi_uc *out, stbi_uc *in_near, stbi_uc *in_far, int w, int hs)
 {
    // resample with nearest-neighbor
@@ -3816,12 +4266,132 @@ static void stbi__YCbCr_to_RGB_simd(stbi_uc *out, stbi_uc const *y, stbi_uc cons
 }
 #endif
 
+#ifdef STBI_AVX2
+// 16 pixels at a time. step == 4 repeats the 16-bit math of the SSE2
+// version; step == 3, which that leaves to the generic code, repeats the
+// generic 32-bit math. Either way the output matches the SSE2 path, which
+// also does the leftover pixels.
+STBI__AVX2_TARGET static void stbi__YCbCr_to_RGB_avx2(stbi_uc *out, stbi_uc const *y, stbi_uc const *pcb, stbi_uc const *pcr, int count, int step)
+{
+   int i = 0;
+
+   if (step == 3 || step == 4) {
+      __m256i xw = _mm256_set1_epi16(255); // alpha channel
+      // keeps the first three bytes of every four, in each 128-bit lane
+      __m256i rgb_only = _mm256_setr_epi8(0,1,2,4,5,6,8,9,10,12,13,14,-1,-1,-1,-1, 0,1,2,4,5,6,8,9,10,12,13,14,-1,-1,-1,-1);
+
+      for (; i+15 < count; i += 16) {
+         __m256i rw, gw, bw;
+         if (step == 4) {
+            __m256i signflip  = _mm256_set1_epi16(0x80);
+            __m256i cr_const0 = _mm256_set1_epi16(   (short) ( 1.40200f*4096.0f+0.5f));
+            __m256i cr_const1 = _mm256_set1_epi16( - (short) ( 0.71414f*4096.0f+0.5f));
+            __m256i cb_const0 = _mm256_set1_epi16( - (short) ( 0.34414f*4096.0f+0.5f));
+            __m256i cb_const1 = _mm256_set1_epi16(   (short) ( 1.77200f*4096.0f+0.5f));
+
+            // load, and widen to short as the SSE2 unpacks do: y in the high
+            // byte over a bias of 128, cr and cb -128 and left-shifted by 8
+            __m256i y_bytes = _mm256_cvtepu8_epi16(_mm_loadu_si128((__m128i *) (y+i)));
+            __m256i cr_bytes = _mm256_cvtepu8_epi16(_mm_loadu_si128((__m128i *) (pcr+i)));
+            __m256i cb_bytes = _mm256_cvtepu8_epi16(_mm_loadu_si128((__m128i *) (pcb+i)));
+            __m256i yw  = _mm256_or_si256(_mm256_slli_epi16(y_bytes, 8), _mm256_set1_epi16(128));
+            __m256i crw = _mm256_slli_epi16(_mm256_xor_si256(cr_bytes, signflip), 8);
+            __m256i cbw = _mm256_slli_epi16(_mm256_xor_si256(cb_bytes, signflip), 8);
+
+            // color transform
+            __m256i yws = _mm256_srli_epi16(yw, 4);
+            __m256i cr0 = _mm256_mulhi_epi16(cr_const0, crw);
+            __m256i cb0 = _mm256_mulhi_epi16(cb_const0, cbw);
+            __m256i cb1 = _mm256_mulhi_epi16(cbw, cb_const1);
+            __m256i cr1 = _mm256_mulhi_epi16(crw, cr_const1);
+            __m256i rws = _mm256_add_epi16(cr0, yws);
+            __m256i gwt = _mm256_add_epi16(cb0, yws);
+            __m256i bws = _mm256_add_epi16(yws, cb1);
+            __m256i gws = _mm256_add_epi16(gwt, cr1);
+
+            // descale
+            rw = _mm256_srai_epi16(rws, 4);
+            bw = _mm256_srai_epi16(bws, 4);
+            gw = _mm256_srai_epi16(gws, 4);
+         } else {
+            __m256i r_const  = _mm256_set1_epi32( stbi__float2fixed(1.40200f));
+            __m256i gr_const = _mm256_set1_epi32(-stbi__float2fixed(0.71414f));
+            __m256i gb_const = _mm256_set1_epi32(-stbi__float2fixed(0.34414f));
+            __m256i b_const  = _mm256_set1_epi32( stbi__float2fixed(1.77200f));
+            __m256i gb_mask  = _mm256_set1_epi32((int) 0xffff0000);
+            __m256i half[2][3];
+            int h;
+            for (h=0; h < 2; ++h) {
+               __m256i yv = _mm256_cvtepu8_epi32(_mm_loadl_epi64((__m128i *) (y+i+h*8)));
+               __m256i cr = _mm256_sub_epi32(_mm256_cvtepu8_epi32(_mm_loadl_epi64((__m128i *) (pcr+i+h*8))), _mm256_set1_epi32(128));
+               __m256i cb = _mm256_sub_epi32(_mm256_cvtepu8_epi32(_mm_loadl_epi64((__m128i *) (pcb+i+h*8))), _mm256_set1_epi32(128));
+               __m256i y_fixed = _mm256_add_epi32(_mm256_slli_epi32(yv, 20), _mm256_set1_epi32(1<<19)); // rounding
+               __m256i r = _mm256_add_epi32(y_fixed, _mm256_mullo_epi32(cr, r_const));
+               __m256i g = _mm256_add_epi32(_mm256_add_epi32(y_fixed, _mm256_mullo_epi32(cr, gr_const)),
+                                            _mm256_and_si256(_mm256_mullo_epi32(cb, gb_const), gb_mask));
+               __m256i b = _mm256_add_epi32(y_fixed, _mm256_mullo_epi32(cb, b_const));
+               half[h][0] = _mm256_srai_epi32(r, 20);
+               half[h][1] = _mm256_srai_epi32(g, 20);
+               half[h][2] = _mm256_srai_epi32(b, 20);
+            }
+            // to short, in pixel order again; the byte packs below clamp to
+            // 0..255 as the generic code does
+            rw = _mm256_permute4x64_epi64(_mm256_packs_epi32(half[0][0], half[1][0]), 0xd8);
+            gw = _mm256_permute4x64_epi64(_mm256_packs_epi32(half[0][1], half[1][1]), 0xd8);
+            bw = _mm256_permute4x64_epi64(_mm256_packs_epi32(half[0][2], half[1][2]), 0xd8);
+         }
+
+         {
+            // back to byte, set up for transpose; each lane holds 8 pixels
+            __m256i brb = _mm256_packus_epi16(rw, bw);
+            __m256i gxb = _mm256_packus_epi16(gw, xw);
+
+            // transpose to interleave channels
+            __m256i t0 = _mm256_unpacklo_epi8(brb, gxb);
+            __m256i t1 = _mm256_unpackhi_epi8(brb, gxb);
+            __m256i o0 = _mm256_unpacklo_epi16(t0, t1);
+            __m256i o1 = _mm256_unpackhi_epi16(t0, t1);
+
+            // pixels 0-7 and 8-15
+            __m256i p0 = _mm256_permute2x128_si256(o0, o1, 0x20);
+            __m256i p1 = _mm256_permute2x128_si256(o0, o1, 0x31);
+
+            // store; for step 3 every 16-byte store but the last is partly
+            // overwritten by the next one
+            if (step == 4) {
+               _mm256_storeu_si256((__m256i *) (out + 0), p0);
+               _mm256_storeu_si256((__m256i *) (out + 32), p1);
+               out += 64;
+            } else {
+               p0 = _mm256_shuffle_epi8(p0, rgb_only);
+               p1 = _mm256_shuffle_epi8(p1, rgb_only);
+               _mm_storeu_si128((__m128i *) (out + 0), _mm256_castsi256_si128(p0));
+               _mm_storeu_si128((__m128i *) (out + 12), _mm256_extracti128_si256(p0, 1));
+               _mm_storeu_si128((__m128i *) (out + 24), _mm256_castsi256_si128(p1));
+               _mm_storel_epi64((__m128i *) (out + 36), _mm256_extracti128_si256(p1, 1));
+               {
+                  int last = _mm_cvtsi128_si32(_mm_srli_si128(_mm256_extracti128_si256(p1, 1), 8));
+                  memcpy(out + 44, &last, 4);
+               }
+               out += 48;
+            }
+         }
+      }
+   }
+
+   stbi__YCbCr_to_RGB_simd(out, y + i, pcb + i, pcr + i, count - i, step);
+}
+#endif
+
 // set up the kernels
 static void stbi__setup_jpeg(stbi__jpeg *j)
 {
    j->idct_block_kernel = stbi__idct_block;
+   j->idct_block2_kernel = NULL;
    j->YCbCr_to_RGB_kernel = stbi__YCbCr_to_RGB_row;
    j->resample_row_hv_2_kernel = stbi__resample_row_hv_2;
+   if (stbi__reference_decode)
+      return;
 
 #ifdef STBI_SSE2
    if (stbi__sse2_available()) {
@@ -3831,6 +4401,14 @@ static void stbi__setup_jpeg(stbi__jpeg *j)
    }
 #endif
 
+#ifdef STBI_AVX2
+   if (stbi__avx2_available()) {
+      j->idct_block2_kernel = stbi__idct_avx2;
+      j->YCbCr_to_RGB_kernel = stbi__YCbCr_to_RGB_avx2;
+      j->resample_row_hv_2_kernel = stbi__resample_row_hv_2_avx2;
+   }
+#endif
+
 #ifdef STBI_NEON
    j->idct_block_kernel = stbi__idct_simd;
    j->YCbCr_to_RGB_kernel = stbi__YCbCr_to_RGB_simd;
@@ -4038,6 +4616,20 @@ static void *stbi__jpeg_load(stbi__context *s, int *x, int *y, int *comp, int re
    return result;
 }
 
+static stbi_uc *stbi__jpeg_load_preview(stbi__context *s, int *x, int *y, int *comp, int req_comp)
+{
+   stbi_uc *result;
+   stbi__jpeg* j = (stbi__jpeg*) stbi__malloc(sizeof(stbi__jpeg));
+   if (!j) return stbi__errpuc("outofmem", "Out of memory");
+   memset(j, 0, sizeof(stbi__jpeg));
+   j->s = s;
+   stbi__setup_jpeg(j);
+   j->dc_only = 1;
+   result = load_jpeg_image(j, x,y,comp,req_comp);
+   STBI_FREE(j);
+   return result;
+}
+
 static int stbi__jpeg_test(stbi__context *s)
 {
    int r;
@@ -4082,12 +4674,14 @@ static int stbi__jpeg_info(stbi__context *s, int *x, int *y, int *comp)
 //      - all input must be provided in an upfront buffer
 //      - all output is written to a single output buffer (can malloc/realloc)
 //    performance
-//      - fast huffman
+//      - fast huffman, with literal pairs decoded in one table lookup
+//      - 64-bit bit buffer refilled a word at a time
+//      - matches copied 8 bytes at a time
 
 #ifndef STBI_NO_ZLIB
 
 // fast-way is faster to check than jpeg huffman, but slow way is slower
-#define STBI__ZFAST_BITS  9 // accelerate all cases in default tables
+#define STBI__ZFAST_BITS  11 // accelerate all cases in default tables
 #define STBI__ZFAST_MASK  ((1 << STBI__ZFAST_BITS) - 1)
 #define STBI__ZNSYMS 288 // number of symbols in literal/length alphabet
 
@@ -4178,7 +4772,7 @@ typedef struct
    stbi_uc *zbuffer, *zbuffer_end;
    int num_bits;
    int hit_zeof_once;
-   stbi__uint32 code_buffer;
+   stbi__uint64 code_buffer;
 
    char *zout;
    char *zout_start;
@@ -4186,6 +4780,10 @@ typedef struct
    int   z_expandable;
 
    stbi__zhuffman z_length, z_distance;
+   // z_length's fast table again, with pairs of literals merged into one
+   // entry when both codes fit in STBI__ZFAST_BITS:
+   //    bits 0-8 symbol, 9-16 second literal, 17-20 code bits, 21 pair
+   stbi__uint32 z_length_pairs[1 << STBI__ZFAST_BITS];
 } stbi__zbuf;
 
 stbi_inline static int stbi__zeof(stbi__zbuf *z)
@@ -4198,23 +4796,65 @@ stbi_inline static stbi_uc stbi__zget8(stbi__zbuf *z)
    return stbi__zeof(z) ? 0 : *z->zbuffer++;
 }
 
+stbi_inline static stbi__uint64 stbi__zload64(const stbi_uc *p)
+{
+   // byte by byte so it works on either endianness; compilers turn this
+   // into a single load on little-endian targets
+   return  (stbi__uint64) p[0]        | ((stbi__uint64) p[1] <<  8) |
+          ((stbi__uint64) p[2] << 16) | ((stbi__uint64) p[3] << 24) |
+          ((stbi__uint64) p[4] << 32) | ((stbi__uint64) p[5] << 40) |
+          ((stbi__uint64) p[6] << 48) | ((stbi__uint64) p[7] << 56);
+}
+
+// tops up the bit buffer to at least 56 bits with as many whole bytes as
+// fit; only valid while 8 input bytes are left
+stbi_inline static void stbi__zrefill(stbi__zbuf *z)
+{
+   int n = (63 - z->num_bits) >> 3;
+   z->code_buffer |= (stbi__zload64(z->zbuffer) & (((stbi__uint64) 1 << (n * 8)) - 1)) << z->num_bits;
+   z->zbuffer += n;
+   z->num_bits += n * 8;
+}
+
 static void stbi__fill_bits(stbi__zbuf *z)
 {
-   do {
-      if (z->code_buffer >= (1U << z->num_bits)) {
-        z->zbuffer = z->zbuffer_end;  /* treat this as EOF so we fail. */
-        return;
-      }
-      z->code_buffer |= (unsigned int) stbi__zget8(z) << z->num_bits;
+   if (z->code_buffer >= ((stbi__uint64) 1 << z->num_bits)) {
+     z->zbuffer = z->zbuffer_end;  /* treat this as EOF so we fail. */
+     return;
+   }
+   if (z->zbuffer_end - z->zbuffer >= 8) {
+      stbi__zrefill(z);
+      return;
+   }
+   // stop at the end of the input; stbi__zpad_eof supplies the zero bits
+   // past it, so reading into them can be detected
+   while (z->num_bits <= 56 && !stbi__zeof(z)) {
+      z->code_buffer |= (stbi__uint64) *z->zbuffer++ << z->num_bits;
       z->num_bits += 8;
-   } while (z->num_bits <= 24);
+   }
+}
+
+static int stbi__zpad_eof(stbi__zbuf *z)
+{
+   if (z->hit_zeof_once) return 0;
+   // This is the first time we hit eof, insert 16 extra padding btis
+   // to allow us to keep going; if we actually consume any of them
+   // though, that is invalid data. This is caught later.
+   z->hit_zeof_once = 1;
+   z->num_bits += 16; // add 16 implicit zero bits
+   return 1;
 }
 
 stbi_inline static unsigned int stbi__zreceive(stbi__zbuf *z, int n)
 {
    unsigned int k;
-   if (z->num_bits < n) stbi__fill_bits(z);
-   k = z->code_buffer & ((1 << n) - 1);
+   if (z->num_bits < n) {
+      stbi__fill_bits(z);
+      // out of input even after the padding; keep returning zeros and let
+      // the end of block check report the truncation
+      if (z->num_bits < n && !stbi__zpad_eof(z)) z->num_bits = n;
+   }
+   k = (unsigned int) (z->code_buffer & ((1 << n) - 1));
    z->code_buffer >>= n;
    z->num_bits -= n;
    return k;
@@ -4225,7 +4865,7 @@ static int stbi__zhuffman_decode_slowpath(stbi__zbuf *a, stbi__zhuffman *z)
    int b,s,k;
    // not resolved by fast table, so compute it the slow way
    // use jpeg approach, which requires MSbits at top
-   k = stbi__bit_reverse(a->code_buffer, 16);
+   k = stbi__bit_reverse((int) (a->code_buffer & 0xffff), 16);
    for (s=STBI__ZFAST_BITS+1; ; ++s)
       if (k < z->maxcode[s])
          break;
@@ -4243,21 +4883,10 @@ stbi_inline static int stbi__zhuffman_decode(stbi__zbuf *a, stbi__zhuffman *z)
 {
    int b,s;
    if (a->num_bits < 16) {
-      if (stbi__zeof(a)) {
-         if (!a->hit_zeof_once) {
-            // This is the first time we hit eof, insert 16 extra padding btis
-            // to allow us to keep going; if we actually consume any of them
-            // though, that is invalid data. This is caught later.
-            a->hit_zeof_once = 1;
-            a->num_bits += 16; // add 16 implicit zero bits
-         } else {
-            // We already inserted our extra 16 padding bits and are again
-            // out, this stream is actually prematurely terminated.
-            return -1;
-         }
-      } else {
-         stbi__fill_bits(a);
-      }
+      stbi__fill_bits(a);
+      // We already inserted our extra 16 padding bits and are again
+      // out, this stream is actually prematurely terminated.
+      if (a->num_bits < 16 && !stbi__zpad_eof(a)) return -1;
    }
    b = z->fast[a->code_buffer & STBI__ZFAST_MASK];
    if (b) {
@@ -4305,11 +4934,137 @@ static const int stbi__zdist_base[32] = { 1,2,3,4,5,7,9,13,17,25,33,49,65,97,129
 static const int stbi__zdist_extra[32] =
 { 0,0,0,0,1,1,2,2,3,3,4,4,5,5,6,6,7,7,8,8,9,9,10,10,11,11,12,12,13,13};
 
+static void stbi__zbuild_length_pairs(stbi__zbuf *a)
+{
+   int i;
+   for (i=0; i < (1 << STBI__ZFAST_BITS); ++i) {
+      int b = a->z_length.fast[i];
+      int s = b >> 9;
+      stbi__uint32 e = b ? (stbi__uint32) ((b & 511) | (s << 17)) : 0;
+      if (b && (b & 511) < 256) {
+         // the bits past the first code start the second one; it counts if
+         // it is a literal whose code is entirely inside the table bits
+         int b2 = a->z_length.fast[i >> s];
+         int s2 = b2 >> 9;
+         if (b2 && (b2 & 511) < 256 && s + s2 <= STBI__ZFAST_BITS)
+            e = (stbi__uint32) ((b & 511) | ((b2 & 255) << 9) | ((s + s2) << 17) | (1 << 21));
+      }
+      a->z_length_pairs[i] = e;
+   }
+}
+
+// copies a match 8 bytes at a time; may write up to 15 bytes past len
+stbi_inline static void stbi__zcopy_match(char *zout, int dist, int len)
+{
+   char *end = zout + len;
+   int step = dist;
+   if (dist < 8) {
+      // the match repeats every dist bytes, so once a few bytes are in
+      // place it can equally be copied from a multiple of dist back that
+      // is at least 8 bytes away
+      int k;
+      while (step < 8) step += dist;
+      for (k = step - dist; k > 0 && zout < end; --k, ++zout)
+         *zout = zout[-dist];
+   }
+   while (zout < end) {
+      stbi__uint64 v;
+      memcpy(&v, zout - step, 8);
+      memcpy(zout, &v, 8);
+      memcpy(&v, zout + 8 - step, 8);
+      memcpy(zout + 8, &v, 8);
+      zout += 16;
+   }
+}
+
 static int stbi__parse_huffman_block(stbi__zbuf *a)
 {
    char *zout = a->zout;
    for(;;) {
-      int z = stbi__zhuffman_decode(a, &a->z_length);
+      int z;
+      // fast loop: while 8 input bytes are left one refill covers a whole
+      // literal/length code, distance code and their extra bits (at most
+      // 48 bits), and room for the longest match plus the overrun of
+      // stbi__zcopy_match means no output checks. The bit buffer is kept
+      // in locals, since the compiler has to assume stores to zout alias a.
+      if (a->zbuffer_end - a->zbuffer >= 8 && !stbi__reference_decode) {
+         stbi__uint64 bits = a->code_buffer;
+         int num_bits = a->num_bits;
+         stbi_uc *zin = a->zbuffer, *zin_end = a->zbuffer_end;
+         char *zout_end = a->zout_end;
+         while (zin_end - zin >= 8 && zout_end - zout >= 258 + 16) {
+            stbi__uint32 e;
+            int n,len,dist;
+            n = (63 - num_bits) >> 3;
+            bits |= (stbi__zload64(zin) & (((stbi__uint64) 1 << (n * 8)) - 1)) << num_bits;
+            zin += n;
+            num_bits += n * 8;
+            e = a->z_length_pairs[bits & STBI__ZFAST_MASK];
+            if (e) {
+               n = (e >> 17) & 15;
+               bits >>= n;
+               num_bits -= n;
+               z = e & 511;
+            } else {
+               a->code_buffer = bits;
+               a->num_bits = num_bits;
+               z = stbi__zhuffman_decode_slowpath(a, &a->z_length);
+               if (z < 0) return stbi__err("bad huffman code","Corrupt PNG"); // error in huffman codes
+               bits = a->code_buffer;
+               num_bits = a->num_bits;
+               e = (stbi__uint32) z;
+            }
+            if (z < 256) {
+               zout[0] = (char) z;
+               zout[1] = (char) (e >> 9);
+               zout += 1 + ((e >> 21) & 1);
+               continue;
+            }
+            if (z == 256) {
+               a->code_buffer = bits;
+               a->num_bits = num_bits;
+               a->zbuffer = zin;
+               a->zout = zout;
+               return 1;
+            }
+            if (z >= 286) return stbi__err("bad huffman code","Corrupt PNG"); // per DEFLATE, length codes 286 and 287 must not appear in compressed data
+            z -= 257;
+            n = stbi__zlength_extra[z];
+            len = stbi__zlength_base[z] + (int) (bits & ((1 << n) - 1));
+            bits >>= n;
+            num_bits -= n;
+            z = a->z_distance.fast[bits & STBI__ZFAST_MASK];
+            if (z) {
+               n = z >> 9;
+               bits >>= n;
+               num_bits -= n;
+               z &= 511;
+            } else {
+               a->code_buffer = bits;
+               a->num_bits = num_bits;
+               z = stbi__zhuffman_decode_slowpath(a, &a->z_distance);
+               bits = a->code_buffer;
+               num_bits = a->num_bits;
+            }
+            if (z < 0 || z >= 30) return stbi__err("bad huffman code","Corrupt PNG"); // per DEFLATE, distance codes 30 and 31 must not appear in compressed data
+            n = stbi__zdist_extra[z];
+            dist = stbi__zdist_base[z] + (int) (bits & ((1 << n) - 1));
+            bits >>= n;
+            num_bits -= n;
+            if (zout - a->zout_start < dist) return stbi__err("bad dist","Corrupt PNG");
+            if (dist == 1)
+               memset(zout, zout[-1], len);
+            else
+               stbi__zcopy_match(zout, dist, len);
+            zout += len;
+         }
+         a->code_buffer = bits;
+         a->num_bits = num_bits;
+         a->zbuffer = zin;
+      }
+
+      // near the end of the input or output, one symbol at a time
+      z = stbi__zhuffman_decode(a, &a->z_length);
       if (z < 256) {
          if (z < 0) return stbi__err("bad huffman code","Corrupt PNG"); // error in huffman codes
          if (zout >= a->zout_end) {
@@ -4408,12 +5163,12 @@ static int stbi__compute_huffman_codes(stbi__zbuf *a)
 static int stbi__parse_uncompressed_block(stbi__zbuf *a)
 {
    stbi_uc header[4];
-   int len,nlen,k;
+   int len,nlen,k,buffered;
    if (a->num_bits & 7)
       stbi__zreceive(a, a->num_bits & 7); // discard
    // drain the bit-packed data into header
    k = 0;
-   while (a->num_bits > 0) {
+   while (a->num_bits > 0 && k < 4) {
       header[k++] = (stbi_uc) (a->code_buffer & 255); // suppress MSVC run-time check
       a->code_buffer >>= 8;
       a->num_bits -= 8;
@@ -4425,9 +5180,18 @@ static int stbi__parse_uncompressed_block(stbi__zbuf *a)
    len  = header[1] * 256 + header[0];
    nlen = header[3] * 256 + header[2];
    if (nlen != (len ^ 0xffff)) return stbi__err("zlib corrupt","Corrupt PNG");
-   if (a->zbuffer + len > a->zbuffer_end) return stbi__err("read past buffer","Corrupt PNG");
+   // the bit buffer can still hold the first few bytes of the block
+   buffered = a->num_bits >> 3;
+   if (buffered > len) buffered = len;
+   if (a->zbuffer + (len - buffered) > a->zbuffer_end) return stbi__err("read past buffer","Corrupt PNG");
    if (a->zout + len > a->zout_end)
       if (!stbi__zexpand(a, a->zout, len)) return 0;
+   for (k=0; k < buffered; ++k) {
+      *a->zout++ = (char) (a->code_buffer & 255);
+      a->code_buffer >>= 8;
+      a->num_bits -= 8;
+   }
+   len -= buffered;
    memcpy(a->zout, a->zbuffer, len);
    a->zbuffer += len;
    a->zout += len;
@@ -4500,6 +5264,7 @@ static int stbi__parse_zlib(stbi__zbuf *a, int parse_header)
          } else {
             if (!stbi__compute_huffman_codes(a)) return 0;
          }
+         stbi__zbuild_length_pairs(a);
          if (!stbi__parse_huffman_block(a)) return 0;
       }
    } while (!final);
@@ -4666,6 +5431,111 @@ static int stbi__paeth(int a, int b, int c)
    return t1;
 }
 
+#ifdef STBI_SSE2
+// SSE2 unfiltering of 8-bit images with 3 or 4 bytes per pixel. Sub, Avg
+// and Paeth depend on the pixel to the left, so they go a pixel at a time
+// with all its channels at once; they start after the first pixel, which
+// the caller has done. Up has no such dependency and goes 16 bytes at a
+// time, returning how far it got.
+
+stbi_inline static __m128i stbi__png_load_pixel(const stbi_uc *p, int n)
+{
+   // 3-byte pixels must not be read as 4, the row can end right there
+   stbi__uint32 v;
+   if (n == 4)
+      memcpy(&v, p, 4);
+   else
+      v = p[0] | (p[1] << 8) | (p[2] << 16);
+   return _mm_cvtsi32_si128((int) v);
+}
+
+stbi_inline static void stbi__png_store_pixel(stbi_uc *p, __m128i x, int n)
+{
+   stbi__uint32 v = (stbi__uint32) _mm_cvtsi128_si32(x);
+   if (n == 4)
+      memcpy(p, &v, 4);
+   else {
+      p[0] = (stbi_uc) v;
+      p[1] = (stbi_uc) (v >> 8);
+      p[2] = (stbi_uc) (v >> 16);
+   }
+}
+
+static void stbi__png_sub_sse2(stbi_uc *cur, const stbi_uc *raw, int nk, int n)
+{
+   __m128i a = stbi__png_load_pixel(cur, n);
+   int k;
+   for (k = n; k < nk; k += n) {
+      a = _mm_add_epi8(a, stbi__png_load_pixel(raw + k, n));
+      stbi__png_store_pixel(cur + k, a, n);
+   }
+}
+
+static void stbi__png_avg_sse2(stbi_uc *cur, const stbi_uc *raw, const stbi_uc *prior, int nk, int n)
+{
+   __m128i one = _mm_set1_epi8(1);
+   __m128i a = stbi__png_load_pixel(cur, n);
+   int k;
+   for (k = n; k < nk; k += n) {
+      __m128i b = stbi__png_load_pixel(prior + k, n);
+      // pavgb rounds up; take off the carried bit to get (a+b)>>1
+      __m128i avg = _mm_sub_epi8(_mm_avg_epu8(a, b), _mm_and_si128(_mm_xor_si128(a, b), one));
+      a = _mm_add_epi8(avg, stbi__png_load_pixel(raw + k, n));
+      stbi__png_store_pixel(cur + k, a, n);
+   }
+}
+
+static void stbi__png_paeth_sse2(stbi_uc *cur, const stbi_uc *raw, const stbi_uc *prior, int nk, int n)
+{
+   // stbi__paeth in 16-bit lanes; a stays unpacked between pixels, which
+   // keeps the pack and unpack off the dependency chain
+   __m128i zero = _mm_setzero_si128();
+   __m128i mask = _mm_set1_epi16(0xff);
+   __m128i a = _mm_unpacklo_epi8(stbi__png_load_pixel(cur, n), zero);
+   __m128i c = _mm_unpacklo_epi8(stbi__png_load_pixel(prior, n), zero);
+   int k;
+   for (k = n; k < nk; k += n) {
+      __m128i b = _mm_unpacklo_epi8(stbi__png_load_pixel(prior + k, n), zero);
+      __m128i r = _mm_unpacklo_epi8(stbi__png_load_pixel(raw + k, n), zero);
+      __m128i c3 = _mm_add_epi16(c, _mm_add_epi16(c, c));
+      __m128i thresh = _mm_sub_epi16(c3, _mm_add_epi16(a, b));
+      __m128i lo = _mm_min_epi16(a, b);
+      __m128i hi = _mm_max_epi16(a, b);
+      __m128i hi_above = _mm_cmpgt_epi16(hi, thresh);
+      __m128i lo_below = _mm_cmpgt_epi16(thresh, lo);
+      __m128i t0 = _mm_or_si128(_mm_and_si128(hi_above, c), _mm_andnot_si128(hi_above, lo));
+      __m128i t1 = _mm_or_si128(_mm_and_si128(lo_below, t0), _mm_andnot_si128(lo_below, hi));
+      a = _mm_and_si128(_mm_add_epi16(t1, r), mask);
+      stbi__png_store_pixel(cur + k, _mm_packus_epi16(a, a), n);
+      c = b;
+   }
+}
+
+static int stbi__png_up_sse2(stbi_uc *cur, const stbi_uc *raw, const stbi_uc *prior, int nk)
+{
+   int k;
+   for (k = 0; k + 16 <= nk; k += 16) {
+      __m128i r = _mm_loadu_si128((const __m128i *) (raw + k));
+      __m128i b = _mm_loadu_si128((const __m128i *) (prior + k));
+      _mm_storeu_si128((__m128i *) (cur + k), _mm_add_epi8(r, b));
+   }
+   return k;
+}
+#endif // STBI_SSE2
+
+#if defined(STBI_AVX2) && !defined(STBI_NO_PNG)
+static STBI__AVX2_TARGET int stbi__png_up_avx2(stbi_uc *cur, const stbi_uc *raw, const stbi_uc *prior, int nk)
+{
+   int k;
+   for (k = 0; k + 32 <= nk; k += 32) {
+      __m256i r = _mm256_loadu_si256((const __m256i *) (raw + k));
+      __m256i b = _mm256_loadu_si256((const __m256i *) (prior + k));
+      _mm256_storeu_si256((__m256i *) (cur + k), _mm256_add_epi8(r, b));
+   }
+   return k;
+}
+#endif
+
 static const stbi_uc stbi__depth_scale_table[9] = { 0, 0xff, 0x55, 0, 0x11, 0,0,0, 0x01 };
 
 // adds an extra all-255 alpha channel
@@ -4706,6 +5576,10 @@ static int stbi__create_png_image_raw(stbi__png *a, stbi_uc *raw, stbi__uint32 r
    int output_bytes = out_n*bytes;
    int filter_bytes = img_n*bytes;
    int width = x;
+   int (*up_kernel)(stbi_uc *cur, const stbi_uc *raw, const stbi_uc *prior, int nk) = NULL;
+#ifdef STBI_SSE2
+   int pixel_simd = 0;
+#endif
 
    STBI_ASSERT(out_n == s->img_n || out_n == s->img_n+1);
    a->out = (stbi_uc *) stbi__malloc_mad3(x, y, output_bytes, 0); // extra bytes to write off the end into
@@ -4733,6 +5607,17 @@ static int stbi__create_png_image_raw(stbi__png *a, stbi_uc *raw, stbi__uint32 r
       width = img_width_bytes;
    }
 
+#ifdef STBI_SSE2
+   if (!stbi__reference_decode && stbi__sse2_available()) {
+      up_kernel = stbi__png_up_sse2;
+#ifdef STBI_AVX2
+      if (stbi__avx2_available())
+         up_kernel = stbi__png_up_avx2;
+#endif
+      pixel_simd = depth == 8 && (filter_bytes == 3 || filter_bytes == 4);
+   }
+#endif
+
    for (j=0; j < y; ++j) {
       // cur/prior filter buffers alternate
       stbi_uc *cur = filter_buf + (j & 1)*img_width_bytes;
@@ -4757,22 +5642,41 @@ static int stbi__create_png_image_raw(stbi__png *a, stbi_uc *raw, stbi__uint32 r
          break;
       case STBI__F_sub:
          memcpy(cur, raw, filter_bytes);
+#ifdef STBI_SSE2
+         if (pixel_simd) {
+            stbi__png_sub_sse2(cur, raw, nk, filter_bytes);
+            break;
+         }
+#endif
          for (k = filter_bytes; k < nk; ++k)
             cur[k] = STBI__BYTECAST(raw[k] + cur[k-filter_bytes]);
          break;
       case STBI__F_up:
-         for (k = 0; k < nk; ++k)
+         k = up_kernel ? up_kernel(cur, raw, prior, nk) : 0;
+         for (; k < nk; ++k)
             cur[k] = STBI__BYTECAST(raw[k] + prior[k]);
          break;
       case STBI__F_avg:
          for (k = 0; k < filter_bytes; ++k)
             cur[k] = STBI__BYTECAST(raw[k] + (prior[k]>>1));
+#ifdef STBI_SSE2
+         if (pixel_simd) {
+            stbi__png_avg_sse2(cur, raw, prior, nk, filter_bytes);
+            break;
+         }
+#endif
          for (k = filter_bytes; k < nk; ++k)
             cur[k] = STBI__BYTECAST(raw[k] + ((prior[k] + cur[k-filter_bytes])>>1));
          break;
       case STBI__F_paeth:
          for (k = 0; k < filter_bytes; ++k)
             cur[k] = STBI__BYTECAST(raw[k] + prior[k]); // prior[k] == stbi__paeth(0,prior[k],0)
+#ifdef STBI_SSE2
+         if (pixel_simd) {
+            stbi__png_paeth_sse2(cur, raw, prior, nk, filter_bytes);
+            break;
+         }
+#endif
          for (k = filter_bytes; k < nk; ++k)
             cur[k] = STBI__BYTECAST(raw[k] + stbi__paeth(cur[k-filter_bytes], prior[k], prior[k-filter_bytes]));
          break;
@@ -0,0 +1,710 @@
+#ifndef TEXTURE_ARRAY_H
+#define TEXTURE_ARRAY_H
+
+#include <glad/glad.h>
+#include <glm/glm.hpp>
+
+#include <algorithm>
+#include <climits>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <iostream>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "assetloader.h"
+#include "bcencoder.h"
+#include "cookedtexture.h"
+#include "glstate.h"
+#include "mipgenerator.h"
+#include "texturestream.h"
+
+// binding point of the TextureRegions block in shader.fs
+const GLuint TEXTURE_REGION_BINDING = 2;
+
+// where one image sits in a texture array, read in shader.fs with the
+// index TextureArrayBuilder::add returned; std430 layout
+// ------------------------------------------------------------------------
+struct TextureRegion
+{
+	glm::vec4 rect;		// xy: UV offset in the layer, zw: UV scale
+	std::uint32_t layer;
+	// first mip level the image may be sampled from: where its preview is
+	// until the full image is in, then 0
+	float minLevel;
+	// last one; past it, the border around an image in a shared layer is
+	// under a texel wide
+	float maxLevel;
+	std::uint32_t padding;
+};
+static_assert(sizeof(TextureRegion) == 32, "TextureRegion must match the std430 struct layout");
+
+// bottom-left skyline packer: the top edge of everything placed so far is
+// kept as a list of horizontal segments, and each rectangle goes where its
+// top ends up lowest
+// ------------------------------------------------------------------------
+class SkylinePacker
+{
+public:
+	// ------------------------------------------------------------------------
+	void init(int packWidth, int packHeight)
+	{
+		width = packWidth;
+		height = packHeight;
+		usedArea = 0;
+		skyline.assign(1, Segment{ 0, 0, packWidth });
+	}
+	// finds room for a rectangle; false when there is none
+	// ------------------------------------------------------------------------
+	bool insert(int rectWidth, int rectHeight, int& x, int& y)
+	{
+		size_t best = skyline.size();
+		int bestTop = INT_MAX, bestWidth = INT_MAX;
+		for (size_t i = 0; i < skyline.size(); i++)
+		{
+			int top = fit(i, rectWidth, rectHeight);
+			if (top < 0)
+				continue;
+			top += rectHeight;
+			// ties go to the narrower segment, which wastes less space beside it
+			if (top < bestTop || (top == bestTop && skyline[i].width < bestWidth))
+			{
+				best = i;
+				bestTop = top;
+				bestWidth = skyline[i].width;
+			}
+		}
+		if (best == skyline.size())
+			return false;
+
+		x = skyline[best].x;
+		y = bestTop - rectHeight;
+		skyline.insert(skyline.begin() + best, Segment{ x, bestTop, rectWidth });
+		// the segments now under the rectangle shrink or go
+		for (size_t i = best + 1; i < skyline.size();)
+		{
+			int overlap = x + rectWidth - skyline[i].x;
+			if (overlap <= 0)
+				break;
+			if (overlap < skyline[i].width)
+			{
+				skyline[i].x += overlap;
+				skyline[i].width -= overlap;
+				break;
+			}
+			skyline.erase(skyline.begin() + i);
+		}
+		for (size_t i = 0; i + 1 < skyline.size();)
+		{
+			if (skyline[i].y == skyline[i + 1].y)
+			{
+				skyline[i].width += skyline[i + 1].width;
+				skyline.erase(skyline.begin() + i + 1);
+			}
+			else
+				i++;
+		}
+		usedArea += static_cast<size_t>(rectWidth) * rectHeight;
+		return true;
+	}
+	// share of the area covered by rectangles
+	// ------------------------------------------------------------------------
+	float occupancy() const
+	{
+		return width && height ? static_cast<float>(usedArea) / (static_cast<size_t>(width) * height) : 0.0f;
+	}
+
+private:
+	struct Segment
+	{
+		int x;
+		int y;
+		int width;
+	};
+
+	std::vector<Segment> skyline;
+	int width = 0;
+	int height = 0;
+	size_t usedArea = 0;
+
+	// the y a rectangle resting on the skyline from segment index onwards
+	// ends up at; -1 when it would stick out of the area
+	int fit(size_t index, int rectWidth, int rectHeight) const
+	{
+		if (skyline[index].x + rectWidth > width)
+			return -1;
+		int y = 0;
+		for (int widthLeft = rectWidth; widthLeft > 0; index++)
+		{
+			y = std::max(y, skyline[index].y);
+			if (y + rectHeight > height)
+				return -1;
+			widthLeft -= skyline[index].width;
+		}
+		return y;
+	}
+};
+
+// packs 8-bit images into the layers of one GL_TEXTURE_2D_ARRAY, so draws
+// using different images need no texture binds in between. Layers are as
+// big as the largest image needs, up to maxLayerSize; larger images are
+// scaled down to fit. An image too big to pad takes a layer of its own
+// from the corner; the others share layers through a SkylinePacker, each
+// inside a border of its repeated edge texels. Every image is mipmapped on
+// its own before it joins its layer, so no level filters neighbours
+// together, and images in shared layers stop at the level their border is
+// one texel wide (TextureRegion::maxLevel) so sampling cannot reach them.
+//
+// Images are loaded on a JobPool, from their cooked files where there are
+// some. Until a layer is in, its regions are drawn from a preview on the
+// smaller levels (TextureRegion::minLevel), put together from the mips of
+// cooked files and the DC images of progressive JPEGs.
+// ------------------------------------------------------------------------
+class TextureArrayBuilder
+{
+public:
+	GLuint texture = 0;
+	GLuint regionBuffer = 0;
+
+	// padding is rounded up to a power of two
+	explicit TextureArrayBuilder(int maxLayerSize = 1024, int padding = 8) : maxLayerSize(maxLayerSize)
+	{
+		while (this->padding < padding)
+		{
+			this->padding *= 2;
+			paddedLevels++;
+		}
+	}
+	TextureArrayBuilder(const TextureArrayBuilder&) = delete;
+	TextureArrayBuilder& operator=(const TextureArrayBuilder&) = delete;
+
+	// queues the image at path, flipped for GL, and returns its region
+	// index. Its cooked file is used instead if there is one (see
+	// cookedPath). Only the size is read here. A file whose size cannot be
+	// read is reported and gets the fallback() region. Adding a path again
+	// returns the region it got the first time; the whole array shares one
+	// compression, so the path alone identifies the texels.
+	// ------------------------------------------------------------------------
+	int add(const std::string& path)
+	{
+		auto added = pathRegions.find(path);
+		if (added != pathRegions.end())
+			return added->second;
+		int region = addFile(path);
+		pathRegions[path] = region;
+		return region;
+	}
+	// region of a magenta and black checkerboard, for images that failed to
+	// load; added the first time it is asked for
+	// ------------------------------------------------------------------------
+	int fallback()
+	{
+		if (fallbackRegion < 0)
+			fallbackRegion = add("fallback", 64, 64, false, checkerboard(64, 64));
+		return fallbackRegion;
+	}
+	// valid once build() has laid the images out
+	// ------------------------------------------------------------------------
+	const TextureRegion& region(unsigned int index) const
+	{
+		return regions[index];
+	}
+	// ------------------------------------------------------------------------
+	unsigned int layerCount() const
+	{
+		return static_cast<unsigned int>(layers.size());
+	}
+	// ------------------------------------------------------------------------
+	int size() const
+	{
+		return layerSize;
+	}
+	// lays the images out, creates the array texture with a full mip chain
+	// per layer, block-compressed unless compression is COMPRESSION_NONE,
+	// and uploads the regions to TEXTURE_REGION_BINDING.
+	//
+	// Without a streamer every image is loaded and every layer filled here,
+	// spread over the pool. With one, the previews are uploaded here and
+	// each image is a job on the pool; the job finishing a layer's images
+	// streams the layer in (see TextureStreamer::enqueueLayer). Pass the
+	// streamer's completions to uploaded().
+	// ------------------------------------------------------------------------
+	void build(TextureCompression textureCompression, JobPool& pool, TextureStreamer* textureStreamer = nullptr)
+	{
+		if (images.empty())
+			return;
+		compression = textureCompression;
+		streamer = textureStreamer;
+		layout();
+
+		GLsizei levelCount = 1;
+		for (int size = layerSize; size > 1; size /= 2)
+			levelCount++;
+		previewLevel = std::min(paddedLevels, static_cast<int>(levelCount) - 1);
+		glGenTextures(1, &texture);
+		glState().bindTexture(0, GL_TEXTURE_2D_ARRAY, texture);
+		glTexStorage3D(GL_TEXTURE_2D_ARRAY, levelCount, format(), layerSize, layerSize, static_cast<GLsizei>(layers.size()));
+		glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+		glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+		glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
+		glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+
+		if (streamer)
+		{
+			for (unsigned int layer = 0; layer < layers.size(); layer++)
+				uploadPreview(layer, pool);
+		}
+		else
+		{
+			parallelFor(&pool, static_cast<int>(images.size()), [this](int index) { load(images[index]); });
+			for (unsigned int layer = 0; layer < layers.size(); layer++)
+				upload(layer, 0, prepareLayer(layer, &pool));
+			for (TextureRegion& region : regions)
+				region.minLevel = 0.0f;
+			layersUploaded = layerCount();
+		}
+
+		glGenBuffers(1, &regionBuffer);
+		glBindBuffer(GL_SHADER_STORAGE_BUFFER, regionBuffer);
+		glBufferData(GL_SHADER_STORAGE_BUFFER, regions.size() * sizeof(TextureRegion), regions.data(), GL_DYNAMIC_DRAW);
+		glBindBufferBase(GL_SHADER_STORAGE_BUFFER, TEXTURE_REGION_BINDING, regionBuffer);
+
+		if (!streamer)
+			return;
+		// layers whose images are all in memory already go first
+		for (unsigned int index = 0; index < images.size(); index++)
+		{
+			if (!images[index].rgba.empty())
+				loaded(index);
+		}
+		for (unsigned int index = 0; index < images.size(); index++)
+		{
+			if (images[index].rgba.empty())
+			{
+				pool.submit([this, index]
+				{
+					load(images[index]);
+					loaded(index);
+				});
+			}
+		}
+	}
+	// for TextureStreamer completions: switches the regions of a layer of
+	// this array from its preview to the full image; false for any other
+	// texture
+	// ------------------------------------------------------------------------
+	bool uploaded(GLuint uploadedTexture, GLint layer)
+	{
+		if (!texture || uploadedTexture != texture || layer < 0)
+			return false;
+		layersUploaded++;
+		for (unsigned int index : layers[layer].images)
+			regions[index].minLevel = 0.0f;
+		glBindBuffer(GL_SHADER_STORAGE_BUFFER, regionBuffer);
+		glBufferSubData(GL_SHADER_STORAGE_BUFFER, 0, regions.size() * sizeof(TextureRegion), regions.data());
+		return true;
+	}
+	// ------------------------------------------------------------------------
+	bool ready() const
+	{
+		return texture && layersUploaded == layerCount();
+	}
+	// blocks until every streamed layer is in
+	// ------------------------------------------------------------------------
+	void finish(TextureStreamer& target)
+	{
+		while (texture && !ready())
+			target.finish(1, [this](GLuint uploadedTexture, GLint layer, size_t) { uploaded(uploadedTexture, layer); });
+	}
+	// streamed layers must be in first, see finish()
+	// ------------------------------------------------------------------------
+	void release()
+	{
+		glDeleteTextures(1, &texture);
+		glState().forgetTexture(texture);
+		glDeleteBuffers(1, &regionBuffer);
+		texture = regionBuffer = 0;
+		layersUploaded = 0;
+		fallbackRegion = -1;
+		layers.clear();
+		images.clear();
+		regions.clear();
+		pathRegions.clear();
+	}
+
+private:
+	struct Image
+	{
+		std::string path;
+		int width;
+		int height;
+		// read from cookedPath(path)
+		bool cooked;
+		// level 0, once loaded
+		std::vector<std::uint8_t> rgba;
+		// set by layout(): the size the image is drawn at, and the rect it
+		// fills with its border, x, y being the rect's corner
+		int scaledWidth = 0;
+		int scaledHeight = 0;
+		int x = 0;
+		int y = 0;
+		int rectWidth = 0;
+		int rectHeight = 0;
+		unsigned int layer = 0;
+		bool shared = false;
+	};
+	struct Layer
+	{
+		SkylinePacker packer;
+		std::vector<unsigned int> images;
+		bool shared = false;
+		// images still loading, under mutex
+		unsigned int loading = 0;
+	};
+
+	int maxLayerSize;
+	int padding = 1;
+	// levels until the padding is one texel wide
+	int paddedLevels = 0;
+	int layerSize = 0;
+	int previewLevel = 0;
+	int fallbackRegion = -1;
+	unsigned int layersUploaded = 0;
+	TextureCompression compression = COMPRESSION_NONE;
+	TextureStreamer* streamer = nullptr;
+	std::vector<Image> images;
+	std::vector<Layer> layers;
+	std::vector<TextureRegion> regions;
+	std::unordered_map<std::string, int> pathRegions;
+	std::mutex mutex;
+
+	int addFile(const std::string& path)
+	{
+		int width = 0, height = 0, channels = 0;
+		CookedTexture cooked;
+		bool isCooked = cooked.open(cookedPath(path)) && cooked.target() == GL_TEXTURE_2D;
+		if (isCooked)
+		{
+			width = cooked.width(0);
+			height = cooked.height(0);
+		}
+		else if (!stbi_info(path.c_str(), &width, &height, &channels))
+		{
+			std::cout << "Failed to load texture, drawing the fallback instead: " << path << std::endl;
+			return fallback();
+		}
+		return add(path, width, height, isCooked, std::vector<std::uint8_t>());
+	}
+
+	int add(const std::string& path, int width, int height, bool cooked, std::vector<std::uint8_t> rgba)
+	{
+		Image image;
+		image.path = path;
+		image.width = width;
+		image.height = height;
+		image.cooked = cooked;
+		image.rgba = std::move(rgba);
+		images.push_back(std::move(image));
+		regions.push_back(TextureRegion());
+		return static_cast<int>(images.size() - 1);
+	}
+	// ------------------------------------------------------------------------
+	GLenum format() const
+	{
+		return compression != COMPRESSION_NONE ? compressedFormat(compression) : GL_RGBA8;
+	}
+
+	// picks the layer size and places every image, in the order added. The
+	// padded rects are whole multiples of the padding, so every rect stays
+	// aligned to its texels down to the last level it is sampled from.
+	void layout()
+	{
+		int largest = 1;
+		for (const Image& image : images)
+			largest = std::max(largest, std::max(image.width, image.height));
+		layerSize = 1;
+		while (layerSize < largest && layerSize < maxLayerSize)
+			layerSize *= 2;
+		float levels = std::log2(static_cast<float>(layerSize));
+
+		for (unsigned int index = 0; index < images.size(); index++)
+		{
+			Image& image = images[index];
+			image.scaledWidth = image.width;
+			image.scaledHeight = image.height;
+			if (image.width > layerSize || image.height > layerSize)
+			{
+				float scale = static_cast<float>(layerSize) / std::max(image.width, image.height);
+				image.scaledWidth = std::min(layerSize, std::max(1, static_cast<int>(image.width * scale + 0.5f)));
+				image.scaledHeight = std::min(layerSize, std::max(1, static_cast<int>(image.height * scale + 0.5f)));
+				std::cout << "Scaling " << image.path << " from " << image.width << "x" << image.height << " down to " << image.scaledWidth
+					<< "x" << image.scaledHeight << " to fit a " << layerSize << "x" << layerSize << " array layer" << std::endl;
+			}
+			auto roundUp = [this](int size) { return (size + padding - 1) / padding * padding; };
+			int rectWidth = roundUp(image.scaledWidth + padding * 2), rectHeight = roundUp(image.scaledHeight + padding * 2);
+			image.shared = rectWidth <= layerSize && rectHeight <= layerSize;
+			image.rectWidth = image.shared ? rectWidth : layerSize;
+			image.rectHeight = image.shared ? rectHeight : layerSize;
+
+			size_t layer = layers.size();
+			if (image.shared)
+			{
+				for (layer = 0; layer < layers.size(); layer++)
+				{
+					if (layers[layer].shared && layers[layer].packer.insert(image.rectWidth, image.rectHeight, image.x, image.y))
+						break;
+				}
+			}
+			if (layer == layers.size())
+			{
+				layers.emplace_back();
+				Layer& added = layers.back();
+				added.shared = image.shared;
+				added.packer.init(layerSize, layerSize);
+				added.packer.insert(image.rectWidth, image.rectHeight, image.x, image.y);
+			}
+			layers[layer].images.push_back(index);
+			layers[layer].loading++;
+			image.layer = static_cast<unsigned int>(layer);
+
+			int border = image.shared ? padding : 0;
+			TextureRegion& region = regions[index];
+			region.rect = glm::vec4(image.x + border, image.y + border, image.scaledWidth, image.scaledHeight) / static_cast<float>(layerSize);
+			region.layer = image.layer;
+			region.minLevel = image.shared ? static_cast<float>(paddedLevels) : std::min(levels, static_cast<float>(paddedLevels));
+			region.maxLevel = image.shared ? static_cast<float>(paddedLevels) : levels;
+			region.padding = 0;
+		}
+	}
+
+	// any thread: reads an image's level 0, reporting a failure and drawing
+	// the checkerboard in its place
+	static void load(Image& image)
+	{
+		if (!image.rgba.empty())
+			return;
+		if (image.cooked)
+		{
+			CookedTexture cooked;
+			if (cooked.open(cookedPath(image.path)) && cooked.target() == GL_TEXTURE_2D && cooked.width(0) == image.width &&
+				cooked.height(0) == image.height)
+				image.rgba = levelRGBA(cooked, 0);
+		}
+		else
+		{
+			DecodedImage decoded = AssetLoader::decode(image.path, true);
+			if (decoded.pixels && decoded.width == image.width && decoded.height == image.height)
+				image.rgba = expandToRGBA(decoded);
+			decoded.release();
+		}
+		if (image.rgba.empty())
+		{
+			std::cout << "Failed to load texture, drawing the fallback instead: " << image.path << std::endl;
+			image.rgba = checkerboard(image.width, image.height);
+		}
+	}
+	// streams the image's layer in once it is the last of the layer's
+	// images to load; from the load jobs, and build() for images that came
+	// with their pixels
+	void loaded(unsigned int index)
+	{
+		unsigned int layer = images[index].layer;
+		{
+			std::lock_guard<std::mutex> lock(mutex);
+			if (--layers[layer].loading > 0)
+				return;
+		}
+		streamer->enqueueLayer(texture, static_cast<GLint>(layer), prepareLayer(layer, nullptr), images[index].path);
+	}
+
+	// the full mip chain of a layer, as RGBA8 or compressed. Shared layers
+	// are put together level by level from the mips of their images; the
+	// levels past paddedLevels, which none of the images is sampled from,
+	// are filtered from the last of those. Frees the layer's images.
+	CompressedImage prepareLayer(unsigned int layerIndex, JobPool* pool)
+	{
+		const Layer& layer = layers[layerIndex];
+		std::vector<MipLevel> chain = emptyChain(layerSize);
+		for (unsigned int index : layer.images)
+		{
+			Image& image = images[index];
+			MipOptions options;
+			if (isAlphaCutout(image.rgba.data(), image.width, image.height, 4))
+				options.alphaCutoff = 0.5f;
+			const std::uint8_t* pixels = image.rgba.data();
+			MipLevel scaled;
+			if (image.scaledWidth != image.width || image.scaledHeight != image.height)
+			{
+				scaled = resizeImage(pixels, image.width, image.height, 4, image.scaledWidth, image.scaledHeight, MipOptions(), pool);
+				pixels = scaled.pixels.data();
+			}
+			std::vector<std::uint8_t> rect = padRect(pixels, image.scaledWidth, image.scaledHeight, image.shared ? padding : 0,
+				image.rectWidth, image.rectHeight);
+			std::vector<MipLevel> mips = generateMips(rect.data(), image.rectWidth, image.rectHeight, 4, options, pool);
+			size_t last = image.shared ? std::min(mips.size() - 1, static_cast<size_t>(paddedLevels)) : mips.size() - 1;
+			for (size_t level = 0; level <= last; level++)
+				place(chain[level], mips[level], image.x >> level, image.y >> level);
+			std::vector<std::uint8_t>().swap(image.rgba);
+		}
+		if (layer.shared)
+			fillLevels(chain, paddedLevels, pool);
+		return compressLevels(chain, 4, compression, pool);
+	}
+
+	// level previewLevel and the smaller ones of a layer, from the preview
+	// of each of its images (see loadPreview); images without one stay
+	// black until the layer is in. The GL thread, while nothing streams.
+	void uploadPreview(unsigned int layerIndex, JobPool& pool)
+	{
+		const Layer& layer = layers[layerIndex];
+		std::vector<MipLevel> chain = emptyChain(layerSize >> previewLevel);
+		for (unsigned int index : layer.images)
+		{
+			const Image& image = images[index];
+			int width = std::max(1, (image.scaledWidth + (1 << previewLevel) / 2) >> previewLevel);
+			int height = std::max(1, (image.scaledHeight + (1 << previewLevel) / 2) >> previewLevel);
+			int previewWidth = 0, previewHeight = 0;
+			std::vector<std::uint8_t> preview = loadPreview(image, width, previewWidth, previewHeight);
+			if (preview.empty())
+				continue;
+			if (previewWidth != width || previewHeight != height)
+				preview = resizeImage(preview.data(), previewWidth, previewHeight, 4, width, height, MipOptions()).pixels;
+			int border = image.shared ? padding >> previewLevel : 0;
+			MipLevel rect{ image.rectWidth >> previewLevel, image.rectHeight >> previewLevel,
+				padRect(preview.data(), width, height, border, image.rectWidth >> previewLevel, image.rectHeight >> previewLevel) };
+			place(chain[0], rect, image.x >> previewLevel, image.y >> previewLevel);
+		}
+		fillLevels(chain, 0, &pool);
+		upload(layerIndex, previewLevel, compressLevels(chain, 4, compression, &pool));
+	}
+	// the GL thread: level 0 of image goes to level firstLevel of the layer
+	void upload(unsigned int layer, int firstLevel, const CompressedImage& image)
+	{
+		glState().bindTexture(0, GL_TEXTURE_2D_ARRAY, texture);
+		glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+		for (size_t level = 0; level < image.levels.size(); level++)
+		{
+			const CompressedImage::Level& mip = image.levels[level];
+			GLint target = firstLevel + static_cast<GLint>(level);
+			if (compression != COMPRESSION_NONE)
+				glCompressedTexSubImage3D(GL_TEXTURE_2D_ARRAY, target, 0, 0, layer, mip.width, mip.height, 1, format(),
+					static_cast<GLsizei>(mip.size), &image.data[mip.offset]);
+			else
+				glTexSubImage3D(GL_TEXTURE_2D_ARRAY, target, 0, 0, layer, mip.width, mip.height, 1, GL_RGBA, GL_UNSIGNED_BYTE,
+					&image.data[mip.offset]);
+		}
+		glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+	}
+
+	// a small version of the image, about width texels wide: the pixels
+	// when they are loaded already, the first mip of its cooked file at
+	// least that wide, or the DC image of a progressive JPEG; empty when
+	// there is none of those
+	static std::vector<std::uint8_t> loadPreview(const Image& image, int width, int& previewWidth, int& previewHeight)
+	{
+		if (!image.rgba.empty())
+		{
+			previewWidth = image.width;
+			previewHeight = image.height;
+			return image.rgba;
+		}
+		if (image.cooked)
+		{
+			CookedTexture cooked;
+			if (!cooked.open(cookedPath(image.path)) || cooked.target() != GL_TEXTURE_2D)
+				return std::vector<std::uint8_t>();
+			unsigned int level = cooked.levels() - 1;
+			while (level > 0 && cooked.width(level) < width)
+				level--;
+			previewWidth = cooked.width(level);
+			previewHeight = cooked.height(level);
+			return levelRGBA(cooked, level);
+		}
+		DecodedImage preview = AssetLoader::decodePreview(image.path, true);
+		std::vector<std::uint8_t> rgba;
+		if (preview.pixels)
+		{
+			rgba = expandToRGBA(preview);
+			previewWidth = preview.width;
+			previewHeight = preview.height;
+		}
+		preview.release();
+		return rgba;
+	}
+	// one level of a cooked 2D texture as RGBA8
+	static std::vector<std::uint8_t> levelRGBA(const CookedTexture& cooked, unsigned int level)
+	{
+		int width = cooked.width(level), height = cooked.height(level);
+		if (cooked.compression() == COMPRESSION_NONE)
+			return expandToRGBA(cooked.data(level), width, height, cooked.channels());
+		std::vector<std::uint8_t> rgba(static_cast<size_t>(width) * height * 4);
+		decodeImage(cooked.data(level), width, height, cooked.compression(), rgba.data());
+		return rgba;
+	}
+	// magenta and black squares of 8 texels
+	static std::vector<std::uint8_t> checkerboard(int width, int height)
+	{
+		std::vector<std::uint8_t> rgba(static_cast<size_t>(width) * height * 4);
+		for (int y = 0; y < height; y++)
+		{
+			for (int x = 0; x < width; x++)
+			{
+				std::uint8_t value = ((x / 8 + y / 8) % 2) ? 255 : 0;
+				std::uint8_t* texel = &rgba[(static_cast<size_t>(y) * width + x) * 4];
+				texel[0] = texel[2] = value;
+				texel[1] = 0;
+				texel[3] = 255;
+			}
+		}
+		return rgba;
+	}
+
+	// transparent black levels from size x size down to 1x1
+	static std::vector<MipLevel> emptyChain(int size)
+	{
+		std::vector<MipLevel> chain;
+		for (; size >= 1; size /= 2)
+			chain.push_back(MipLevel{ size, size, std::vector<std::uint8_t>(static_cast<size_t>(size) * size * 4, 0) });
+		return chain;
+	}
+	// replaces the levels after chain[level] with mips filtered from it
+	static void fillLevels(std::vector<MipLevel>& chain, int level, JobPool* pool)
+	{
+		size_t first = static_cast<size_t>(level);
+		if (first + 1 >= chain.size())
+			return;
+		std::vector<MipLevel> rest = generateMips(chain[first].pixels.data(), chain[first].width, chain[first].height, 4, MipOptions(), pool);
+		for (size_t next = 1; next < rest.size(); next++)
+			chain[first + next] = std::move(rest[next]);
+	}
+	// copies an RGBA level to x, y of a larger one
+	static void place(MipLevel& target, const MipLevel& source, int x, int y)
+	{
+		for (int row = 0; row < source.height; row++)
+			std::memcpy(&target.pixels[((static_cast<size_t>(y) + row) * target.width + x) * 4],
+				&source.pixels[static_cast<size_t>(row) * source.width * 4], static_cast<size_t>(source.width) * 4);
+	}
+	// an RGBA image border texels in from the corner of a rectWidth x
+	// rectHeight rect, with its edge texels repeated out to the rect's edges
+	static std::vector<std::uint8_t> padRect(const std::uint8_t* pixels, int width, int height, int border, int rectWidth, int rectHeight)
+	{
+		std::vector<std::uint8_t> rect(static_cast<size_t>(rectWidth) * rectHeight * 4);
+		int right = std::min(width, rectWidth - border);
+		for (int row = 0; row < rectHeight; row++)
+		{
+			int sourceRow = std::min(std::max(row - border, 0), height - 1);
+			const std::uint8_t* source = pixels + static_cast<size_t>(sourceRow) * width * 4;
+			std::uint8_t* target = &rect[static_cast<size_t>(row) * rectWidth * 4];
+			for (int column = 0; column < border; column++)
+				std::memcpy(target + column * 4, source, 4);
+			std::memcpy(target + border * 4, source, static_cast<size_t>(right) * 4);
+			for (int column = border + right; column < rectWidth; column++)
+				std::memcpy(target + column * 4, source + (right - 1) * 4, 4);
+		}
+		return rect;
+	}
+};
+#endif
@@ -0,0 +1,394 @@
+#ifndef TEXTURE_STREAM_H
+#define TEXTURE_STREAM_H
+
+#include <glad/glad.h>
+
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <cstring>
+#include <deque>
+#include <iostream>
+#include <mutex>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "assetloader.h"
+#include "bcencoder.h"
+#include "glstate.h"
+
+// client format for a decoded channel count
+// ------------------------------------------------------------------------
+inline GLenum pixelFormat(int channels)
+{
+	switch (channels)
+	{
+	case 1:
+		return GL_RED;
+	case 2:
+		return GL_RG;
+	case 3:
+		return GL_RGB;
+	default:
+		return GL_RGBA;
+	}
+}
+
+// sized internal format for a decoded channel count
+// ------------------------------------------------------------------------
+inline GLenum internalFormat(int channels)
+{
+	switch (channels)
+	{
+	case 1:
+		return GL_R8;
+	case 2:
+		return GL_RG8;
+	case 3:
+		return GL_RGB8;
+	default:
+		return GL_RGBA8;
+	}
+}
+
+// uploads decoded images to textures through a ring of persistently mapped
+// GL_PIXEL_UNPACK_BUFFER storage.
+//
+// Worker threads copy pixels into the ring with enqueue(), blocking only
+// while it is full. The render thread calls update() once per frame, which
+// issues glTexSubImage2D (glCompressedTexSubImage2D for block-compressed
+// images, the 3D forms for array layers) from the ring for at most frameBudget bytes (big images are split
+// by rows across frames) and fences what it issued. Ring space is reused
+// once its fence has signaled; update() never waits on one.
+// ------------------------------------------------------------------------
+class TextureStreamer
+{
+public:
+	static const size_t DEFAULT_CAPACITY = 64u << 20;
+	static const size_t DEFAULT_FRAME_BUDGET = 4u << 20;
+
+	unsigned int PBO = 0;
+
+	// ------------------------------------------------------------------------
+	void init(size_t capacityBytes = DEFAULT_CAPACITY, size_t frameBudgetBytes = DEFAULT_FRAME_BUDGET)
+	{
+		capacity = capacityBytes;
+		frameBudget = frameBudgetBytes;
+
+		GLbitfield flags = GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+		glGenBuffers(1, &PBO);
+		glBindBuffer(GL_PIXEL_UNPACK_BUFFER, PBO);
+		glBufferStorage(GL_PIXEL_UNPACK_BUFFER, capacity, nullptr, flags);
+		mapped = static_cast<unsigned char*>(glMapBufferRange(GL_PIXEL_UNPACK_BUFFER, 0, capacity, flags));
+		// a bound unpack buffer turns every client-memory upload into an offset
+		glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+	}
+	// ------------------------------------------------------------------------
+	void setFrameBudget(size_t bytes)
+	{
+		frameBudget = bytes;
+	}
+	// worker threads: copies level 0 of image into the ring and queues its
+	// upload to texture. The texture gets immutable storage, with a full mip
+	// chain when mipmaps is set. A failed decode is queued too, so the
+	// render thread still hears about it.
+	// ------------------------------------------------------------------------
+	void enqueue(GLuint texture, const DecodedImage& image, bool mipmaps)
+	{
+		Upload upload;
+		upload.texture = texture;
+		upload.mipmaps = mipmaps;
+		if (image.pixels)
+		{
+			upload.channels = image.channels;
+			size_t size = static_cast<size_t>(image.width) * image.height * image.channels;
+			upload.levels.push_back(CompressedImage::Level{ image.width, image.height, 0, size });
+			upload.size = size;
+		}
+		queue(upload, image.pixels, image.path);
+	}
+	// worker threads: the same for a prepared mip chain, every level of which
+	// is copied and uploaded as is
+	// ------------------------------------------------------------------------
+	void enqueue(GLuint texture, const CompressedImage& image, const std::string& path)
+	{
+		enqueue(texture, image.compression, image.channels, image.levels, image.data.data(), path);
+	}
+	// ------------------------------------------------------------------------
+	void enqueue(GLuint texture, TextureCompression compression, int channels, const std::vector<CompressedImage::Level>& levels,
+		const unsigned char* data, const std::string& path)
+	{
+		Upload upload;
+		upload.texture = texture;
+		upload.compression = compression;
+		upload.channels = channels;
+		upload.levels = levels;
+		upload.size = levels.empty() ? 0 : levels.back().offset + levels.back().size;
+		queue(upload, data, path);
+	}
+	// worker threads: a prepared mip chain for one layer of a
+	// GL_TEXTURE_2D_ARRAY, which must already have storage for all of it
+	// ------------------------------------------------------------------------
+	void enqueueLayer(GLuint texture, GLint layer, const CompressedImage& image, const std::string& path)
+	{
+		Upload upload;
+		upload.texture = texture;
+		upload.layer = layer;
+		upload.compression = image.compression;
+		upload.channels = image.channels;
+		upload.levels = image.levels;
+		upload.size = image.data.size();
+		queue(upload, image.data.data(), path);
+	}
+	// render thread, once per frame. onComplete(texture, layer, bytes) runs
+	// for each texture, or array layer, whose last rows were issued; layer
+	// is -1 for a 2D texture, and bytes the size in video memory, mip levels
+	// included, and 0 for a failed decode.
+	// ------------------------------------------------------------------------
+	template <typename Callback>
+	void update(Callback&& onComplete)
+	{
+		reclaim(false);
+		issue(frameBudget, onComplete);
+	}
+	// issues everything queued regardless of the budget and waits until the
+	// uploads of count more textures or layers have been issued
+	// ------------------------------------------------------------------------
+	template <typename Callback>
+	void finish(unsigned int count, Callback&& onComplete)
+	{
+		unsigned int completed = 0;
+		auto counting = [&](GLuint texture, GLint layer, size_t bytes)
+		{
+			completed++;
+			onComplete(texture, layer, bytes);
+		};
+		while (completed < count)
+		{
+			// waiting for the GPU frees ring space for blocked workers
+			reclaim(true);
+			if (issue(SIZE_MAX, counting) == 0 && completed < count)
+			{
+				std::unique_lock<std::mutex> lock(mutex);
+				uploadReady.wait_for(lock, std::chrono::milliseconds(1), [this]
+				{
+					return !uploads.empty() && uploads.front().copied;
+				});
+			}
+		}
+	}
+	// ------------------------------------------------------------------------
+	void release()
+	{
+		for (Fence& fence : fences)
+			glDeleteSync(fence.sync);
+		fences.clear();
+		glBindBuffer(GL_PIXEL_UNPACK_BUFFER, PBO);
+		glUnmapBuffer(GL_PIXEL_UNPACK_BUFFER);
+		glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+		glDeleteBuffers(1, &PBO);
+		mapped = nullptr;
+	}
+
+private:
+	struct Upload
+	{
+		GLuint texture = 0;
+		// the array layer to fill, or -1 for a 2D texture this upload creates
+		GLint layer = -1;
+		int channels = 0;
+		TextureCompression compression = COMPRESSION_NONE;
+		// generate the mip chain after level 0 (single-level uploads only)
+		bool mipmaps = false;
+		// level offsets are relative to offset
+		std::vector<CompressedImage::Level> levels;
+		size_t offset = 0;
+		size_t size = 0;
+		// ring position just past this upload's region
+		std::uint64_t end = 0;
+		size_t level = 0;
+		// rows of texels, or of blocks when compressed
+		int rowsDone = 0;
+		bool copied = false;
+	};
+	struct Fence
+	{
+		GLsync sync;
+		std::uint64_t releaseTo;
+	};
+
+	unsigned char* mapped = nullptr;
+	size_t capacity = 0;
+	size_t frameBudget = DEFAULT_FRAME_BUDGET;
+
+	std::mutex mutex;
+	std::condition_variable spaceFreed;
+	std::condition_variable uploadReady;
+	// monotonic ring positions; [tail, head) is in use
+	std::uint64_t head = 0;
+	std::uint64_t tail = 0;
+	// deque so pointers to queued uploads stay valid while workers copy
+	std::deque<Upload> uploads;
+	// render thread only
+	std::deque<Fence> fences;
+
+	// takes ring space for upload, copies size bytes of source into it and
+	// hands it to the render thread
+	void queue(Upload& upload, const unsigned char* source, const std::string& path)
+	{
+		if (upload.size > capacity)
+		{
+			std::cout << "Texture does not fit the streaming buffer: " << path << std::endl;
+			upload.levels.clear();
+			upload.size = 0;
+		}
+
+		Upload* queued;
+		{
+			std::unique_lock<std::mutex> lock(mutex);
+			size_t padding = 0;
+			spaceFreed.wait(lock, [&]
+			{
+				// an empty ring restarts at offset 0
+				if (head == tail)
+					head = tail = (head + capacity - 1) / capacity * capacity;
+				// regions never wrap; skip the end of the ring when it is too short
+				size_t offset = head % capacity;
+				padding = offset + upload.size > capacity ? capacity - offset : 0;
+				return head + padding + upload.size - tail <= capacity;
+			});
+			head += padding;
+			upload.offset = head % capacity;
+			head += upload.size;
+			upload.end = head;
+			// queued before the copy so uploads leave the ring in the order
+			// their space was taken; the render thread stops at the first
+			// one still being copied
+			uploads.push_back(std::move(upload));
+			queued = &uploads.back();
+		}
+		if (queued->size)
+			std::memcpy(mapped + queued->offset, source, queued->size);
+		{
+			std::lock_guard<std::mutex> lock(mutex);
+			queued->copied = true;
+		}
+		uploadReady.notify_one();
+	}
+
+	// hands ring space back once the GPU has consumed it
+	void reclaim(bool wait)
+	{
+		std::uint64_t releaseTo = 0;
+		while (!fences.empty())
+		{
+			Fence& fence = fences.front();
+			GLenum status = glClientWaitSync(fence.sync, GL_SYNC_FLUSH_COMMANDS_BIT, wait ? GL_TIMEOUT_IGNORED : 0);
+			if (status != GL_ALREADY_SIGNALED && status != GL_CONDITION_SATISFIED)
+				break;
+			releaseTo = fence.releaseTo;
+			glDeleteSync(fence.sync);
+			fences.pop_front();
+		}
+		if (releaseTo)
+		{
+			{
+				std::lock_guard<std::mutex> lock(mutex);
+				tail = std::max(tail, releaseTo);
+			}
+			spaceFreed.notify_all();
+		}
+	}
+
+	// issues up to budget bytes of queued rows; returns the bytes issued
+	template <typename Callback>
+	size_t issue(size_t budget, Callback& onComplete)
+	{
+		size_t issued = 0;
+		std::uint64_t releaseTo = 0;
+		bool bound = false;
+		while (issued < budget)
+		{
+			Upload* upload;
+			{
+				std::lock_guard<std::mutex> lock(mutex);
+				if (uploads.empty() || !uploads.front().copied)
+					break;
+				upload = &uploads.front();
+			}
+			if (upload->size)
+			{
+				if (!bound)
+				{
+					glBindBuffer(GL_PIXEL_UNPACK_BUFFER, PBO);
+					glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+					bound = true;
+				}
+				GLenum target = upload->layer < 0 ? GL_TEXTURE_2D : GL_TEXTURE_2D_ARRAY;
+				glState().bindTexture(0, target, upload->texture);
+				const CompressedImage::Level& level = upload->levels[upload->level];
+				bool compressed = upload->compression != COMPRESSION_NONE;
+				if (upload->layer < 0 && upload->level == 0 && upload->rowsDone == 0)
+				{
+					GLsizei levels = static_cast<GLsizei>(upload->levels.size());
+					if (upload->mipmaps)
+					{
+						for (int size = std::max(level.width, level.height); size > 1; size /= 2)
+							levels++;
+					}
+					glTexStorage2D(GL_TEXTURE_2D, levels, compressed ? compressedFormat(upload->compression) : internalFormat(upload->channels),
+						level.width, level.height);
+				}
+				// at least one row per call so a tiny budget still makes progress
+				int rowHeight = compressed ? 4 : 1;
+				int rowCount = (level.height + rowHeight - 1) / rowHeight;
+				size_t rowBytes = level.size / rowCount;
+				size_t rowsLeft = static_cast<size_t>(rowCount - upload->rowsDone);
+				int rows = static_cast<int>(std::min(rowsLeft, std::max<size_t>(1, (budget - issued) / rowBytes)));
+				int y = upload->rowsDone * rowHeight;
+				int height = std::min(rows * rowHeight, level.height - y);
+				void* source = (void*)(upload->offset + level.offset + upload->rowsDone * rowBytes);
+				GLint mip = static_cast<GLint>(upload->level);
+				GLsizei size = static_cast<GLsizei>(rows * rowBytes);
+				if (target == GL_TEXTURE_2D_ARRAY && compressed)
+					glCompressedTexSubImage3D(target, mip, 0, y, upload->layer, level.width, height, 1, compressedFormat(upload->compression), size, source);
+				else if (target == GL_TEXTURE_2D_ARRAY)
+					glTexSubImage3D(target, mip, 0, y, upload->layer, level.width, height, 1, pixelFormat(upload->channels), GL_UNSIGNED_BYTE, source);
+				else if (compressed)
+					glCompressedTexSubImage2D(target, mip, 0, y, level.width, height, compressedFormat(upload->compression), size, source);
+				else
+					glTexSubImage2D(target, mip, 0, y, level.width, height, pixelFormat(upload->channels), GL_UNSIGNED_BYTE, source);
+				upload->rowsDone += rows;
+				issued += rows * rowBytes;
+				if (upload->rowsDone < rowCount)
+					continue;
+				upload->rowsDone = 0;
+				if (++upload->level < upload->levels.size())
+					continue;
+				if (upload->mipmaps)
+					glGenerateMipmap(GL_TEXTURE_2D);
+			}
+
+			GLuint texture = upload->texture;
+			GLint layer = upload->layer;
+			size_t bytes = upload->mipmaps ? upload->size + upload->size / 3 : upload->size;
+			releaseTo = upload->end;
+			{
+				std::lock_guard<std::mutex> lock(mutex);
+				uploads.pop_front();
+			}
+			onComplete(texture, layer, bytes);
+		}
+		if (bound)
+		{
+			glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+			glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+		}
+		if (releaseTo)
+			fences.push_back(Fence{ glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0), releaseTo });
+		return issued;
+	}
+};
+#endif